@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <entities/entity.h>
+#include <entities/components.h>
+#include <collisions/collider.h>
+
+static void BM_SphereOverlaps(benchmark::State& state) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>(glm::fvec3(0.0f, 0.0f, 0.0f));
+    const SphereCollider* collider = entity.addComponentAndGetRawPtr<SphereCollider>(2.0f);
+    glm::fvec3 point(1.0f, 1.0f, 1.0f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(point);
+        benchmark::DoNotOptimize(collider->overlaps(&point));
+    }
+}
+BENCHMARK(BM_SphereOverlaps);
+
+static void BM_BoxOverlaps(benchmark::State& state) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>(glm::fvec3(0.0f, 0.0f, 0.0f));
+    const BoxCollider* collider = entity.addComponentAndGetRawPtr<BoxCollider>(glm::fvec3(1.0f, 1.0f, 1.0f));
+    glm::fvec3 point(0.5f, 2.0f, 0.5f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(point);
+        benchmark::DoNotOptimize(collider->overlaps(&point));
+    }
+}
+BENCHMARK(BM_BoxOverlaps);
+
+/** Every collider against one point, through the ICollider interface as a broad phase would */
+static void BM_OverlapsAcrossColliders(benchmark::State& state) {
+    std::vector<std::unique_ptr<IEntity>> entities;
+    std::vector<const ICollider*> colliders;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        entities.push_back(std::make_unique<IEntity>());
+        entities.back()->addComponent<TransformComponent>(glm::fvec3(float(i % 100), float(i / 100), 0.0f));
+        if (i % 2 == 0) {
+            colliders.push_back(entities.back()->addComponentAndGetRawPtr<SphereCollider>(0.5f));
+        } else {
+            colliders.push_back(entities.back()->addComponentAndGetRawPtr<BoxCollider>(glm::fvec3(0.5f)));
+        }
+    }
+    glm::fvec3 point(50.0f, 50.0f, 0.0f);
+    for (auto _ : state) {
+        int hits = 0;
+        for (const ICollider* collider : colliders) {
+            hits += collider->overlaps(&point);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OverlapsAcrossColliders)->Arg(100)->Arg(1000)->Arg(10000);
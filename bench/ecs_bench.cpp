@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <memory>
+
+#include <entities/entity.h>
+#include <entities/components.h>
+#include <collisions/collider.h>
+#include <scene/prefab.h>
+
+static void BM_AddComponent(benchmark::State& state) {
+    for (auto _ : state) {
+        IEntity entity;
+        entity.addComponent<TransformComponent>(glm::fvec3(1.0f, 2.0f, 3.0f));
+        benchmark::DoNotOptimize(entity);
+    }
+}
+BENCHMARK(BM_AddComponent);
+
+static void BM_GetComponent(benchmark::State& state) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>();
+    entity.addComponent<HealthComponent>(10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(entity.getComponent<HealthComponent>());
+    }
+}
+BENCHMARK(BM_GetComponent);
+
+static void BM_GetMissingComponent(benchmark::State& state) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(entity.getComponent<HealthComponent>());
+    }
+}
+BENCHMARK(BM_GetMissingComponent);
+
+static void BM_AddRemoveComponent(benchmark::State& state) {
+    IEntity entity;
+    for (auto _ : state) {
+        entity.addComponent<HealthComponent>(10);
+        benchmark::DoNotOptimize(entity.removeComponent<HealthComponent>());
+    }
+}
+BENCHMARK(BM_AddRemoveComponent);
+
+static void BM_ForEachComponent(benchmark::State& state) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>();
+    entity.addComponent<HealthComponent>(10);
+    entity.addComponent<ContinuousForceComponent>(glm::fvec3(0.0f, 1.0f, 0.0f), 1.0f);
+    entity.addComponent<SphereCollider>(1.0f);
+    for (auto _ : state) {
+        int tickables = 0;
+        entity.forEachComponent<ITickable>([&](ITickable*) { tickables++; });
+        benchmark::DoNotOptimize(tickables);
+    }
+}
+BENCHMARK(BM_ForEachComponent);
+
+/** Same lookup over many entities, where cache misses rather than the hash dominate */
+static void BM_GetComponentAcrossEntities(benchmark::State& state) {
+    std::vector<std::unique_ptr<IEntity>> entities;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        entities.push_back(std::make_unique<IEntity>());
+        entities.back()->addComponent<TransformComponent>(glm::fvec3(float(i), 0.0f, 0.0f));
+    }
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (const auto& entity : entities) {
+            sum += entity->getComponent<TransformComponent>()->position.x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetComponentAcrossEntities)->Arg(100)->Arg(1000)->Arg(10000);
+
+/** Baseline for BM_InstantiatePrefab, the same entities one allocation per entity, component and map node */
+static void BM_CreateEntities(benchmark::State& state) {
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<IGameplayEntity>> entities;
+        entities.reserve(state.range(0));
+        for (int64_t i = 0; i < state.range(0); i++) {
+            entities.push_back(std::make_unique<IGameplayEntity>());
+            entities.back()->addComponent<TransformComponent>();
+            entities.back()->addComponent<HealthComponent>(10);
+            entities.back()->addComponent<SphereCollider>(1.0f);
+        }
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CreateEntities)->Arg(1000)->Arg(10000);
+
+static void BM_InstantiatePrefab(benchmark::State& state) {
+    Prefab prefab;
+    prefab.with<TransformComponent>().with<HealthComponent>(10).with<SphereCollider>(1.0f);
+    for (auto _ : state) {
+        PrefabInstances instances = prefab.instantiate(state.range(0));
+        benchmark::DoNotOptimize(instances.entities().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InstantiatePrefab)->Arg(1000)->Arg(10000);
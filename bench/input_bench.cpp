@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include <input/input.h>
+
+static void BM_InputIsDown(benchmark::State& state) {
+    InputManager input;
+    input.queueEvent(InputEvent{InputEventType::KeyDown, 0, SDL_SCANCODE_W, 0, glm::vec2(0.0f), 0});
+    input.onTickRisingEdge();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input.isDown(SDL_SCANCODE_W));
+        benchmark::DoNotOptimize(input.isDown(SDL_SCANCODE_S));
+    }
+}
+BENCHMARK(BM_InputIsDown);
+
+static void BM_InputSnapshotIsDown(benchmark::State& state) {
+    InputManager input;
+    input.queueEvent(InputEvent{InputEventType::KeyDown, 0, SDL_SCANCODE_W, 0, glm::vec2(0.0f), 0});
+    input.onTickRisingEdge();
+    const InputSnapshot& snapshot = input.snapshot();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.isDown(SDL_SCANCODE_W));
+        benchmark::DoNotOptimize(snapshot.isHeld(SDL_SCANCODE_S));
+    }
+}
+BENCHMARK(BM_InputSnapshotIsDown);
+
+/** A tick with the given number of events queued, half of them key presses */
+static void BM_InputTickRisingEdge(benchmark::State& state) {
+    InputManager input;
+    input.setClock([] { return ms(0); });
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int64_t i = 0; i < state.range(0); i++) {
+            SDL_Scancode code = static_cast<SDL_Scancode>(SDL_SCANCODE_A + (i / 2) % 26);
+            InputEventType type = i % 2 == 0 ? InputEventType::KeyDown : InputEventType::KeyUp;
+            input.queueEvent(InputEvent{type, 0, code, 0, glm::vec2(0.0f), 0});
+        }
+        state.ResumeTiming();
+        input.onTickRisingEdge();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InputTickRisingEdge)->Arg(0)->Arg(16)->Arg(256);
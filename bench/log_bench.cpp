@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include <string_view>
+
+#include <meta/log.h>
+
+/** What the logging thread pays, the writer formats into a sink that discards everything */
+static void BM_LogInfo(benchmark::State& state) {
+    Log::start([](LogLevel, std::string_view message) { benchmark::DoNotOptimize(message.data()); });
+    int frame = 0;
+    for (auto _ : state) {
+        Log::info("Frame {} took {:.2f}ms in {}", frame++, 16.6, "draw");
+    }
+    Log::stop();
+}
+BENCHMARK(BM_LogInfo);
+
+/** An error firing every frame, past its rate limit */
+static void BM_LogRateLimited(benchmark::State& state) {
+    Log::start([](LogLevel, std::string_view message) { benchmark::DoNotOptimize(message.data()); });
+    for (auto _ : state) {
+        Log::error("Could not draw: {}", "renderer lost");
+    }
+    Log::stop();
+}
+BENCHMARK(BM_LogRateLimited);
@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include <navigation/navGrid.h>
+
+/** 256x256 with walls every 16 columns, each open at alternating ends, so paths snake across the map */
+static NavGrid mazeGrid() {
+    NavGrid grid(256, 256, 1.0f);
+    for (int x = 16; x < 256; x += 16) {
+        bool openAtTop = (x / 16) % 2 == 0;
+        for (int y = 0; y < 256; y++) {
+            if (openAtTop ? y > 3 : y < 252) {
+                grid.setBlocked(x, y, true);
+            }
+        }
+    }
+    grid.takeChanges();
+    return grid;
+}
+
+/** Arg is the number of agents chasing the same goal, each searching its own path */
+static void BM_AStarPerAgent(benchmark::State& state) {
+    NavGrid grid = mazeGrid();
+    PathSearch search;
+    for (auto _ : state) {
+        for (int agent = 0; agent < state.range(0); agent++) {
+            benchmark::DoNotOptimize(search.find(grid, glm::ivec2(agent % 16, agent % 256), glm::ivec2(250, 128)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AStarPerAgent)->Arg(1)->Arg(100);
+
+/** The same agents sharing one flow field, looking up their direction */
+static void BM_FlowFieldShared(benchmark::State& state) {
+    NavGrid grid = mazeGrid();
+    for (auto _ : state) {
+        FlowField field(grid, glm::ivec2(250, 128));
+        for (int agent = 0; agent < state.range(0); agent++) {
+            benchmark::DoNotOptimize(field.direction(glm::ivec2(agent % 16, agent % 256)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlowFieldShared)->Arg(1)->Arg(100);
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <entities/entity.h>
+#include <entities/particles.h>
+
+/** Steady state: as many spawn as die each update. Arg 1 is the number of workers */
+static void BM_ParticleUpdate(benchmark::State& state) {
+    ParticleEmitterConfig config;
+    config.capacity = static_cast<size_t>(state.range(0));
+    config.lifetime = 60.0f;
+    config.rate = static_cast<float>(config.capacity) / config.lifetime;
+    config.gravity = glm::fvec2(0.0f, 0.1f);
+    config.workers = static_cast<unsigned>(state.range(1));
+
+    IEntity entity;
+    entity.addComponent<TransformComponent>();
+    ParticleEmitter* emitter = entity.addComponentAndGetRawPtr<ParticleEmitter>(config);
+    emitter->burst(config.capacity);
+    for (auto _ : state) {
+        emitter->update(1.0f);
+        benchmark::DoNotOptimize(emitter->alive());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParticleUpdate)->Args({100000, 1})->Args({1000000, 1})->Args({1000000, 4})->UseRealTime();
+
+static void BM_ParticleCapture(benchmark::State& state) {
+    ParticleEmitterConfig config;
+    config.capacity = static_cast<size_t>(state.range(0));
+    IEntity entity;
+    entity.addComponent<TransformComponent>();
+    ParticleEmitter* emitter = entity.addComponentAndGetRawPtr<ParticleEmitter>(config);
+    emitter->burst(config.capacity);
+
+    std::vector<float> xy;
+    std::vector<SDL_FColor> colours;
+    for (auto _ : state) {
+        xy.clear();
+        colours.clear();
+        emitter->appendTriangles(xy, colours);
+        benchmark::DoNotOptimize(xy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParticleCapture)->Arg(100000)->Arg(1000000);
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <memory>
+
+#include <scene/scene.h>
+
+/** Register the given number of entities, destroy them all, and dispatch the resulting events */
+static void BM_SceneRegisterDestroy(benchmark::State& state) {
+    std::vector<std::unique_ptr<IGameplayEntity>> entities;
+    entities.reserve(state.range(0));
+    for (auto _ : state) {
+        SceneContext scene;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            entities.push_back(std::make_unique<IGameplayEntity>());
+            scene.registerEntity(entities.back().get());
+        }
+        entities.clear();
+        scene.events().dispatch();
+        benchmark::DoNotOptimize(scene.getEntities().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneRegisterDestroy)->Arg(100)->Arg(1000)->Arg(10000);
+
+/** Destroy a tenth of the entities of a scene, the rest stays registered */
+static void BM_SceneDestroySome(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        SceneContext scene;
+        std::vector<std::unique_ptr<IGameplayEntity>> entities;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            entities.push_back(std::make_unique<IGameplayEntity>());
+            scene.registerEntity(entities.back().get());
+        }
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < entities.size(); i += 10) {
+            entities[i].reset();
+        }
+        scene.events().dispatch();
+        benchmark::DoNotOptimize(scene.getEntities().size());
+
+        state.PauseTiming();
+        entities.clear();
+        scene.events().dispatch();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 10);
+}
+BENCHMARK(BM_SceneDestroySome)->Arg(100)->Arg(1000)->Arg(10000);
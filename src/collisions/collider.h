@@ -3,6 +3,8 @@
 #include <entities/entity.h>
 #include <entities/components.h>
 #include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
 
 class ICollider : public IDependentEntityComponent {
 protected:
@@ -21,8 +23,10 @@ private:
 public:
     SphereCollider(ComponentRetriever compRet, float radius) : ICollider(compRet), m_radiusSQ(radius*radius) {}
 
+    float radius() const noexcept { return std::sqrt(m_radiusSQ); }
+
     bool overlaps(const glm::fvec3* pointB) const noexcept override {
-        glm::fvec3 pointA = m_transform->position;
+        glm::fvec3 pointA = m_transform->worldPosition();
         float deltaX = pointA.x - pointB->x;
         float deltaY = pointA.y - pointB->y;
         float deltaZ = pointA.z - pointB->z;
@@ -36,8 +40,10 @@ private:
 public:
     BoxCollider(ComponentRetriever compRet, glm::fvec3 size) : ICollider(compRet), m_size(size) {}
 
+    glm::fvec3 size() const noexcept { return m_size; }
+
     bool overlaps(const glm::fvec3* pointB) const noexcept override {
-        glm::fvec3 pointA = m_transform->position;
+        glm::fvec3 pointA = m_transform->worldPosition();
         return pointA.x - m_size.x <= pointB->x && pointA.x + m_size.x >= pointB->x &&
                pointA.y - m_size.y <= pointB->y && pointA.y + m_size.y >= pointB->y &&
                pointA.z - m_size.z <= pointB->z && pointA.z + m_size.z >= pointB->z;
@@ -50,8 +56,10 @@ private:
 public:
     PolygonCollider(ComponentRetriever compRet, std::vector<glm::fvec3> points) : ICollider(compRet), m_points(points) {}
 
+    const std::vector<glm::fvec3>& points() const noexcept { return m_points; }
+
     bool overlaps(const glm::fvec3* pointB) const noexcept override {
-        glm::fvec3 pointA = m_transform->position;
+        glm::fvec3 pointA = m_transform->worldPosition();
 
         //TODO: 3D raycasting algorithm
 
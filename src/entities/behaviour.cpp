@@ -0,0 +1,376 @@
+#include <entities/behaviour.h>
+
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+
+#include <input/input.h>
+
+namespace {
+    struct FreeFrame {
+        FreeFrame* next;
+    };
+
+    struct FramePoolState {
+        std::mutex mutex;
+        std::array<FreeFrame*, CoroutineFramePool::s_maxPooled / CoroutineFramePool::s_granularity> free = {};
+        std::vector<std::unique_ptr<std::byte[]>> slabs;
+        std::atomic<size_t> inUse = 0;
+    };
+
+    FramePoolState& framePool() {
+        static FramePoolState state;
+        return state;
+    }
+
+    size_t sizeClass(size_t size) noexcept {
+        return (size + CoroutineFramePool::s_granularity - 1) / CoroutineFramePool::s_granularity - 1;
+    }
+
+    template <typename Key>
+    void unlist(std::unordered_map<Key, std::vector<BehaviourId>>& waiters, Key key, BehaviourId id) noexcept {
+        auto it = waiters.find(key);
+        if (it == waiters.end()) {
+            return;
+        }
+        std::erase(it->second, id);
+        if (it->second.empty()) {
+            waiters.erase(it);
+        }
+    }
+}
+
+void* CoroutineFramePool::allocate(size_t size) {
+    if (size > s_maxPooled) {
+        return ::operator new(size);
+    }
+    FramePoolState& pool = framePool();
+    size_t index = sizeClass(size);
+    std::lock_guard lock(pool.mutex);
+    if (pool.free[index] == nullptr) {
+        // Thread a new slab onto the free list, frame by frame
+        size_t frameSize = (index + 1) * s_granularity;
+        pool.slabs.push_back(std::make_unique<std::byte[]>(frameSize * s_framesPerSlab));
+        std::byte* slab = pool.slabs.back().get();
+        for (size_t i = s_framesPerSlab; i-- > 0;) {
+            FreeFrame* frame = reinterpret_cast<FreeFrame*>(slab + i * frameSize);
+            frame->next = pool.free[index];
+            pool.free[index] = frame;
+        }
+    }
+    FreeFrame* frame = pool.free[index];
+    pool.free[index] = frame->next;
+    pool.inUse.fetch_add(1, std::memory_order_relaxed);
+    return frame;
+}
+
+void CoroutineFramePool::deallocate(void* frame, size_t size) noexcept {
+    if (size > s_maxPooled) {
+        ::operator delete(frame);
+        return;
+    }
+    FramePoolState& pool = framePool();
+    size_t index = sizeClass(size);
+    std::lock_guard lock(pool.mutex);
+    FreeFrame* freed = static_cast<FreeFrame*>(frame);
+    freed->next = pool.free[index];
+    pool.free[index] = freed;
+    pool.inUse.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t CoroutineFramePool::inUse() noexcept {
+    return framePool().inUse.load(std::memory_order_relaxed);
+}
+
+Behaviour& Behaviour::operator=(Behaviour&& other) noexcept {
+    if (this != &other) {
+        if (m_handle != nullptr) {
+            m_handle.destroy();
+        }
+        m_handle = other.m_handle;
+        other.m_handle = nullptr;
+    }
+    return *this;
+}
+
+Behaviour::~Behaviour() {
+    if (m_handle != nullptr) {
+        m_handle.destroy();
+    }
+}
+
+Behaviour::Handle Behaviour::release() noexcept {
+    Handle handle = m_handle;
+    m_handle = nullptr;
+    return handle;
+}
+
+BehaviourScheduler::BehaviourScheduler(EventBus* events) : m_events(events) {
+    if (m_events == nullptr) {
+        return;
+    }
+    m_subscription = m_events->subscribe<CollisionBegan>([this](std::span<const CollisionBegan> collisions) {
+        if (m_collisionWaiters.empty()) {
+            return;
+        }
+        for (const CollisionBegan& collision : collisions) {
+            for (long long entityId : {collision.entityA, collision.entityB}) {
+                auto it = m_collisionWaiters.find(entityId);
+                if (it == m_collisionWaiters.end()) {
+                    continue;
+                }
+                for (BehaviourId id : it->second) {
+                    if (Slot* slot = find(id)) {
+                        slot->handle.promise().collision = collision;
+                        m_collided.push_back(id);
+                    }
+                }
+                m_collisionWaiters.erase(it);
+            }
+        }
+    });
+}
+
+BehaviourScheduler::~BehaviourScheduler() {
+    clear();
+}
+
+BehaviourId BehaviourScheduler::start(Behaviour behaviour, long long entityId) {
+    Behaviour::Handle handle = behaviour.release();
+    if (handle == nullptr) {
+        throw std::runtime_error("Cannot start an empty behaviour");
+    }
+
+    uint32_t slot;
+    if (!m_free.empty()) {
+        slot = m_free.back();
+        m_free.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back(Slot{});
+    }
+    m_slots[slot].handle = handle;
+    Behaviour::promise_type& promise = handle.promise();
+    promise.scheduler = this;
+    promise.entityId = entityId;
+    promise.slot = slot;
+
+    BehaviourId id = idOf(slot);
+    if (std::exception_ptr error = resume(slot)) {
+        std::rethrow_exception(error);
+    }
+    return id;
+}
+
+void BehaviourScheduler::cancel(BehaviourId id) noexcept {
+    if (find(id) == nullptr) {
+        return;
+    }
+    uint32_t slot = static_cast<uint32_t>(id);
+    if (slot == m_current) {
+        // Destroying a running coroutine would pull the frame out from under it
+        m_cancelCurrent = true;
+        return;
+    }
+    destroy(slot);
+}
+
+bool BehaviourScheduler::isRunning(BehaviourId id) const noexcept {
+    uint32_t slot = static_cast<uint32_t>(id);
+    return slot < m_slots.size() && m_slots[slot].handle != nullptr && idOf(slot) == id;
+}
+
+void BehaviourScheduler::update(float deltaT, const InputSnapshot& input) {
+    m_time += deltaT;
+
+    // Collect everything due first, anything awaited while resuming waits for the next update
+    m_resuming.clear();
+    m_resuming.swap(m_nextTick);
+    while (!m_timers.empty() && m_timers.front().wakeAt <= m_time) {
+        std::pop_heap(m_timers.begin(), m_timers.end(), std::greater<Timer>());
+        if (Slot* slot = find(m_timers.back().id)) {
+            // Out of the heap, cancelling it before it resumes leaves nothing stale
+            slot->handle.promise().waiting = BehaviourWait::Nothing;
+            m_resuming.push_back(m_timers.back().id);
+        } else {
+            m_staleTimers--;
+        }
+        m_timers.pop_back();
+    }
+    for (auto it = m_keyWaiters.begin(); it != m_keyWaiters.end();) {
+        if (input.wasPressed(static_cast<SDL_Scancode>(it->first))) {
+            m_resuming.insert(m_resuming.end(), it->second.begin(), it->second.end());
+            it = m_keyWaiters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_resuming.insert(m_resuming.end(), m_collided.begin(), m_collided.end());
+    m_collided.clear();
+
+    std::exception_ptr firstError = nullptr;
+    m_resumed = 0;
+    // By index, resumed behaviours may start more, which never lands here
+    for (size_t i = 0; i < m_resuming.size(); i++) {
+        if (find(m_resuming[i]) == nullptr) {
+            continue;
+        }
+        m_resumed++;
+        std::exception_ptr error = resume(static_cast<uint32_t>(m_resuming[i]));
+        if (error != nullptr && firstError == nullptr) {
+            firstError = error;
+        }
+    }
+    if (firstError != nullptr) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+void BehaviourScheduler::clear() noexcept {
+    for (uint32_t slot = 0; slot < m_slots.size(); slot++) {
+        if (m_slots[slot].handle != nullptr) {
+            destroy(slot);
+        }
+    }
+    m_nextTick.clear();
+    m_timers.clear();
+    m_staleTimers = 0;
+    m_keyWaiters.clear();
+    m_collisionWaiters.clear();
+    m_collided.clear();
+    if (m_events != nullptr && m_subscription >= 0) {
+        m_events->unsubscribe(m_subscription);
+        m_subscription = -1;
+    }
+}
+
+size_t BehaviourScheduler::waitListSize() const noexcept {
+    size_t size = m_timers.size();
+    for (const auto& [code, waiters] : m_keyWaiters) {
+        size += waiters.size();
+    }
+    for (const auto& [entityId, waiters] : m_collisionWaiters) {
+        size += waiters.size();
+    }
+    return size;
+}
+
+void BehaviourScheduler::waitNextTick(uint32_t slot) {
+    m_nextTick.push_back(idOf(slot));
+    m_slots[slot].handle.promise().waiting = BehaviourWait::NextTick;
+}
+
+void BehaviourScheduler::waitDelay(uint32_t slot, float duration) {
+    m_timers.push_back(Timer{m_time + duration, idOf(slot)});
+    std::push_heap(m_timers.begin(), m_timers.end(), std::greater<Timer>());
+    m_slots[slot].handle.promise().waiting = BehaviourWait::Delay;
+}
+
+void BehaviourScheduler::waitKey(uint32_t slot, SDL_Scancode code) {
+    m_keyWaiters[static_cast<int>(code)].push_back(idOf(slot));
+    Behaviour::promise_type& promise = m_slots[slot].handle.promise();
+    promise.waiting = BehaviourWait::Key;
+    promise.waitingOn = code;
+}
+
+void BehaviourScheduler::waitCollision(uint32_t slot, long long entityId) {
+    if (m_events == nullptr || entityId < 0) {
+        throw std::runtime_error("collision() needs a scheduler with an EventBus, and a behaviour started for an entity");
+    }
+    m_collisionWaiters[entityId].push_back(idOf(slot));
+    Behaviour::promise_type& promise = m_slots[slot].handle.promise();
+    promise.waiting = BehaviourWait::Collision;
+    promise.waitingOn = entityId;
+}
+
+BehaviourScheduler::Slot* BehaviourScheduler::find(BehaviourId id) noexcept {
+    uint32_t slot = static_cast<uint32_t>(id);
+    if (slot >= m_slots.size() || m_slots[slot].handle == nullptr || idOf(slot) != id) {
+        return nullptr;
+    }
+    return &m_slots[slot];
+}
+
+std::exception_ptr BehaviourScheduler::resume(uint32_t slot) noexcept {
+    // Behaviours may start others, which are resumed right away
+    uint32_t previous = m_current;
+    bool previousCancel = m_cancelCurrent;
+    m_current = slot;
+    m_cancelCurrent = false;
+
+    Behaviour::Handle handle = m_slots[slot].handle;
+    handle.promise().waiting = BehaviourWait::Nothing;
+    handle.resume();
+
+    std::exception_ptr error = nullptr;
+    if (handle.done()) {
+        error = handle.promise().error;
+        destroy(slot);
+    } else if (m_cancelCurrent) {
+        destroy(slot);
+    }
+    m_current = previous;
+    m_cancelCurrent = previousCancel;
+    return error;
+}
+
+void BehaviourScheduler::destroy(uint32_t slot) noexcept {
+    Behaviour::Handle handle = m_slots[slot].handle;
+    // Take it off whatever it waits for, so cancelled waiters don't pile up. Next tick waiters are gone after one update
+    BehaviourId id = idOf(slot);
+    const Behaviour::promise_type& promise = handle.promise();
+    switch (promise.waiting) {
+    case BehaviourWait::Delay:
+        m_staleTimers++;
+        break;
+    case BehaviourWait::Key:
+        unlist(m_keyWaiters, static_cast<int>(promise.waitingOn), id);
+        break;
+    case BehaviourWait::Collision:
+        unlist(m_collisionWaiters, promise.waitingOn, id);
+        break;
+    default:
+        break;
+    }
+    m_slots[slot].handle = nullptr;
+    m_slots[slot].generation++;
+    m_free.push_back(slot);
+    // Removing a timer from the middle of the heap means rebuilding it, so that waits until half of it is stale
+    if (m_staleTimers > 0 && m_staleTimers * 2 >= m_timers.size()) {
+        std::erase_if(m_timers, [&](const Timer& timer) { return find(timer.id) == nullptr; });
+        std::make_heap(m_timers.begin(), m_timers.end(), std::greater<Timer>());
+        m_staleTimers = 0;
+    }
+    // Locals of the coroutine may cancel others, so the slot is released first
+    handle.destroy();
+}
+
+BehaviourComponent::~BehaviourComponent() {
+    if (std::shared_ptr<BehaviourScheduler> scheduler = m_scheduler.lock()) {
+        for (BehaviourId id : m_started) {
+            scheduler->cancel(id);
+        }
+    }
+}
+
+BehaviourId BehaviourComponent::start(Behaviour behaviour) {
+    std::shared_ptr<BehaviourScheduler> scheduler = m_scheduler.lock();
+    if (scheduler == nullptr) {
+        throw std::runtime_error("Cannot start a behaviour, its scheduler no longer exists");
+    }
+    // Forget finished ones, so starting behaviour after behaviour doesn't grow this forever
+    std::erase_if(m_started, [&](BehaviourId id) { return !scheduler->isRunning(id); });
+    BehaviourId id = scheduler->start(std::move(behaviour), m_entityId);
+    m_started.push_back(id);
+    return id;
+}
+
+size_t BehaviourComponent::running() const noexcept {
+    std::shared_ptr<BehaviourScheduler> scheduler = m_scheduler.lock();
+    if (scheduler == nullptr) {
+        return 0;
+    }
+    return std::count_if(m_started.begin(), m_started.end(), [&](BehaviourId id) { return scheduler->isRunning(id); });
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include <entities/components.h>
+#include <meta/events.h>
+
+/** Source input/input.h */
+class InputSnapshot;
+/** Source entities/entity.h */
+class IEntity;
+class BehaviourScheduler;
+
+/**
+ * Free lists of coroutine frames, by size in steps of s_granularity. Frames are carved out of slabs that are never returned,
+ * so after warming up, starting a behaviour doesn't touch the heap. Frames larger than s_maxPooled come from the heap as usual.
+ */
+class CoroutineFramePool {
+public:
+    static constexpr size_t s_granularity = 64;
+    static constexpr size_t s_maxPooled = 1024;
+    static constexpr size_t s_framesPerSlab = 64;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* frame, size_t size) noexcept;
+    /** Frames currently handed out, for tests and MemoryAccounting-like reporting */
+    static size_t inUse() noexcept;
+};
+
+/** What a behaviour is suspended on, so cancelling it can take it off that list */
+enum class BehaviourWait : uint8_t {
+    Nothing,
+    NextTick,
+    Delay,
+    Key,
+    Collision
+};
+
+/** Identifies a started behaviour. Stays unique after it finishes, ids of finished behaviours are simply ignored */
+using BehaviourId = uint64_t;
+
+/**
+ * Coroutine to script entities with, over any number of ticks. Written as a function returning Behaviour, which
+ * co_awaits nextTick(), delay(), keyPressed() or collision(), and is started through a BehaviourComponent.
+ * Nothing runs until then.
+ */
+class Behaviour {
+public:
+    struct promise_type {
+        BehaviourScheduler* scheduler = nullptr;
+        long long entityId = -1;
+        uint32_t slot = 0;
+        /** What the last collision() resumed with */
+        CollisionBegan collision = {-1, -1};
+        BehaviourWait waiting = BehaviourWait::Nothing;
+        /** Scancode or entity id, for Key and Collision */
+        long long waitingOn = -1;
+        std::exception_ptr error = nullptr;
+
+        Behaviour get_return_object() noexcept { return Behaviour(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        /** The scheduler destroys finished behaviours */
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        static void* operator new(size_t size) { return CoroutineFramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) noexcept { CoroutineFramePool::deallocate(frame, size); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Behaviour(Behaviour&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+    Behaviour& operator=(Behaviour&& other) noexcept;
+    Behaviour(const Behaviour&) = delete;
+    Behaviour& operator=(const Behaviour&) = delete;
+    /** Destroys the coroutine if it was never started */
+    ~Behaviour();
+
+private:
+    friend class BehaviourScheduler;
+
+    Handle m_handle;
+
+    explicit Behaviour(Handle handle) noexcept : m_handle(handle) {};
+    Handle release() noexcept;
+};
+
+/**
+ * Resumes behaviours once whatever they wait for happened. Waiting costs nothing per tick: timers sit in a heap,
+ * key presses and collisions in lists per key and per entity, so only behaviours that actually resume are touched.
+ * Owned by SceneContext, and updated by the scene once per tick.
+ */
+class BehaviourScheduler {
+public:
+    /** Collisions are picked up from events, if given */
+    explicit BehaviourScheduler(EventBus* events = nullptr);
+    ~BehaviourScheduler();
+    BehaviourScheduler(const BehaviourScheduler&) = delete;
+    BehaviourScheduler& operator=(const BehaviourScheduler&) = delete;
+
+    /** Runs the behaviour up to its first co_await. Collisions are those of entityId */
+    BehaviourId start(Behaviour behaviour, long long entityId = -1);
+    /** Destroys the behaviour wherever it is waiting. Safe to call for finished ones, and from within a behaviour */
+    void cancel(BehaviourId id) noexcept;
+    bool isRunning(BehaviourId id) const noexcept;
+
+    /** Resume everything due. Rethrows the first exception a behaviour threw, after destroying it */
+    void update(float deltaT, const InputSnapshot& input);
+    /** Destroys all behaviours and stops listening for collisions */
+    void clear() noexcept;
+
+    size_t running() const noexcept { return m_slots.size() - m_free.size(); }
+    size_t resumedLastUpdate() const noexcept { return m_resumed; }
+    /** Entries in the timer heap and the key and collision lists, including cancelled timers not yet pruned */
+    size_t waitListSize() const noexcept;
+
+    // Used by the awaitables below
+    void waitNextTick(uint32_t slot);
+    void waitDelay(uint32_t slot, float duration);
+    void waitKey(uint32_t slot, SDL_Scancode code);
+    void waitCollision(uint32_t slot, long long entityId);
+
+private:
+    struct Slot {
+        Behaviour::Handle handle = nullptr;
+        uint32_t generation = 0;
+    };
+    struct Timer {
+        double wakeAt;
+        BehaviourId id;
+        bool operator>(const Timer& other) const noexcept { return wakeAt > other.wakeAt; }
+    };
+
+    EventBus* m_events;
+    EventSubscriptionId m_subscription = -1;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_free;
+
+    std::vector<BehaviourId> m_nextTick;
+    /** Heap ordered by std::greater, so it can be pruned in place */
+    std::vector<Timer> m_timers;
+    /** Timers of cancelled behaviours still in the heap */
+    size_t m_staleTimers = 0;
+    std::unordered_map<int, std::vector<BehaviourId>> m_keyWaiters;
+    std::unordered_map<long long, std::vector<BehaviourId>> m_collisionWaiters;
+    /** Collided since the last update */
+    std::vector<BehaviourId> m_collided;
+    /** Kept for capacity */
+    std::vector<BehaviourId> m_resuming;
+
+    double m_time = 0.0;
+    size_t m_resumed = 0;
+    /** Slot being resumed right now, cancelling it is deferred until it suspends */
+    uint32_t m_current = UINT32_MAX;
+    bool m_cancelCurrent = false;
+
+    BehaviourId idOf(uint32_t slot) const noexcept { return (static_cast<uint64_t>(m_slots[slot].generation) << 32) | slot; }
+    /** nullptr if the id is stale */
+    Slot* find(BehaviourId id) noexcept;
+    /** Returns the exception it threw, if it finished by throwing */
+    std::exception_ptr resume(uint32_t slot) noexcept;
+    void destroy(uint32_t slot) noexcept;
+};
+
+struct NextTickAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle handle) { handle.promise().scheduler->waitNextTick(handle.promise().slot); }
+    void await_resume() const noexcept {}
+};
+
+struct DelayAwaiter {
+    float duration;
+    bool await_ready() const noexcept { return duration <= 0.0f; }
+    void await_suspend(Behaviour::Handle handle) { handle.promise().scheduler->waitDelay(handle.promise().slot, duration); }
+    void await_resume() const noexcept {}
+};
+
+struct KeyPressAwaiter {
+    SDL_Scancode code;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle handle) { handle.promise().scheduler->waitKey(handle.promise().slot, code); }
+    void await_resume() const noexcept {}
+};
+
+struct CollisionAwaiter {
+    Behaviour::Handle handle = nullptr;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle suspended) {
+        handle = suspended;
+        handle.promise().scheduler->waitCollision(handle.promise().slot, handle.promise().entityId);
+    }
+    CollisionBegan await_resume() const noexcept { return handle.promise().collision; }
+};
+
+/** Resume on the next update */
+inline NextTickAwaiter nextTick() noexcept { return {}; }
+/** Resume once duration worth of deltaT has passed */
+inline DelayAwaiter delay(float duration) noexcept { return {duration}; }
+/** Resume on the update the key went down */
+inline KeyPressAwaiter keyPressed(SDL_Scancode code) noexcept { return {code}; }
+/** Resume on the update after the entity the behaviour was started for began colliding with something */
+inline CollisionAwaiter collision() noexcept { return {}; }
+
+/**
+ * Runs behaviours on behalf of an entity, and cancels them along with it. Not ticked itself,
+ * the scheduler resumes its behaviours directly.
+ */
+class BehaviourComponent : public IStandaloneEntityComponent {
+public:
+    /** entityId is whose collisions collision() waits for */
+    BehaviourComponent(std::shared_ptr<BehaviourScheduler> scheduler, long long entityId)
+        : m_scheduler(scheduler), m_entityId(entityId) {};
+    ~BehaviourComponent();
+
+    BehaviourId start(Behaviour behaviour);
+    /** Behaviours started here that haven't finished yet */
+    size_t running() const noexcept;
+
+private:
+    std::weak_ptr<BehaviourScheduler> m_scheduler;
+    long long m_entityId;
+    std::vector<BehaviourId> m_started;
+};
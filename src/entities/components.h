@@ -3,7 +3,10 @@
 #include <typeindex>
 #include <glm/glm.hpp>
 #include <functional>
+#include <format>
 
+#include <meta/reflection.h>
+#include <entities/ids.h>
 #include <meta/processing.h>
 #include <meta/ApplicationContext.h>
 
@@ -22,6 +25,9 @@ concept DependentComponent = std::derived_from<T, IDependentEntityComponent>;
 // This is some TS level of shenanigans
 template<typename T>
 concept AnyComponent = StandaloneComponent<T> || DependentComponent<T>;
+// Anything an entity can hold, either derived from IEntityComponent or plain data, see meta/reflection.h
+template<typename T>
+concept EntityComponent = AnyComponent<T> || PlainComponent<T>;
 
 // Function type for getting components of parent, or however the component happens to be used at time of instantiation
 using ComponentRetriever = std::function<IEntityComponent*(const std::type_info&)>;
@@ -30,12 +36,14 @@ using ComponentRetriever = std::function<IEntityComponent*(const std::type_info&
  * make sure to use either IStandaloneEntityComponent or IDependentEntityComponent */
 class IEntityComponent {
 private:
-    // Simple id for each component
-    static inline long long s_id = 0;
+    // Unique among live components, see IdSpace
     long long m_id;
 public:
-    IEntityComponent() : m_id(s_id++) {};
-    virtual ~IEntityComponent() = default;
+    IEntityComponent() : m_id(IdSpace::components().allocate()) {};
+    /** Copies are components of their own, with an id of their own */
+    IEntityComponent(const IEntityComponent&) : IEntityComponent() {};
+    IEntityComponent& operator=(const IEntityComponent&) noexcept { return *this; }
+    virtual ~IEntityComponent() { IdSpace::components().release(m_id); };
     
     long long getComponentId() const noexcept { return m_id; }
 };
@@ -72,6 +80,7 @@ protected:
     }
 };
 
+/** Local transform, relative to the parent if it is part of a TransformHierarchy */
 class TransformComponent : public IStandaloneEntityComponent {
 public:
     glm::fvec3 position = glm::fvec3(0.0f, 0.0f, 0.0f);
@@ -82,15 +91,34 @@ public:
     TransformComponent(glm::fvec3 position) : position(position) {};
     TransformComponent(glm::fvec3 position, glm::fvec2 scale, float rotation) 
         : position(position), scale(scale), rotation(rotation) {};
+
+    /** What to draw with. As of the last TransformHierarchy::update() if it has a node, the local transform otherwise */
+    glm::fvec3 worldPosition() const noexcept { return m_inHierarchy ? glm::fvec3(m_worldPosition, position.z) : position; }
+    glm::fvec2 worldScale() const noexcept { return m_inHierarchy ? m_worldScale : scale; }
+    float worldRotation() const noexcept { return m_inHierarchy ? m_worldRotation : rotation; }
+
+private:
+    friend class TransformHierarchy;
+
+    /** Written by the hierarchy, z is never affected by parents */
+    glm::fvec2 m_worldPosition = glm::fvec2(0.0f, 0.0f);
+    glm::fvec2 m_worldScale = glm::fvec2(1.0f, 1.0f);
+    float m_worldRotation = 0.0f;
+    bool m_inHierarchy = false;
 };
 
-class HealthComponent : public IStandaloneEntityComponent {
-public:
+struct HealthComponent {
     int health = 1;
-    HealthComponent() {};
+    HealthComponent() = default;
     HealthComponent(int health) : health(health) {};
 };
 
+template<>
+struct Reflection<HealthComponent> {
+    static constexpr const char* name = "HealthComponent";
+    static constexpr auto fields = std::tuple{field("health", &HealthComponent::health)};
+};
+
 // For gravity or other creative purposes
 class ContinuousForceComponent : public IDependentEntityComponent, public ITickable {
 private:
@@ -2,16 +2,42 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
+#include <memory_resource>
+#include <new>
 #include <typeindex>
 #include <cassert>
 #include <functional>
 #include <format>
 
 #include <entities/components.h>
-#include <types/types.h>
+#include <entities/plainStorage.h>
+#include <meta/events.h>
+#include <meta/memoryStats.h>
 
 //Forward declaration
 class IEntity;
+/** Source scene/prefab.h */
+class Prefab;
+
+/** Deletes components, unless they live in storage owned by someone else, like PrefabInstances */
+struct ComponentDeleter {
+    bool pooled = false;
+    /** Where the component is accounted for, see MemoryAccounting */
+    TypeMemoryStats* stats = nullptr;
+
+    void operator()(IEntityComponent* component) const noexcept {
+        if (stats != nullptr) {
+            stats->onDestroyed();
+        }
+        if (pooled) {
+            component->~IEntityComponent();
+        } else {
+            delete component;
+        }
+    }
+};
+using ComponentPtr = std::unique_ptr<IEntityComponent, ComponentDeleter>;
 
 template <typename T>
 concept AnyEntity = std::derived_from<T, IEntity>;
@@ -21,14 +47,21 @@ concept AnyEntity = std::derived_from<T, IEntity>;
 */
 class IEntity {
 public:
-    IEntity() : m_id(s_id++) {};
+    /** Takes its id from IdSpace::current() */
+    IEntity() : m_ids(&IdSpace::current()), m_id(m_ids->allocate()) {
+        m_memoryStats->onCreated(true);
+    };
+    /** Component bookkeeping is allocated from resource, which must outlive the entity */
+    explicit IEntity(std::pmr::memory_resource* resource) : m_ids(&IdSpace::current()), m_id(m_ids->allocate()), m_components(resource), m_plainComponents(resource) {
+        m_memoryStats->onCreated(false);
+    };
 
     /**
      * @brief Add a component to the entity. If the entity already contains a component of the same typeid,
      * it will be replaced and the previous component will be freed.
      * To avoid freeing the previous component, use addComponentGetPrevious<T>(Args&&... args) instead to take ownership.
      */
-    template <AnyComponent T, typename... Args>
+    template <EntityComponent T, typename... Args>
     void addComponent(Args&&... args) {
         std::unique_ptr<T> previous = addComponentGetPrevious<T>(std::forward<Args>(args)...);
 
@@ -41,10 +74,18 @@ public:
     /**
      * @brief Add a component to the entity. If the entity already contains a component of the same typeid,
      * it will be replaced and the previous component will be returned.
+     * Plain components are overwritten in place instead, and nullptr is returned.
+     * So is nullptr when the previous component lived in storage owned by someone else, e.g. a PrefabInstance arena.
+     * It is destroyed in place rather than handed over, so nullptr doesn't mean there was no previous component.
      */
-    template <AnyComponent T, typename... Args>
+    template <EntityComponent T, typename... Args>
     std::unique_ptr<T> addComponentGetPrevious(Args&&... args) {
-        return addAnyComponent<T>(std::forward<Args>(args)...);
+        if constexpr (PlainComponent<T>) {
+            addPlainComponent<T>(std::forward<Args>(args)...);
+            return nullptr;
+        } else {
+            return addAnyComponent<T>(std::forward<Args>(args)...);
+        }
     }
 
     /**
@@ -52,7 +93,7 @@ public:
      * it will be replaced and the previous component will be freed.
      * To avoid freeing the previous component, use addComponentAndGetPrevious<T>(Args&&... args) instead to take ownership.
      */
-    template <AnyComponent T, typename... Args>
+    template <EntityComponent T, typename... Args>
     T* addComponentAndGetRawPtr(Args&&... args) {
         // Add component, free previous, get raw pointer to new component
         addComponent<T>(std::forward<Args>(args)...);
@@ -62,16 +103,21 @@ public:
     /**
      * @brief Retrieve a component from the entity. Returns nullptr if the Entity does not have such a component
      */
-    template <AnyComponent T>
+    template <EntityComponent T>
     [[nodiscard]] T* getComponent() const noexcept {
-        return static_cast<T*>(getComponentByTypeInfo(typeid(T)));
+        if constexpr (PlainComponent<T>) {
+            const PlainComponentRef* ref = findPlainComponent(&PlainComponentPool<T>::instance());
+            return ref == nullptr ? nullptr : &PlainComponentPool<T>::instance().at(ref->record);
+        } else {
+            return static_cast<T*>(getComponentByTypeInfo(typeid(T)));
+        }
     }
 
     /**
      * @brief Throw an error if a component does not exist, but is required.
      * Use requireComponent(const char* msg) to provide a custom error message.
      */
-    template <AnyComponent T>
+    template <EntityComponent T>
     [[nodiscard]] const T* requireComponent() const {
         T* component = getComponent<T>();
         if (component == nullptr) {
@@ -80,13 +126,28 @@ public:
         return component;
     }
 
-    template <AnyComponent T>
+    template <EntityComponent T>
     bool removeComponent() {
-        return m_components.erase(typeid(T)) > 0;
+        if constexpr (PlainComponent<T>) {
+            const PlainComponentRef* ref = findPlainComponent(&PlainComponentPool<T>::instance());
+            if (ref == nullptr) {
+                return false;
+            }
+            ref->pool->release(ref->record);
+            m_plainComponents.erase(m_plainComponents.begin() + (ref - m_plainComponents.data()));
+        } else if (m_components.erase(typeid(T)) == 0) {
+            return false;
+        }
+        m_structureVersion++;
+        if (m_events != nullptr) {
+            m_events->publish(ComponentRemoved{m_id, typeid(T)});
+        }
+        return true;
     }
 
     /**
-     * @brief Iterate over all components that can be cast to type T and apply the provided function
+     * @brief Iterate over all components that can be cast to type T and apply the provided function.
+     * Plain components aren't polymorphic, and never match.
      * 
      * @tparam T The target type to filter by (can be any interface or base class)
      * @param func The function to apply to each matching component
@@ -101,28 +162,84 @@ public:
         }
     }
 
+    /** Unique among live entities of the same IdSpace. IdSpace::index of it is dense, to index arrays with */
     long long getEntityId() const noexcept { return m_id; }
+    /** Where getEntityId() came from. Ids of different spaces may be equal */
+    const IdSpace& idSpace() const noexcept { return *m_ids; }
+    /** Changes whenever a component is added, replaced or removed. Pointers to components stay valid while it is unchanged */
+    uint32_t structureVersion() const noexcept { return m_structureVersion; }
+
+    /** Where EntityDestroyed, ComponentAdded and ComponentRemoved are published. nullptr to publish nothing */
+    void setEventBus(EventBus* events) noexcept { m_events = events; }
+
+    /**
+     * Counts this entity as a T from now on. Constructors only know their own type, so entities start out as IEntity,
+     * see SceneContext::registerEntity. Heap allocations stay counted where they were made
+     */
+    template <AnyEntity T>
+    void accountAs() noexcept {
+        TypeMemoryStats& stats = MemoryAccounting::of<T>();
+        if (&stats != m_memoryStats) {
+            stats.onCreated(false);
+            m_memoryStats->onDestroyed();
+            m_memoryStats = &stats;
+        }
+    }
+    /** Where this entity is accounted for, see accountAs */
+    const TypeMemoryStats& memoryStats() const noexcept { return *m_memoryStats; }
+    /** Calls func with where each component is accounted for. Plain components aren't, they live in their pools */
+    template <typename F>
+    void forEachComponentStats(F&& func) const {
+        for (const auto& [type, component] : m_components) {
+            if (component.get_deleter().stats != nullptr) {
+                func(*component.get_deleter().stats);
+            }
+        }
+    }
 
-    void onDestruction(OnDestructionCallback<IEntity> callback) {
-        m_destructionCallbacks.push_back(callback);
+    size_t componentCount() const noexcept { return m_components.size() + m_plainComponents.size(); }
+    /** sizeof each component, not counting anything they allocate themselves */
+    size_t componentBytes() const noexcept {
+        size_t bytes = 0;
+        for (const auto& [type, component] : m_components) {
+            if (component.get_deleter().stats != nullptr) {
+                bytes += component.get_deleter().stats->size;
+            }
+        }
+        for (const PlainComponentRef& ref : m_plainComponents) {
+            bytes += ref.pool->recordSize();
+        }
+        return bytes;
     }
 
     ~IEntity() {
-        for (OnDestructionCallback<IEntity> callback : m_destructionCallbacks) {
-            callback(this);
+        m_memoryStats->onDestroyed();
+        for (const PlainComponentRef& ref : m_plainComponents) {
+            ref.pool->release(ref.record);
+        }
+        if (m_events != nullptr) {
+            m_events->publish(EntityDestroyed{m_id});
         }
+        m_ids->release(m_id);
     };
 
 private:
-    static inline long long s_id = 0;
+    IdSpace* m_ids;
     long long m_id;
+    uint32_t m_structureVersion = 0;
+    TypeMemoryStats* m_memoryStats = &MemoryAccounting::of<IEntity>();
 
-    std::unordered_map<std::type_index, std::unique_ptr<IEntityComponent>> m_components;
-    std::vector<OnDestructionCallback<IEntity>> m_destructionCallbacks;
+    std::pmr::unordered_map<std::type_index, ComponentPtr> m_components;
+    /** Few per entity, a linear search beats hashing */
+    std::pmr::vector<PlainComponentRef> m_plainComponents;
+    EventBus* m_events = nullptr;
 
+    friend class Prefab;
+
+    /** nullptr if there was no previous component, or it was pooled, see addComponentGetPrevious */
     template<AnyComponent T, typename... Args>
     std::unique_ptr<T> addAnyComponent(Args&&... args) {
-        std::unique_ptr<IEntityComponent> previous = releaseComponentByTypeInfo(typeid(T));
+        ComponentPtr previous = releaseComponentByTypeInfo(typeid(T));
         
         std::unique_ptr<T> newComponent;
         if constexpr (DependentComponent<T>) {
@@ -137,9 +254,23 @@ private:
         }
 
         // Move ownership to map
-        m_components.emplace(typeid(T), std::move(newComponent));
+        TypeMemoryStats& stats = MemoryAccounting::of<T>();
+        m_components.emplace(typeid(T), ComponentPtr(newComponent.release(), ComponentDeleter{false, &stats}));
+        stats.onCreated(true);
+        m_structureVersion++;
+        if (m_events != nullptr) {
+            m_events->publish(ComponentAdded{m_id, typeid(T)});
+        }
 
+        // The storage of pooled components isn't ours to hand out, they are destroyed in place instead
+        if (previous != nullptr && previous.get_deleter().pooled) {
+            return nullptr;
+        }
         if (previous != nullptr) {
+            // Handed to the caller, and no longer accounted for
+            if (previous.get_deleter().stats != nullptr) {
+                previous.get_deleter().stats->onDestroyed();
+            }
             // According to Claude, there is no way to cast directly to unique_ptr<T>, so it is necessary to release it first
             // then cast the raw pointer, then back to unique_ptr<T> to maintain memory management
             T* derived = static_cast<T*>(previous.release());
@@ -149,12 +280,39 @@ private:
         return nullptr;
     }
 
-    std::unique_ptr<IEntityComponent> releaseComponentByTypeInfo(const std::type_info& type) noexcept {
+    template<PlainComponent T, typename... Args>
+    void addPlainComponent(Args&&... args) {
+        PlainComponentPool<T>& pool = PlainComponentPool<T>::instance();
+        const PlainComponentRef* existing = findPlainComponent(&pool);
+        uint32_t record;
+        if (existing != nullptr) {
+            record = existing->record;
+        } else {
+            record = pool.acquire(m_id);
+            m_plainComponents.push_back(PlainComponentRef{&pool, record});
+        }
+        pool.at(record) = T(std::forward<Args>(args)...);
+        m_structureVersion++;
+        if (m_events != nullptr) {
+            m_events->publish(ComponentAdded{m_id, typeid(T)});
+        }
+    }
+
+    const PlainComponentRef* findPlainComponent(const IPlainComponentPool* pool) const noexcept {
+        for (const PlainComponentRef& ref : m_plainComponents) {
+            if (ref.pool == pool) {
+                return &ref;
+            }
+        }
+        return nullptr;
+    }
+
+    ComponentPtr releaseComponentByTypeInfo(const std::type_info& type) noexcept {
         auto it = m_components.find(type);
         if (it == m_components.end()) {
             return nullptr;
         }
-        std::unique_ptr<IEntityComponent> ptr = std::move(it->second);
+        ComponentPtr ptr = std::move(it->second);
         m_components.erase(it);
         return ptr;
     }
@@ -173,6 +331,31 @@ private:
     template <StandaloneComponent T, typename... Args>
     void addComponentDirect(Args&&... args) {
         auto ptr = std::make_unique<T>(std::forward<Args>(args)...);
-        m_components.emplace(typeid(T), std::move(ptr));
+        TypeMemoryStats& stats = MemoryAccounting::of<T>();
+        m_components.emplace(typeid(T), ComponentPtr(ptr.release(), ComponentDeleter{false, &stats}));
+        stats.onCreated(true);
+        m_structureVersion++;
+        if (m_events != nullptr) {
+            m_events->publish(ComponentAdded{m_id, typeid(T)});
+        }
+    }
+
+    /** Construct a component in storage owned by someone else, which must outlive it. See Prefab */
+    template<AnyComponent T, typename... Args>
+    T* emplacePooledComponent(void* storage, Args&&... args) {
+        T* component;
+        if constexpr (DependentComponent<T>) {
+            component = new (storage) T(m_retriever, std::forward<Args>(args)...);
+        } else {
+            component = new (storage) T(std::forward<Args>(args)...);
+        }
+        TypeMemoryStats& stats = MemoryAccounting::of<T>();
+        m_components.insert_or_assign(typeid(T), ComponentPtr(component, ComponentDeleter{true, &stats}));
+        stats.onCreated(false);
+        m_structureVersion++;
+        if (m_events != nullptr) {
+            m_events->publish(ComponentAdded{m_id, typeid(T)});
+        }
+        return component;
     }
 };
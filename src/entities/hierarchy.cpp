@@ -0,0 +1,183 @@
+#include <stdexcept>
+#include <algorithm>
+#include <format>
+#include <cmath>
+
+#include <entities/hierarchy.h>
+
+TransformNode TransformHierarchy::add(TransformComponent* local, TransformNode parent) {
+    if (local == nullptr) {
+        throw std::runtime_error("Cannot add a null transform to a hierarchy");
+    }
+    if (parent != NoTransformNode) {
+        node(parent);
+    }
+
+    TransformNode handle;
+    if (!m_free.empty()) {
+        handle = m_free.back();
+        m_free.pop_back();
+    } else {
+        handle = static_cast<TransformNode>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    m_nodes[handle] = Node{local, parent, 0, true};
+    local->m_inHierarchy = true;
+    m_structureChanged = true;
+    return handle;
+}
+
+void TransformHierarchy::remove(TransformNode handle) {
+    TransformNode parent = node(handle).parent;
+    for (Node& other : m_nodes) {
+        if (other.alive && other.parent == handle) {
+            other.parent = parent;
+        }
+    }
+    m_nodes[handle].local->m_inHierarchy = false;
+    m_nodes[handle] = Node{};
+    m_free.push_back(handle);
+    m_structureChanged = true;
+}
+
+void TransformHierarchy::setParent(TransformNode handle, TransformNode parent) {
+    node(handle);
+    for (TransformNode ancestor = parent; ancestor != NoTransformNode; ancestor = node(ancestor).parent) {
+        if (ancestor == handle) {
+            throw std::runtime_error(std::format("Transform node {} cannot be parented to its own descendant {}", handle, parent));
+        }
+    }
+    m_nodes[handle].parent = parent;
+    m_structureChanged = true;
+}
+
+TransformNode TransformHierarchy::parent(TransformNode handle) const {
+    return node(handle).parent;
+}
+
+const glm::mat3& TransformHierarchy::world(TransformNode handle) const {
+    const Node& found = node(handle);
+    if (m_structureChanged) {
+        throw std::runtime_error(std::format("Transform node {} has no world matrix until the next update", handle));
+    }
+    return m_worlds[found.index];
+}
+
+glm::fvec2 TransformHierarchy::worldPosition(TransformNode handle) const {
+    const glm::mat3& matrix = world(handle);
+    return glm::fvec2(matrix[2].x, matrix[2].y);
+}
+
+const TransformHierarchy::Node& TransformHierarchy::node(TransformNode handle) const {
+    if (handle >= m_nodes.size() || !m_nodes[handle].alive) {
+        throw std::runtime_error(std::format("Transform node {} does not exist", handle));
+    }
+    return m_nodes[handle];
+}
+
+void TransformHierarchy::update() {
+    bool everything = m_structureChanged;
+    if (m_structureChanged) {
+        rebuild();
+    }
+
+    size_t updated = 0;
+    for (size_t i = 0; i < m_order.size(); i++) {
+        LocalTransform local = snapshot(*m_locals[i]);
+        uint32_t parent = m_parents[i];
+        bool parentRecomputed = parent != s_root && m_recomputed[parent];
+        if (!everything && !parentRecomputed && local == m_cached[i]) {
+            m_recomputed[i] = false;
+            continue;
+        }
+
+        m_cached[i] = local;
+        m_worlds[i] = parent == s_root ? toMatrix(local) : m_worlds[parent] * toMatrix(local);
+        writeBack(m_worlds[i], *m_locals[i]);
+        m_recomputed[i] = true;
+        updated++;
+    }
+    m_lastUpdated = updated;
+}
+
+void TransformHierarchy::rebuild() {
+    // Depth of every node, following parents until one with a known depth
+    std::vector<uint32_t> depths(m_nodes.size(), UINT32_MAX);
+    std::vector<TransformNode> chain;
+    uint32_t maxDepth = 0;
+    for (TransformNode handle = 0; handle < m_nodes.size(); handle++) {
+        if (!m_nodes[handle].alive) {
+            continue;
+        }
+        TransformNode at = handle;
+        while (at != NoTransformNode && depths[at] == UINT32_MAX) {
+            chain.push_back(at);
+            at = m_nodes[at].parent;
+        }
+        uint32_t depth = at == NoTransformNode ? 0 : depths[at] + 1;
+        for (size_t i = chain.size(); i > 0; i--) {
+            depths[chain[i - 1]] = depth++;
+        }
+        maxDepth = std::max(maxDepth, depth);
+        chain.clear();
+    }
+
+    // Counting sort by depth, stable so siblings stay in the order they were added
+    std::vector<size_t> levelStarts(maxDepth + 1, 0);
+    for (TransformNode handle = 0; handle < m_nodes.size(); handle++) {
+        if (m_nodes[handle].alive) {
+            levelStarts[depths[handle] + 1]++;
+        }
+    }
+    for (size_t level = 1; level < levelStarts.size(); level++) {
+        levelStarts[level] += levelStarts[level - 1];
+    }
+
+    size_t count = m_nodes.size() - m_free.size();
+    m_order.resize(count);
+    for (TransformNode handle = 0; handle < m_nodes.size(); handle++) {
+        if (m_nodes[handle].alive) {
+            size_t index = levelStarts[depths[handle]]++;
+            m_order[index] = handle;
+            m_nodes[handle].index = static_cast<uint32_t>(index);
+        }
+    }
+
+    m_locals.resize(count);
+    m_parents.resize(count);
+    m_cached.resize(count);
+    m_worlds.resize(count);
+    m_recomputed.assign(count, true);
+    for (size_t i = 0; i < count; i++) {
+        const Node& node = m_nodes[m_order[i]];
+        m_locals[i] = node.local;
+        m_parents[i] = node.parent == NoTransformNode ? s_root : m_nodes[node.parent].index;
+    }
+    m_structureChanged = false;
+}
+
+TransformHierarchy::LocalTransform TransformHierarchy::snapshot(const TransformComponent& transform) noexcept {
+    return LocalTransform{glm::fvec2(transform.position), transform.scale, transform.rotation};
+}
+
+void TransformHierarchy::writeBack(const glm::mat3& world, TransformComponent& transform) noexcept {
+    // Exact unless a parent is scaled unevenly and a child rotated within it, which would need shear to express
+    float determinant = world[0].x * world[1].y - world[1].x * world[0].y;
+    transform.m_worldPosition = glm::fvec2(world[2].x, world[2].y);
+    transform.m_worldScale = glm::fvec2(
+        std::hypot(world[0].x, world[0].y),
+        std::copysign(std::hypot(world[1].x, world[1].y), determinant)
+    );
+    transform.m_worldRotation = std::atan2(world[0].y, world[0].x);
+}
+
+glm::mat3 TransformHierarchy::toMatrix(const LocalTransform& local) noexcept {
+    // Translation * rotation * scale, column major
+    float cos = std::cos(local.rotation);
+    float sin = std::sin(local.rotation);
+    return glm::mat3(
+        cos * local.scale.x, sin * local.scale.x, 0.0f,
+        -sin * local.scale.y, cos * local.scale.y, 0.0f,
+        local.position.x, local.position.y, 1.0f
+    );
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <entities/components.h>
+
+/** Handle to a node of a TransformHierarchy, stays the same however the nodes are reordered */
+using TransformNode = uint32_t;
+constexpr TransformNode NoTransformNode = UINT32_MAX;
+
+/**
+ * Parent/child relations between TransformComponents, and the world matrix of each, cached.
+ * Transforms are 2D: position.xy, scale and rotation around z. Position.z orders draws, and is left as is.
+ *
+ * Nodes are kept in contiguous arrays sorted by depth, so parents always come before their children and update()
+ * is one pass front to back, level after level. A node is recomputed only when its local transform differs from
+ * the one it was last computed from, or its parent was recomputed, so unchanged subtrees cost a compare per node.
+ * Components are referenced, not owned. Remove their node before destroying them.
+ * update() also writes the world transform back into each component, for draw and capture to read via worldPosition() and co.
+ */
+class TransformHierarchy {
+public:
+    TransformHierarchy() = default;
+    TransformHierarchy(const TransformHierarchy&) = delete;
+    TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+    /** Throws if local is null or parent isn't a node */
+    TransformNode add(TransformComponent* local, TransformNode parent = NoTransformNode);
+    /** Children of the removed node are attached to its parent, keeping their local transforms */
+    void remove(TransformNode node);
+    /** NoTransformNode makes it a root. Throws if that would make node its own ancestor */
+    void setParent(TransformNode node, TransformNode parent);
+    TransformNode parent(TransformNode node) const;
+
+    /** Recompute the world matrices of changed subtrees. Call once per tick, after anything moving transforms */
+    void update();
+
+    /** As of the last update() */
+    const glm::mat3& world(TransformNode node) const;
+    glm::fvec2 worldPosition(TransformNode node) const;
+
+    size_t size() const noexcept { return m_order.size(); }
+    /** Nodes recomputed by the last update() */
+    size_t lastUpdated() const noexcept { return m_lastUpdated; }
+
+private:
+    /** What the world matrix was last computed from */
+    struct LocalTransform {
+        glm::fvec2 position;
+        glm::fvec2 scale;
+        float rotation;
+
+        bool operator==(const LocalTransform& other) const noexcept = default;
+    };
+
+    struct Node {
+        TransformComponent* local = nullptr;
+        TransformNode parent = NoTransformNode;
+        /** Into the sorted arrays below, rebuilt along with them */
+        uint32_t index = 0;
+        bool alive = false;
+    };
+
+    /** By handle */
+    std::vector<Node> m_nodes;
+    std::vector<TransformNode> m_free;
+
+    /** Sorted by depth, all the same length. Parent indices point into these, always below the child's own */
+    std::vector<TransformNode> m_order;
+    std::vector<TransformComponent*> m_locals;
+    std::vector<uint32_t> m_parents;
+    std::vector<LocalTransform> m_cached;
+    std::vector<glm::mat3> m_worlds;
+    std::vector<uint8_t> m_recomputed;
+
+    bool m_structureChanged = false;
+    size_t m_lastUpdated = 0;
+
+    static constexpr uint32_t s_root = UINT32_MAX;
+
+    const Node& node(TransformNode node) const;
+    /** Sort the nodes by depth again, after nodes were added, removed or reparented */
+    void rebuild();
+    static LocalTransform snapshot(const TransformComponent& transform) noexcept;
+    static glm::mat3 toMatrix(const LocalTransform& local) noexcept;
+    /** Decomposes world into the world transform of the component */
+    static void writeBack(const glm::mat3& world, TransformComponent& transform) noexcept;
+};
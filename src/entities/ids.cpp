@@ -0,0 +1,171 @@
+#include <array>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <entities/ids.h>
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, IdSpace*> spaces;
+        uint64_t nextSerial = 1;
+    };
+
+    /** Never destroyed, threads may exit after static destruction started */
+    Registry& registry() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    struct ThreadCache {
+        uint64_t serial = 0;
+        std::vector<long long> ids;
+    };
+
+    thread_local IdSpace* t_current = nullptr;
+}
+
+/** Ids a thread holds per space, for the few spaces it used most recently */
+struct ThreadIds {
+    static constexpr size_t s_slots = 4;
+    std::array<ThreadCache, s_slots> caches;
+    size_t nextEviction = 0;
+
+    ~ThreadIds() {
+        for (ThreadCache& cache : caches) {
+            giveBack(cache);
+        }
+    }
+
+    ThreadCache& of(IdSpace& space) {
+        for (ThreadCache& cache : caches) {
+            if (cache.serial == space.m_serial) {
+                return cache;
+            }
+        }
+        ThreadCache* slot = nullptr;
+        for (ThreadCache& cache : caches) {
+            if (cache.serial == 0) {
+                slot = &cache;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            slot = &caches[nextEviction];
+            nextEviction = (nextEviction + 1) % s_slots;
+            giveBack(*slot);
+        }
+        slot->serial = space.m_serial;
+        return *slot;
+    }
+
+    /** The space may be gone by now, it is only looked up by serial */
+    static void giveBack(ThreadCache& cache) noexcept {
+        if (!cache.ids.empty()) {
+            Registry& spaces = registry();
+            std::lock_guard lock(spaces.mutex);
+            auto it = spaces.spaces.find(cache.serial);
+            if (it != spaces.spaces.end()) {
+                try {
+                    it->second->returnBlock(std::move(cache.ids));
+                } catch (...) {
+                    // Out of memory, the ids are lost rather than reused
+                }
+            }
+        }
+        cache.ids.clear();
+        cache.serial = 0;
+    }
+};
+
+static thread_local ThreadIds t_ids;
+
+IdSpace::IdSpace() {
+    Registry& spaces = registry();
+    std::lock_guard lock(spaces.mutex);
+    m_serial = spaces.nextSerial++;
+    spaces.spaces.emplace(m_serial, this);
+}
+
+IdSpace::~IdSpace() {
+    Registry& spaces = registry();
+    std::lock_guard lock(spaces.mutex);
+    spaces.spaces.erase(m_serial);
+}
+
+IdSpace& IdSpace::entities() {
+    static IdSpace* space = new IdSpace();
+    return *space;
+}
+
+IdSpace& IdSpace::components() {
+    static IdSpace* space = new IdSpace();
+    return *space;
+}
+
+IdSpace& IdSpace::current() noexcept {
+    return t_current != nullptr ? *t_current : entities();
+}
+
+long long IdSpace::allocate() {
+    ThreadCache& cache = t_ids.of(*this);
+    if (cache.ids.empty()) {
+        cache.ids = takeBlock();
+    }
+    long long id = cache.ids.back();
+    cache.ids.pop_back();
+    return id;
+}
+
+void IdSpace::release(long long id) noexcept {
+    uint32_t generation = IdSpace::generation(id);
+    if (generation >= s_maxGeneration) {
+        return;
+    }
+    try {
+        ThreadCache& cache = t_ids.of(*this);
+        cache.ids.push_back((static_cast<long long>(generation + 1) << 32) | index(id));
+        // Threads releasing more than they allocate, e.g. a loader handing entities over, share the surplus
+        if (cache.ids.size() >= 2 * s_blockSize) {
+            std::vector<long long> surplus(cache.ids.begin(), cache.ids.begin() + s_blockSize);
+            cache.ids.erase(cache.ids.begin(), cache.ids.begin() + s_blockSize);
+            returnBlock(std::move(surplus));
+        }
+    } catch (...) {
+        // Out of memory, the index is retired rather than reused
+    }
+}
+
+std::vector<long long> IdSpace::takeBlock() {
+    std::lock_guard lock(m_mutex);
+    if (!m_returned.empty()) {
+        std::vector<long long> block = std::move(m_returned.back());
+        m_returned.pop_back();
+        return block;
+    }
+
+    uint64_t first = m_next.load(std::memory_order_relaxed);
+    if (first + s_blockSize > (uint64_t(1) << 32)) {
+        throw std::runtime_error("Out of ids");
+    }
+    m_next.store(first + s_blockSize, std::memory_order_relaxed);
+    // Handed out from the back, lowest first
+    std::vector<long long> block(s_blockSize);
+    for (uint32_t i = 0; i < s_blockSize; i++) {
+        block[i] = static_cast<long long>(first + s_blockSize - 1 - i);
+    }
+    return block;
+}
+
+void IdSpace::returnBlock(std::vector<long long> block) {
+    std::lock_guard lock(m_mutex);
+    m_returned.push_back(std::move(block));
+}
+
+IdSpace::Scope::Scope(IdSpace& space) noexcept : m_previous(t_current) {
+    t_current = &space;
+}
+
+IdSpace::Scope::~Scope() {
+    t_current = m_previous;
+}
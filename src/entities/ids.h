@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Hands out entity and component ids. An id is an index in its low 32 bits and a generation above them.
+ * Released indices are handed out again with the generation bumped, so indices stay dense enough to index arrays with
+ * while a stale id never equals a live one. Indices that ran out of generations are retired.
+ *
+ * Each thread takes ids in blocks of s_blockSize, and keeps what it releases for itself, so allocating only locks once
+ * per block. Ids a thread holds on to count towards capacity() without being live.
+ * Thread safe, but a space must outlive every id allocated from it that is still to be released.
+ */
+class IdSpace {
+public:
+    static constexpr uint32_t s_blockSize = 256;
+    static constexpr uint32_t s_maxGeneration = 0x7fffffff;
+
+    IdSpace();
+    ~IdSpace();
+    IdSpace(const IdSpace&) = delete;
+    IdSpace& operator=(const IdSpace&) = delete;
+
+    /** Where entities take their ids from, unless a Scope on their thread says otherwise */
+    static IdSpace& entities();
+    static IdSpace& components();
+    /** The innermost Scope on this thread, or entities() */
+    static IdSpace& current() noexcept;
+
+    /** Throws once all 2^32 indices were handed out */
+    long long allocate();
+    void release(long long id) noexcept;
+
+    static uint32_t index(long long id) noexcept { return static_cast<uint32_t>(id); }
+    static uint32_t generation(long long id) noexcept { return static_cast<uint32_t>(id >> 32); }
+    /** Every index handed out so far is below this */
+    uint32_t capacity() const noexcept { return static_cast<uint32_t>(m_next.load(std::memory_order_relaxed)); }
+
+    /** Makes space current on this thread while alive, e.g. while a scene is built on a loader thread */
+    class Scope {
+    public:
+        explicit Scope(IdSpace& space) noexcept;
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        IdSpace* m_previous;
+    };
+
+private:
+    friend struct ThreadIds;
+
+    /** Identifies the space in per thread caches, which may outlive it. Never reused, unlike addresses */
+    uint64_t m_serial;
+    std::mutex m_mutex;
+    /** Blocks of released ids handed back by threads */
+    std::vector<std::vector<long long>> m_returned;
+    std::atomic<uint64_t> m_next = 0;
+
+    /** Ids in the order they should be handed out, from the back */
+    std::vector<long long> takeBlock();
+    void returnBlock(std::vector<long long> block);
+};
@@ -0,0 +1,278 @@
+#include <thread>
+#include <system_error>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <format>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SDLGAME_PARTICLES_SSE 1
+#endif
+
+#include <entities/particles.h>
+#include <meta/pipeline.h>
+#include <meta/log.h>
+
+ParticleEmitter::ParticleEmitter(ComponentRetriever compRet, ParticleEmitterConfig config)
+    : IDependentEntityComponent(compRet), m_config(config), m_random(config.seed == 0 ? 1 : config.seed) {
+    m_transform = requireComponent<TransformComponent>("ParticleEmitter requires a TransformComponent");
+    m_config.workers = std::max(m_config.workers, 1u);
+
+    m_x.resize(m_config.capacity);
+    m_y.resize(m_config.capacity);
+    m_velocityX.resize(m_config.capacity);
+    m_velocityY.resize(m_config.capacity);
+    m_life.resize(m_config.capacity);
+    m_colours.resize(m_config.capacity);
+}
+
+ParticleEmitter::~ParticleEmitter() {
+    {
+        std::lock_guard lock(m_jobMutex);
+        m_stopping = true;
+    }
+    m_jobSignal.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t ParticleEmitter::startWorkers() noexcept {
+    while (!m_workersFailed && m_workers.size() + 1 < m_config.workers) {
+        try {
+            m_workers.emplace_back(&ParticleEmitter::workerLoop, this, m_workers.size());
+        } catch (const std::system_error& e) {
+            Log::warn("Could not start particle worker, carrying on with {}: {}", m_workers.size() + 1, e.what());
+            m_workersFailed = true;
+        }
+    }
+    return std::min<size_t>(m_workers.size() + 1, m_config.workers);
+}
+
+void ParticleEmitter::workerLoop(size_t index) noexcept {
+    uint64_t done = 0;
+    std::unique_lock lock(m_jobMutex);
+    while (true) {
+        m_jobSignal.wait(lock, [&] { return m_stopping || m_jobGeneration != done; });
+        if (m_stopping) {
+            return;
+        }
+        done = m_jobGeneration;
+        size_t begin = (index + 1) * m_jobChunk;
+        size_t end = std::min(begin + m_jobChunk, m_jobEnd);
+        float deltaT = m_jobDeltaT;
+        lock.unlock();
+
+        if (begin < end) {
+            integrate(begin, end, deltaT);
+        }
+
+        lock.lock();
+        if (--m_jobPending == 0) {
+            m_jobDone.notify_one();
+        }
+    }
+}
+
+void ParticleEmitter::tick(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    update(ctx->frames().deltaT());
+}
+
+void ParticleEmitter::update(float deltaT) noexcept {
+    size_t workers = m_count < s_parallelThreshold || m_config.workers <= 1 ? 1 : startWorkers();
+    if (workers == 1) {
+        integrate(0, m_count, deltaT);
+    } else {
+        // Ranges are multiples of four, so only the last one has a scalar tail
+        size_t chunk = ((m_count + workers - 1) / workers + 3) & ~size_t(3);
+        {
+            std::lock_guard lock(m_jobMutex);
+            m_jobChunk = chunk;
+            m_jobEnd = m_count;
+            m_jobDeltaT = deltaT;
+            m_jobPending = m_workers.size();
+            m_jobGeneration++;
+        }
+        m_jobSignal.notify_all();
+        integrate(0, std::min(chunk, m_count), deltaT);
+
+        std::unique_lock lock(m_jobMutex);
+        m_jobDone.wait(lock, [this] { return m_jobPending == 0; });
+    }
+    retireDead();
+
+    if (m_emitting) {
+        m_owed += m_config.rate * deltaT;
+        size_t due = static_cast<size_t>(m_owed);
+        m_owed -= static_cast<float>(due);
+        spawn(due);
+    }
+}
+
+void ParticleEmitter::setRate(float rate) {
+    if (!(rate >= 0.0f)) {
+        throw std::runtime_error(std::format("Particle rate must not be negative, got {}", rate));
+    }
+    m_config.rate = rate;
+}
+
+void ParticleEmitter::setLifetime(float lifetime) {
+    if (!(lifetime > 0.0f)) {
+        throw std::runtime_error(std::format("Particle lifetime must be positive, got {}", lifetime));
+    }
+    m_config.lifetime = lifetime;
+}
+
+void ParticleEmitter::setSpeed(float speed) {
+    if (!(speed >= 0.0f)) {
+        throw std::runtime_error(std::format("Particle speed must not be negative, got {}", speed));
+    }
+    m_config.speed = speed;
+}
+
+void ParticleEmitter::setSpread(float spread) {
+    if (!(spread >= 0.0f)) {
+        throw std::runtime_error(std::format("Particle spread must not be negative, got {}", spread));
+    }
+    m_config.spread = spread;
+}
+
+size_t ParticleEmitter::burst(size_t count) noexcept {
+    size_t spawned = std::min(count, m_config.capacity - m_count);
+    spawn(spawned);
+    return spawned;
+}
+
+void ParticleEmitter::integrate(size_t begin, size_t end, float deltaT) noexcept {
+    float* x = m_x.data();
+    float* y = m_y.data();
+    float* velocityX = m_velocityX.data();
+    float* velocityY = m_velocityY.data();
+    float* life = m_life.data();
+    float gravityX = m_config.gravity.x * deltaT;
+    float gravityY = m_config.gravity.y * deltaT;
+
+    size_t i = begin;
+#ifdef SDLGAME_PARTICLES_SSE
+    __m128 dt = _mm_set1_ps(deltaT);
+    __m128 gx = _mm_set1_ps(gravityX);
+    __m128 gy = _mm_set1_ps(gravityY);
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(velocityX + i), gx);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(velocityY + i), gy);
+        _mm_storeu_ps(velocityX + i, vx);
+        _mm_storeu_ps(velocityY + i, vy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+    }
+#endif
+    for (; i < end; i++) {
+        velocityX[i] += gravityX;
+        velocityY[i] += gravityY;
+        x[i] += velocityX[i] * deltaT;
+        y[i] += velocityY[i] * deltaT;
+        life[i] -= deltaT;
+    }
+}
+
+void ParticleEmitter::retireDead() noexcept {
+    size_t i = 0;
+#ifdef SDLGAME_PARTICLES_SSE
+    // Skip over runs of live particles four at a time, most of them are
+    __m128 zero = _mm_setzero_ps();
+    while (i + 4 <= m_count && _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(m_life.data() + i), zero)) == 0) {
+        i += 4;
+    }
+#endif
+    while (i < m_count) {
+        if (m_life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        // Order doesn't matter, so the last one takes its place rather than shifting everything down
+        size_t last = --m_count;
+        m_x[i] = m_x[last];
+        m_y[i] = m_y[last];
+        m_velocityX[i] = m_velocityX[last];
+        m_velocityY[i] = m_velocityY[last];
+        m_life[i] = m_life[last];
+        m_colours[i] = m_colours[last];
+    }
+}
+
+void ParticleEmitter::spawn(size_t count) noexcept {
+    count = std::min(count, m_config.capacity - m_count);
+    float baseAngle = std::atan2(m_config.direction.y, m_config.direction.x);
+    float halfSpread = m_config.spread * 0.5f;
+    glm::fvec3 origin = m_transform->worldPosition();
+    for (size_t n = 0; n < count; n++) {
+        size_t i = m_count++;
+        float angle = baseAngle + randomFloat(-halfSpread, halfSpread);
+        float speed = randomFloat(m_config.speed * 0.5f, m_config.speed);
+        m_x[i] = origin.x;
+        m_y[i] = origin.y;
+        m_velocityX[i] = std::cos(angle) * speed;
+        m_velocityY[i] = std::sin(angle) * speed;
+        m_life[i] = m_config.lifetime;
+        m_colours[i] = m_config.colour;
+    }
+}
+
+float ParticleEmitter::randomFloat(float min, float max) noexcept {
+    // xorshift32, see StressScreen
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return min + (max - min) * (m_random / 4294967296.0f);
+}
+
+void ParticleEmitter::appendTriangles(std::vector<float>& xy, std::vector<SDL_FColor>& colours) const {
+    size_t points = xy.size();
+    size_t vertices = colours.size();
+    xy.resize(points + m_count * 6);
+    colours.resize(vertices + m_count * 3);
+    float* outXY = xy.data() + points;
+    SDL_FColor* outColours = colours.data() + vertices;
+
+    float size = m_config.size;
+    float inverseLifetime = m_config.lifetime > 0.0f ? 1.0f / m_config.lifetime : 0.0f;
+    for (size_t i = 0; i < m_count; i++) {
+        float x = m_x[i];
+        float y = m_y[i];
+        outXY[0] = x;
+        outXY[1] = y;
+        outXY[2] = x + size;
+        outXY[3] = y;
+        outXY[4] = x;
+        outXY[5] = y + size;
+        outXY += 6;
+
+        SDL_FColor colour = m_colours[i];
+        colour.a *= std::min(m_life[i] * inverseLifetime, 1.0f);
+        outColours[0] = colour;
+        outColours[1] = colour;
+        outColours[2] = colour;
+        outColours += 3;
+    }
+}
+
+void ParticleEmitter::draw(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    if (m_count == 0) {
+        return;
+    }
+    m_scratchXY.clear();
+    m_scratchColours.clear();
+    appendTriangles(m_scratchXY, m_scratchColours);
+
+    SDL_Renderer& renderer = ctx->frames().renderer();
+    if (!SDL_RenderGeometryRaw(&renderer, nullptr, m_scratchXY.data(), sizeof(float) * 2, m_scratchColours.data(), sizeof(SDL_FColor),
+            nullptr, 0, static_cast<int>(m_scratchColours.size()), nullptr, 0, 0)) {
+        Log::error("Could not draw particles: {}", SDL_GetError());
+    }
+}
+
+void ParticleEmitter::capture(RenderSnapshot& snapshot) const noexcept {
+    appendTriangles(snapshot.triangleXY, snapshot.triangleColours);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <entities/components.h>
+#include <meta/processing.h>
+
+struct ParticleEmitterConfig {
+    /** Particles alive at once. Allocated up front, and never grown */
+    size_t capacity = 10000;
+    /** Spawned per unit of deltaT */
+    float rate = 100.0f;
+    /** In units of deltaT, like everything else here */
+    float lifetime = 60.0f;
+    /** Spawn speeds are uniform between half of this and all of it */
+    float speed = 2.0f;
+    glm::fvec2 direction = glm::fvec2(0.0f, -1.0f);
+    /** Radians around direction particles spread out over */
+    float spread = 0.5f;
+    glm::fvec2 gravity = glm::fvec2(0.0f, 0.0f);
+    /** Width of the triangle drawn per particle */
+    float size = 2.0f;
+    SDL_FColor colour = {1.0f, 1.0f, 1.0f, 1.0f};
+    /**
+     * Threads the update is split over, once there are enough particles to be worth it. 1 updates on the ticking thread only.
+     * The emitter starts workers - 1 threads of its own the first time they are needed, and keeps them until destroyed
+     */
+    unsigned workers = 1;
+    uint32_t seed = 1;
+};
+
+/**
+ * Lots of short lived particles, in world space, spawned at the world position of the TransformComponent.
+ * Particles are kept as parallel arrays rather than entities, updated four at a time with SSE where available,
+ * and dead ones are swapped with the last live one, so the arrays stay dense and never reallocate.
+ * All of them are drawn with a single SDL_RenderGeometryRaw call, alpha fading out over their lifetime.
+ */
+class ParticleEmitter : public IDependentEntityComponent, public ITickable, public IDrawable, public ISnapshotDrawable {
+public:
+    ParticleEmitter(ComponentRetriever compRet, ParticleEmitterConfig config);
+    ~ParticleEmitter();
+    ParticleEmitter(const ParticleEmitter&) = delete;
+    ParticleEmitter& operator=(const ParticleEmitter&) = delete;
+
+    void tick(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    void capture(RenderSnapshot& snapshot) const noexcept override;
+
+    /** Integrate, retire dead particles, then emit. What tick does with the frame's deltaT */
+    void update(float deltaT) noexcept;
+    /** Spawn up to count particles right away, on top of the continuous rate. Returns how many fit */
+    size_t burst(size_t count) noexcept;
+
+    /** Stops or resumes continuous emission, live particles carry on either way */
+    void setEmitting(bool emitting) noexcept { m_emitting = emitting; }
+    /** Capacity and workers size the emitter on construction, and are fixed from then on. See the setters for the rest */
+    const ParticleEmitterConfig& config() const noexcept { return m_config; }
+    /** Throws for negative rates */
+    void setRate(float rate);
+    /** Throws unless positive. Live particles keep the lifetime they were spawned with */
+    void setLifetime(float lifetime);
+    /** Throws for negative speeds */
+    void setSpeed(float speed);
+    /** Throws for negative spreads */
+    void setSpread(float spread);
+    void setDirection(glm::fvec2 direction) noexcept { m_config.direction = direction; }
+    void setGravity(glm::fvec2 gravity) noexcept { m_config.gravity = gravity; }
+    /** Only for particles spawned from now on */
+    void setColour(SDL_FColor colour) noexcept { m_config.colour = colour; }
+    size_t alive() const noexcept { return m_count; }
+    size_t capacity() const noexcept { return m_config.capacity; }
+
+    /** Appends three points and three colours per live particle */
+    void appendTriangles(std::vector<float>& xy, std::vector<SDL_FColor>& colours) const;
+
+private:
+    TransformComponent* m_transform;
+    ParticleEmitterConfig m_config;
+    bool m_emitting = true;
+    /** Fractional particles owed by the rate, carried into the next update */
+    float m_owed = 0.0f;
+    uint32_t m_random;
+
+    size_t m_count = 0;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_velocityX;
+    std::vector<float> m_velocityY;
+    std::vector<float> m_life;
+    std::vector<SDL_FColor> m_colours;
+
+    /** For draw, kept so immediate mode doesn't allocate every frame */
+    std::vector<float> m_scratchXY;
+    std::vector<SDL_FColor> m_scratchColours;
+
+    /** Below this, splitting over workers costs more than it saves */
+    static constexpr size_t s_parallelThreshold = 65536;
+
+    /** Worker i integrates the (i + 1)th chunk of each job, the ticking thread the first */
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobSignal;
+    std::condition_variable m_jobDone;
+    /** Bumped per job, workers run each one once */
+    uint64_t m_jobGeneration = 0;
+    size_t m_jobChunk = 0;
+    size_t m_jobEnd = 0;
+    float m_jobDeltaT = 0.0f;
+    size_t m_jobPending = 0;
+    bool m_stopping = false;
+    /** Set once starting a thread failed, the update stays on the ticking thread from then on */
+    bool m_workersFailed = false;
+
+    /** Returns how many threads, including the ticking one, can integrate */
+    size_t startWorkers() noexcept;
+    void workerLoop(size_t index) noexcept;
+
+    void integrate(size_t begin, size_t end, float deltaT) noexcept;
+    void retireDead() noexcept;
+    void spawn(size_t count) noexcept;
+    float randomFloat(float min, float max) noexcept;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <format>
+
+#include <meta/reflection.h>
+#include <meta/memoryStats.h>
+
+/** Type erased PlainComponentPool, for entities handing their records back */
+class IPlainComponentPool {
+public:
+    virtual ~IPlainComponentPool() = default;
+    virtual void release(uint32_t record) noexcept = 0;
+    virtual size_t recordSize() const noexcept = 0;
+};
+
+/** A plain component held by an entity, see IEntity */
+struct PlainComponentRef {
+    IPlainComponentPool* pool;
+    uint32_t record;
+};
+
+/**
+ * Every live T, stored by value in fixed size pages. Pages are never moved or freed, so pointers to records stay valid
+ * until released, and records acquired one after another sit next to each other, letting serialization and
+ * WorldSnapshot copy runs of them at once.
+ * Acquiring and releasing is thread safe, scenes may be loaded in the background. Reading records is not synchronized,
+ * each belongs to a single entity, and is as safe as reading any other component of it.
+ */
+template<PlainComponent T>
+class PlainComponentPool final : public IPlainComponentPool {
+public:
+    static constexpr size_t s_pageBytes = 16384;
+    static constexpr size_t s_recordsPerPage = std::max<size_t>(1, s_pageBytes / sizeof(T));
+    static constexpr size_t s_maxPages = 4096;
+
+    /** Never destroyed, entities with static storage duration may outlive it otherwise */
+    static PlainComponentPool& instance() {
+        static PlainComponentPool* pool = new PlainComponentPool();
+        return *pool;
+    }
+
+    /** Throws once s_maxPages are full */
+    uint32_t acquire(long long owner) {
+        std::lock_guard lock(m_mutex);
+        uint32_t record;
+        bool allocated = false;
+        if (!m_free.empty()) {
+            record = m_free.back();
+            m_free.pop_back();
+        } else {
+            size_t page = m_next / s_recordsPerPage;
+            if (page >= s_maxPages) {
+                throw std::runtime_error(std::format("Out of storage for plain component {}", TypeLayout<T>::name));
+            }
+            if (m_pages[page].load(std::memory_order_relaxed) == nullptr) {
+                m_pages[page].store(new Page(), std::memory_order_release);
+                allocated = true;
+            }
+            record = m_next++;
+        }
+        page(record).owners[record % s_recordsPerPage] = owner;
+        m_live.fetch_add(1, std::memory_order_relaxed);
+        MemoryAccounting::of<T>().onCreated(allocated);
+        return record;
+    }
+
+    void release(uint32_t record) noexcept override {
+        std::lock_guard lock(m_mutex);
+        page(record).owners[record % s_recordsPerPage] = -1;
+        m_free.push_back(record);
+        m_live.fetch_sub(1, std::memory_order_relaxed);
+        MemoryAccounting::of<T>().onDestroyed();
+    }
+
+    size_t recordSize() const noexcept override { return sizeof(T); }
+
+    T& at(uint32_t record) noexcept { return page(record).records[record % s_recordsPerPage]; }
+    size_t size() const noexcept { return m_live.load(std::memory_order_relaxed); }
+
+    /** Calls func(entityId, component) for every live record, in storage order. Not while records are acquired or released */
+    template<typename Func>
+    void forEach(Func&& func) {
+        for (uint32_t first = 0; first < m_next; first += s_recordsPerPage) {
+            Page& current = page(first);
+            size_t count = std::min<size_t>(s_recordsPerPage, m_next - first);
+            for (size_t i = 0; i < count; i++) {
+                if (current.owners[i] >= 0) {
+                    func(current.owners[i], current.records[i]);
+                }
+            }
+        }
+    }
+
+private:
+    struct Page {
+        T records[s_recordsPerPage];
+        /** Entity holding each record, -1 if free */
+        long long owners[s_recordsPerPage];
+    };
+
+    std::mutex m_mutex;
+    /** Published before any record in them is handed out, and only ever set once */
+    std::array<std::atomic<Page*>, s_maxPages> m_pages{};
+    std::vector<uint32_t> m_free;
+    uint32_t m_next = 0;
+    std::atomic<size_t> m_live = 0;
+
+    PlainComponentPool() = default;
+
+    Page& page(uint32_t record) const noexcept {
+        return *m_pages[record / s_recordsPerPage].load(std::memory_order_acquire);
+    }
+};
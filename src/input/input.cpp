@@ -1,124 +1,136 @@
 #include <SDL3/SDL.h>
-#include <functional>
-#include <map>
-#include <deque>
 #include <glm/vec2.hpp>
+#include <stdexcept>
 
 #include <input/input.h>
+#include <input/recording.h>
 
 InputManager::InputManager() {
-    m_keyStates = std::map<SDL_Scancode, InputState>();
-    m_keyTimeOfDown = std::map<SDL_Scancode, ms>();
+    m_clock = [] { return SDL_GetTicks(); };
     m_mousePosition = glm::vec2(0.0f, 0.0f);
     m_mouseDirection = glm::vec2(0.0f, 0.0f);
 }
 InputManager::~InputManager() { }
 
-bool InputManager::isDown(SDL_Scancode code) const {
-    auto state = m_keyStates.find(code);
-    return state != m_keyStates.end() && state->second == InputState::Down;
+void InputManager::setClock(InputClock clock) {
+    if (clock == nullptr) {
+        throw std::runtime_error("InputManager requires a valid clock");
+    }
+    m_clock = clock;
 }
 
-bool InputManager::isHeld(SDL_Scancode code) {
-    auto stateIter = m_keyStates.find(code);
-    //No check for Down here, as we reevaluate Down below
-    if (stateIter == m_keyStates.end() || stateIter->second == InputState::Up) {
-        return false;
-    } 
-    
-    if (stateIter->second == InputState::Held) {
-        return true;
-    }
+bool InputManager::isDown(SDL_Scancode code) const noexcept {
+    return m_keysDown.test(code);
+}
 
-    // Then it must be Down, and if so, reevalute threshold
-    ms now = SDL_GetTicks();
+bool InputManager::isHeld(SDL_Scancode code) const noexcept {
+    return hasBeenDownFor(code, m_heldStateThreshold);
+}
 
-    auto timeOfDownIter = m_keyTimeOfDown.find(code);
-    if (timeOfDownIter == m_keyTimeOfDown.end() || stateIter->second != InputState::Down) {
-        m_keyTimeOfDown[code] = now; //if somehow...
+bool InputManager::hasBeenDownFor(SDL_Scancode code, ms duration) const noexcept {
+    if (!m_keysDown.test(code)) {
         return false;
     }
+    return m_clock() - m_keyTimeOfDown[code] > duration;
+}
 
-    if (this->hasBeenDownFor(code, m_heldStateThreshold)) {
-        m_keyStates[code] = InputState::Held;
-        return true;
+InputState InputManager::state(SDL_Scancode code) const noexcept {
+    if (!isDown(code)) {
+        return InputState::Up;
     }
-
-    return false;
+    return isHeld(code) ? InputState::Held : InputState::Down;
 }
 
-bool InputManager::hasBeenDownFor(SDL_Scancode code, ms duration) {
-    auto state = m_keyStates.find(code);
-    if (state == m_keyStates.end() || state->second != InputState::Down) {
-        return false;
+bool InputManager::onEvent(SDL_Event* event) {
+    InputEvent converted;
+    if (!InputEvent::fromSDL(*event, m_clock(), converted)) {
+        return true;
     }
+    return queueEvent(converted);
+}
 
-    auto timeOfDown = m_keyTimeOfDown.find(code);
-    if (timeOfDown == m_keyTimeOfDown.end()) {
+bool InputManager::queueEvent(const InputEvent& event) {
+    if (!m_queuedEvents.tryPush(event)) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
-
-    return SDL_GetTicks() - timeOfDown->second > duration;
+    return true;
 }
 
-void InputManager::onEvent(SDL_Event* event) {
-    ms now = SDL_GetTicks();
-    auto timeOfDown = m_keyTimeOfDown.end();
+void InputManager::applyEvent(const InputEvent& event) {
+    SDL_Scancode code = event.scancode;
+    uint32_t buttonMask = event.button < 32 ? uint32_t(1) << event.button : 0;
 
-    switch (event->type) {
+    switch (event.type) {
     //KEYBOARD
-        case SDL_EVENT_KEY_DOWN:
-            m_keyStates[event->key.scancode] = InputState::Down;
-            timeOfDown = m_keyTimeOfDown.find(event->key.scancode);
-            if (timeOfDown != m_keyTimeOfDown.end()) {
-                m_keyTimeOfDown[event->key.scancode] = now;
+        case InputEventType::KeyDown:
+            // Repeats would reset the time of down, and a key never be concidered held
+            if (m_keysDown.test(code) || code < 0 || code >= SDL_SCANCODE_COUNT) {
+                break;
             }
+            m_keysDown.set(code);
+            m_pressedSinceTick.set(code);
+            m_keyTimeOfDown[code] = event.timestamp;
             break;
-        case SDL_EVENT_KEY_UP:
-            m_keyStates[event->key.scancode] = InputState::Up;
-            timeOfDown = m_keyTimeOfDown.find(event->key.scancode);
-            if (timeOfDown != m_keyTimeOfDown.end()) {
-                m_keyTimeOfDown.erase(event->key.scancode);
-            }
+        case InputEventType::KeyUp:
+            m_keysDown.reset(code);
+            m_releasedSinceTick.set(code);
             break;
-    
+
     //MOUSE
-        case SDL_EVENT_MOUSE_MOTION:
-            glm::vec2 prevPosition = glm::vec2(m_mousePosition);
-            glm::vec2 newPosition = glm::vec2(event->motion.x, event->motion.y);
-            m_mouseDirection = newPosition - prevPosition;
-            m_mousePosition = newPosition;
-            //TODO
+        case InputEventType::MouseDown:
+            m_mouseDown |= buttonMask;
+            m_mousePressedSinceTick |= buttonMask;
+            break;
+        case InputEventType::MouseUp:
+            m_mouseDown &= ~buttonMask;
+            m_mouseReleasedSinceTick |= buttonMask;
+            break;
+        case InputEventType::MouseMotion:
+            m_mouseDirection = event.position - m_mousePosition;
+            m_mousePosition = event.position;
+            break;
+        case InputEventType::MouseWheel:
+            m_mouseWheelSinceTick += event.position;
             break;
     }
-
-    this->trackEvent(event, now);
-}
-
-void InputManager::trackEvent(SDL_Event* event, ms now) {
-    TimeStampedInputEvent newEvent = {event->key.key, now};
-
-    // Add the new event to the front of the deque
-    m_eventTracker.push_front(newEvent);
-    // Clean up happens on Tick
 }
 
 void InputManager::onTickRisingEdge() {
-    ms now = SDL_GetTicks();
-
-    //Look through all entries that isDown
-    //If its surpassed m_heldStateThreshold, change it to isHeld
-    for (auto& [code, state] : m_keyStates) {
-        if (state == InputState::Down) {
-            auto timeOfDown = m_keyTimeOfDown.find(code);
-            if (timeOfDown != m_keyTimeOfDown.end() && now - timeOfDown->second > m_heldStateThreshold) {
-                m_keyStates[code] = InputState::Held;
-            }
+    m_tick++;
+    ms now = m_clock();
+
+    InputEvent event;
+    while (m_queuedEvents.tryPop(event)) {
+        if (m_recorder != nullptr) {
+            m_recorder->record(m_tick, event);
         }
+        applyEvent(event);
+        m_matcher.onEvent(event);
     }
 
-    // Cleanup old events
-    while (!m_eventTracker.empty() && (now - m_eventTracker.back().timestampOfInsertion > m_trackedDuration)) {
-        m_eventTracker.pop_back();
-    }
+    // Single pass over the keys that are actually down, to find those past m_heldStateThreshold
+    m_snapshot.m_held.clear();
+    m_keysDown.forEach([&](SDL_Scancode code) {
+        if (now - m_keyTimeOfDown[code] > m_heldStateThreshold) {
+            m_snapshot.m_held.set(code);
+        }
+    });
+
+    m_snapshot.m_down = m_keysDown;
+    m_snapshot.m_pressed = m_pressedSinceTick;
+    m_snapshot.m_released = m_releasedSinceTick;
+    m_snapshot.m_mouseDown = m_mouseDown;
+    m_snapshot.m_mousePressed = m_mousePressedSinceTick;
+    m_snapshot.m_mouseReleased = m_mouseReleasedSinceTick;
+    m_snapshot.m_mousePosition = m_mousePosition;
+    m_snapshot.m_mouseDirection = m_mouseDirection;
+    m_snapshot.m_mouseWheel = m_mouseWheelSinceTick;
+    m_snapshot.m_time = now;
+
+    m_pressedSinceTick.clear();
+    m_releasedSinceTick.clear();
+    m_mousePressedSinceTick = 0;
+    m_mouseReleasedSinceTick = 0;
+    m_mouseWheelSinceTick = glm::vec2(0.0f, 0.0f);
 }
@@ -2,17 +2,23 @@
 
 #include <SDL3/SDL.h>
 #include <memory>
-#include <deque>
-#include <map>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <glm/vec2.hpp>
 
+#include <input/matcher.h>
+#include <types/ringBuffer.h>
+
 using OnInputCallbackId = int;
 /** Milliseconds */
 using ms = uint64_t;
-typedef struct {
-    SDL_Keycode code;
-    ms timestampOfInsertion;
-} TimeStampedInputEvent;
+/** Source of all timestamps used by InputManager. SDL_GetTicks unless replaying */
+using InputClock = std::function<ms()>;
+
+/** Source input/recording.h */
+class InputRecorder;
 
 enum class InputState {
     Down,
@@ -20,31 +26,158 @@ enum class InputState {
     Up
 };
 
+/** Fixed size bitset indexed by scancode. Set bits are iterated a word at a time */
+class ScancodeSet {
+public:
+    bool test(SDL_Scancode code) const noexcept {
+        return inRange(code) && ((m_words[code >> 6] >> (code & 63)) & 1) != 0;
+    }
+    void set(SDL_Scancode code) noexcept {
+        if (inRange(code)) m_words[code >> 6] |= uint64_t(1) << (code & 63);
+    }
+    void reset(SDL_Scancode code) noexcept {
+        if (inRange(code)) m_words[code >> 6] &= ~(uint64_t(1) << (code & 63));
+    }
+    void clear() noexcept { m_words.fill(0); }
+    bool any() const noexcept {
+        for (uint64_t word : m_words) {
+            if (word != 0) return true;
+        }
+        return false;
+    }
+
+    /** Invoke func(SDL_Scancode) for every set scancode, in ascending order */
+    template<typename F>
+    void forEach(F&& func) const {
+        for (size_t i = 0; i < s_wordCount; i++) {
+            uint64_t word = m_words[i];
+            while (word != 0) {
+                int bit = std::countr_zero(word);
+                func(static_cast<SDL_Scancode>(i * 64 + bit));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t s_wordCount = (SDL_SCANCODE_COUNT + 63) / 64;
+    std::array<uint64_t, s_wordCount> m_words = {};
+
+    static bool inRange(SDL_Scancode code) noexcept {
+        return code >= 0 && code < SDL_SCANCODE_COUNT;
+    }
+};
+
+/**
+ * Input as of the start of the current tick. Holds no containers, so reading it never allocates,
+ * and every entity ticked sees the exact same state.
+ */
+class InputSnapshot {
+public:
+    /** Down or held */
+    bool isDown(SDL_Scancode code) const noexcept { return m_down.test(code); }
+    /** Down for longer than the held threshold */
+    bool isHeld(SDL_Scancode code) const noexcept { return m_held.test(code); }
+    /** Went down since the previous tick */
+    bool wasPressed(SDL_Scancode code) const noexcept { return m_pressed.test(code); }
+    /** Went up since the previous tick. A key tapped between two ticks is both pressed and released */
+    bool wasReleased(SDL_Scancode code) const noexcept { return m_released.test(code); }
+
+    /** button as in SDL_BUTTON_LEFT etc. */
+    bool isMouseDown(uint8_t button) const noexcept { return (m_mouseDown & mouseMask(button)) != 0; }
+    bool wasMousePressed(uint8_t button) const noexcept { return (m_mousePressed & mouseMask(button)) != 0; }
+    bool wasMouseReleased(uint8_t button) const noexcept { return (m_mouseReleased & mouseMask(button)) != 0; }
+
+    glm::vec2 mousePosition() const noexcept { return m_mousePosition; }
+    /** Not normalized */
+    glm::vec2 mouseDirection() const noexcept { return m_mouseDirection; }
+    /** Scrolled since the previous tick, positive y away from the user */
+    glm::vec2 mouseWheel() const noexcept { return m_mouseWheel; }
+    /** Time at which this snapshot was taken */
+    ms time() const noexcept { return m_time; }
+
+private:
+    friend class InputManager;
+
+    ScancodeSet m_down;
+    ScancodeSet m_held;
+    ScancodeSet m_pressed;
+    ScancodeSet m_released;
+    uint32_t m_mouseDown = 0;
+    uint32_t m_mousePressed = 0;
+    uint32_t m_mouseReleased = 0;
+    glm::vec2 m_mousePosition = glm::vec2(0.0f, 0.0f);
+    glm::vec2 m_mouseDirection = glm::vec2(0.0f, 0.0f);
+    glm::vec2 m_mouseWheel = glm::vec2(0.0f, 0.0f);
+    ms m_time = 0;
+
+    static uint32_t mouseMask(uint8_t button) noexcept { return button < 32 ? uint32_t(1) << button : 0; }
+};
+
 class InputManager {
 public:
     InputManager();
     ~InputManager();
 
-    void onEvent(SDL_Event* event);
+    /**
+     * Queue an event to be applied on the next tick. Lock free, and safe to call from one thread
+     * while another ticks. Returns false if the queue is full and the event was dropped.
+     */
+    bool onEvent(SDL_Event* event);
+    /** Same as onEvent, for events that don't originate from SDL. The timestamp is kept as is */
+    bool queueEvent(const InputEvent& event);
+    /** Applies all queued events in order, then updates the snapshot */
     void onTickRisingEdge();
-    /** Static check for key or mouse-button state */
-    bool isDown(SDL_Scancode code) const;
-    bool isHeld(SDL_Scancode code);
-    bool hasBeenDownFor(SDL_Scancode code, ms duration);
+    /** Static check for key state, down or held. Events are applied on tick, so this reflects state as of the last one */
+    bool isDown(SDL_Scancode code) const noexcept;
+    /** Down for longer than the held threshold */
+    bool isHeld(SDL_Scancode code) const noexcept;
+    bool hasBeenDownFor(SDL_Scancode code, ms duration) const noexcept;
+    InputState state(SDL_Scancode code) const noexcept;
+
+    /** Input as of the last onTickRisingEdge. Prefer this over the live queries above from within tick */
+    const InputSnapshot& snapshot() const noexcept { return m_snapshot; }
+    /** Chords and sequences are matched against events as they are applied on tick */
+    InputMatcher& matcher() noexcept { return m_matcher; }
+    /** Events dropped since startup because more than the queue capacity arrived between two ticks */
+    uint64_t droppedEvents() const noexcept { return m_droppedEvents.load(std::memory_order_relaxed); }
+
+    /** Number of ticks so far. Incremented at the start of onTickRisingEdge, so the first tick is 1 */
+    uint32_t tick() const noexcept { return m_tick; }
+    ms now() const { return m_clock(); }
+    /** Replace the clock, e.g. with a virtual one for deterministic replays. Only change it while no tick is in flight */
+    void setClock(InputClock clock);
+    /** Every event applied on tick is handed to the recorder, tagged with the tick number. nullptr to stop recording */
+    void setRecorder(InputRecorder* recorder) noexcept { m_recorder = recorder; }
 
 private:
-    std::map<SDL_Scancode, InputState> m_keyStates;
-    std::map<SDL_Scancode, ms> m_keyTimeOfDown;
-    /** All inputs for the last <m_trackedDuration> seconds, in order, most recent first */
-    std::deque<TimeStampedInputEvent> m_eventTracker;
-    const ms m_trackedDuration = 10000;
-    /** After how many milliseconds should a key be concidered "held" rather than "down" */ 
+    ScancodeSet m_keysDown;
+    /** Indexed by scancode, only meaningful while the key is down */
+    std::array<ms, SDL_SCANCODE_COUNT> m_keyTimeOfDown = {};
+    /** Edges accumulated from events since the last tick */
+    ScancodeSet m_pressedSinceTick;
+    ScancodeSet m_releasedSinceTick;
+    uint32_t m_mouseDown = 0;
+    uint32_t m_mousePressedSinceTick = 0;
+    uint32_t m_mouseReleasedSinceTick = 0;
+    glm::vec2 m_mouseWheelSinceTick = glm::vec2(0.0f, 0.0f);
+
+    InputSnapshot m_snapshot;
+
+    /** Events queued since the last tick. Producer is whoever calls onEvent, consumer is onTickRisingEdge */
+    SPSCRingBuffer<InputEvent, 1024> m_queuedEvents;
+    std::atomic<uint64_t> m_droppedEvents = 0;
+    InputMatcher m_matcher;
+    uint32_t m_tick = 0;
+    InputClock m_clock;
+    InputRecorder* m_recorder = nullptr;
+    /** After how many milliseconds should a key be concidered "held" rather than "down" */
     const ms m_heldStateThreshold = 200;
-    
+
     uint32_t m_nextCallbackId = 0;
     glm::vec2 m_mousePosition;
     /** Not normalized */
     glm::vec2 m_mouseDirection;
 
-    void trackEvent(SDL_Event* event, ms now);
+    void applyEvent(const InputEvent& event);
 };
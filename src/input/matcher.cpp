@@ -0,0 +1,234 @@
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include <input/matcher.h>
+
+bool InputEvent::fromSDL(const SDL_Event& event, ms timestamp, InputEvent& out) noexcept {
+    InputEvent result{};
+    result.timestamp = timestamp;
+    result.scancode = SDL_SCANCODE_UNKNOWN;
+
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            // Repeats are not presses, the key never went up
+            if (event.key.repeat) {
+                return false;
+            }
+            result.type = event.type == SDL_EVENT_KEY_DOWN ? InputEventType::KeyDown : InputEventType::KeyUp;
+            result.scancode = event.key.scancode;
+            result.key = event.key.key;
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            result.type = event.type == SDL_EVENT_MOUSE_BUTTON_DOWN ? InputEventType::MouseDown : InputEventType::MouseUp;
+            result.button = event.button.button;
+            result.position = glm::vec2(event.button.x, event.button.y);
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            result.type = InputEventType::MouseMotion;
+            result.position = glm::vec2(event.motion.x, event.motion.y);
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            result.type = InputEventType::MouseWheel;
+            result.position = glm::vec2(event.wheel.x, event.wheel.y);
+            break;
+        default:
+            return false;
+    }
+
+    out = result;
+    return true;
+}
+
+bool InputTrigger::matchesPress(const InputEvent& event) const noexcept {
+    if (isMouse) {
+        return event.type == InputEventType::MouseDown && event.button == button;
+    }
+    return event.type == InputEventType::KeyDown && event.scancode == scancode;
+}
+
+bool InputTrigger::matchesRelease(const InputEvent& event) const noexcept {
+    if (isMouse) {
+        return event.type == InputEventType::MouseUp && event.button == button;
+    }
+    return event.type == InputEventType::KeyUp && event.scancode == scancode;
+}
+
+InputPatternId InputMatcher::addChord(std::vector<InputTrigger> triggers, ms window, OnPatternCallback callback) {
+    Chord chord;
+    chord.id = m_nextId++;
+    chord.window = window;
+    chord.callback = callback;
+    chord.down = std::vector<bool>(triggers.size(), false);
+    chord.timeOfDown = std::vector<ms>(triggers.size(), 0);
+    chord.triggers = std::move(triggers);
+
+    InputPatternId id = chord.id;
+    (m_dispatching ? m_pendingChords : m_chords).push_back(std::move(chord));
+    return id;
+}
+
+InputPatternId InputMatcher::addSequence(std::vector<InputTrigger> steps, ms maxGap, OnPatternCallback callback) {
+    if (steps.empty()) {
+        throw std::runtime_error("An input sequence requires at least one step");
+    }
+
+    Sequence sequence;
+    sequence.id = m_nextId++;
+    sequence.maxGap = maxGap;
+    sequence.callback = callback;
+    // At most one partial match per step can be alive, so this is all the space matching will ever need
+    sequence.active.reserve(steps.size() + 1);
+    sequence.next.reserve(steps.size() + 1);
+    sequence.steps = std::move(steps);
+
+    InputPatternId id = sequence.id;
+    (m_dispatching ? m_pendingSequences : m_sequences).push_back(std::move(sequence));
+    return id;
+}
+
+InputPatternId InputMatcher::addDoubleTap(InputTrigger trigger, ms maxGap, OnPatternCallback callback) {
+    return addSequence({trigger, trigger}, maxGap, callback);
+}
+
+bool InputMatcher::remove(InputPatternId id) {
+    bool found = false;
+    for (Chord& chord : m_chords) {
+        if (chord.id == id && !chord.removed) {
+            chord.removed = true;
+            found = true;
+        }
+    }
+    for (Sequence& sequence : m_sequences) {
+        if (sequence.id == id && !sequence.removed) {
+            sequence.removed = true;
+            found = true;
+        }
+    }
+    for (Chord& chord : m_pendingChords) {
+        if (chord.id == id && !chord.removed) {
+            chord.removed = true;
+            found = true;
+        }
+    }
+    for (Sequence& sequence : m_pendingSequences) {
+        if (sequence.id == id && !sequence.removed) {
+            sequence.removed = true;
+            found = true;
+        }
+    }
+
+    if (!m_dispatching) {
+        applyPendingChanges();
+    }
+    return found;
+}
+
+void InputMatcher::onEvent(const InputEvent& event) {
+    bool isPress = event.type == InputEventType::KeyDown || event.type == InputEventType::MouseDown;
+    bool isRelease = event.type == InputEventType::KeyUp || event.type == InputEventType::MouseUp;
+    if (!isPress && !isRelease) {
+        return;
+    }
+
+    m_dispatching = true;
+    for (Chord& chord : m_chords) {
+        if (!chord.removed) {
+            onChordEvent(chord, event);
+        }
+    }
+    if (isPress) {
+        for (Sequence& sequence : m_sequences) {
+            if (!sequence.removed) {
+                onSequencePress(sequence, event);
+            }
+        }
+    }
+    m_dispatching = false;
+
+    applyPendingChanges();
+}
+
+void InputMatcher::reset() noexcept {
+    for (Chord& chord : m_chords) {
+        std::fill(chord.down.begin(), chord.down.end(), false);
+        chord.fired = false;
+    }
+    for (Sequence& sequence : m_sequences) {
+        sequence.active.clear();
+    }
+}
+
+void InputMatcher::onChordEvent(Chord& chord, const InputEvent& event) {
+    bool pressed = false;
+    for (size_t i = 0; i < chord.triggers.size(); i++) {
+        if (chord.triggers[i].matchesPress(event)) {
+            chord.down[i] = true;
+            chord.timeOfDown[i] = event.timestamp;
+            pressed = true;
+        } else if (chord.triggers[i].matchesRelease(event)) {
+            chord.down[i] = false;
+            chord.fired = false;
+        }
+    }
+    if (!pressed || chord.fired) {
+        return;
+    }
+
+    ms first = event.timestamp;
+    ms last = 0;
+    for (size_t i = 0; i < chord.triggers.size(); i++) {
+        if (!chord.down[i]) {
+            return;
+        }
+        first = std::min(first, chord.timeOfDown[i]);
+        last = std::max(last, chord.timeOfDown[i]);
+    }
+    if (last - first > chord.window) {
+        return;
+    }
+
+    chord.fired = true;
+    chord.callback(chord.id, event.timestamp);
+}
+
+void InputMatcher::onSequencePress(Sequence& sequence, const InputEvent& event) {
+    sequence.next.clear();
+    bool completed = false;
+
+    // Advance every partial match this press continues. Any partial match it doesn't continue is broken
+    for (const Progress& progress : sequence.active) {
+        if (event.timestamp - progress.lastStep <= sequence.maxGap && sequence.steps[progress.nextStep].matchesPress(event)) {
+            sequence.next.push_back(Progress{progress.nextStep + 1, event.timestamp});
+            completed |= progress.nextStep + 1 == sequence.steps.size();
+        }
+    }
+    // Every press of the first step might be the start of a new match
+    if (sequence.steps[0].matchesPress(event)) {
+        sequence.next.push_back(Progress{1, event.timestamp});
+        completed |= sequence.steps.size() == 1;
+    }
+
+    if (completed) {
+        sequence.active.clear();
+        sequence.callback(sequence.id, event.timestamp);
+        return;
+    }
+    std::swap(sequence.active, sequence.next);
+}
+
+void InputMatcher::applyPendingChanges() {
+    for (Chord& chord : m_pendingChords) {
+        m_chords.push_back(std::move(chord));
+    }
+    m_pendingChords.clear();
+    for (Sequence& sequence : m_pendingSequences) {
+        m_sequences.push_back(std::move(sequence));
+    }
+    m_pendingSequences.clear();
+
+    std::erase_if(m_chords, [](const Chord& chord) { return chord.removed; });
+    std::erase_if(m_sequences, [](const Sequence& sequence) { return sequence.removed; });
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+/** Milliseconds */
+using ms = uint64_t;
+
+enum class InputEventType : uint8_t {
+    KeyDown,
+    KeyUp,
+    MouseDown,
+    MouseUp,
+    MouseMotion,
+    MouseWheel
+};
+
+/** Compact, trivially copyable copy of the SDL events input cares about */
+struct InputEvent {
+    InputEventType type;
+    /** Mouse button, as in SDL_BUTTON_LEFT etc. Only set for MouseDown and MouseUp */
+    uint8_t button;
+    /** Only set for KeyDown and KeyUp */
+    SDL_Scancode scancode;
+    SDL_Keycode key;
+    /** Cursor position for mouse events, or scroll amount for MouseWheel */
+    glm::vec2 position;
+    ms timestamp;
+
+    /** Returns false if the event isn't an input event or is a key repeat, in which case out is left untouched */
+    static bool fromSDL(const SDL_Event& event, ms timestamp, InputEvent& out) noexcept;
+};
+
+/** A key or mouse button going down */
+struct InputTrigger {
+    bool isMouse;
+    SDL_Scancode scancode;
+    uint8_t button;
+
+    static InputTrigger key(SDL_Scancode scancode) noexcept { return InputTrigger{false, scancode, 0}; }
+    static InputTrigger mouse(uint8_t button) noexcept { return InputTrigger{true, SDL_SCANCODE_UNKNOWN, button}; }
+
+    bool matchesPress(const InputEvent& event) const noexcept;
+    bool matchesRelease(const InputEvent& event) const noexcept;
+};
+
+using InputPatternId = int;
+/** Invoked with the pattern matched, and the timestamp of the event completing it */
+using OnPatternCallback = std::function<void(InputPatternId id, ms timestamp)>;
+
+/**
+ * Detects chords and timed sequences (combos, double taps) as events arrive.
+ * Each pattern keeps just enough state to continue from where the last event left it, so history is never rescanned.
+ */
+class InputMatcher {
+public:
+    InputMatcher() = default;
+
+    /** All triggers down at once, with the first and last of them pressed no more than window apart */
+    InputPatternId addChord(std::vector<InputTrigger> triggers, ms window, OnPatternCallback callback);
+    /** Triggers pressed in order, each no more than maxGap after the previous. Any other press in between breaks the sequence */
+    InputPatternId addSequence(std::vector<InputTrigger> steps, ms maxGap, OnPatternCallback callback);
+    InputPatternId addDoubleTap(InputTrigger trigger, ms maxGap, OnPatternCallback callback);
+    /** Returns false if no such pattern exists */
+    bool remove(InputPatternId id);
+
+    void onEvent(const InputEvent& event);
+    /** Forget all partial progress, patterns are kept */
+    void reset() noexcept;
+
+private:
+    struct Chord {
+        InputPatternId id;
+        std::vector<InputTrigger> triggers;
+        ms window;
+        OnPatternCallback callback;
+        std::vector<bool> down;
+        std::vector<ms> timeOfDown;
+        /** Only fire once per press of the chord */
+        bool fired = false;
+        bool removed = false;
+    };
+
+    /** A partially matched sequence: the next step expected, and when the last one happened */
+    struct Progress {
+        size_t nextStep;
+        ms lastStep;
+    };
+
+    struct Sequence {
+        InputPatternId id;
+        std::vector<InputTrigger> steps;
+        ms maxGap;
+        OnPatternCallback callback;
+        /** Several partial matches may be alive at once, e.g. A A B after A A A. Reserved up front */
+        std::vector<Progress> active;
+        std::vector<Progress> next;
+        bool removed = false;
+    };
+
+    std::vector<Chord> m_chords;
+    std::vector<Sequence> m_sequences;
+    InputPatternId m_nextId = 0;
+
+    /** Callbacks may add or remove patterns. While dispatching, those changes are deferred until the event is done */
+    bool m_dispatching = false;
+    std::vector<Chord> m_pendingChords;
+    std::vector<Sequence> m_pendingSequences;
+
+    void applyPendingChanges();
+
+    void onChordEvent(Chord& chord, const InputEvent& event);
+    void onSequencePress(Sequence& sequence, const InputEvent& event);
+};
@@ -0,0 +1,114 @@
+#include <SDL3/SDL.h>
+#include <cstring>
+#include <stdexcept>
+#include <format>
+
+#include <input/recording.h>
+#include <input/input.h>
+
+static const char s_magic[4] = {'S', 'G', 'I', 'R'};
+static const uint16_t s_version = 2;
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const char* path, uint32_t tickRate) {
+    close();
+    m_file = std::fopen(path, "wb");
+    if (m_file == nullptr) {
+        return false;
+    }
+
+    InputRecordingHeader header{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.recordSize = sizeof(InputRecord);
+    header.tickRate = tickRate;
+    std::fwrite(&header, sizeof(header), 1, m_file);
+    m_recorded = 0;
+    return true;
+}
+
+void InputRecorder::record(uint32_t tick, const InputEvent& event) noexcept {
+    if (m_file == nullptr) {
+        return;
+    }
+    InputRecord record{
+        tick,
+        static_cast<uint8_t>(event.type),
+        event.button,
+        static_cast<uint16_t>(event.scancode),
+        static_cast<uint32_t>(event.key),
+        event.position.x,
+        event.position.y
+    };
+    // Stdio buffers these, so this is a memcpy most of the time
+    std::fwrite(&record, sizeof(record), 1, m_file);
+    m_recorded++;
+}
+
+void InputRecorder::close() noexcept {
+    if (m_file != nullptr) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void InputReplay::load(const char* path) {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        throw std::runtime_error(std::format("Could not open input recording: {}", path));
+    }
+
+    InputRecordingHeader header{};
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1
+        && std::memcmp(header.magic, s_magic, sizeof(s_magic)) == 0
+        && header.version == s_version
+        && header.recordSize == sizeof(InputRecord)
+        && header.tickRate > 0;
+    if (!valid) {
+        std::fclose(file);
+        throw std::runtime_error(std::format("Not a valid input recording: {}", path));
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, sizeof(header), SEEK_SET);
+    size_t count = (size - sizeof(header)) / sizeof(InputRecord);
+
+    m_records.resize(count);
+    size_t read = std::fread(m_records.data(), sizeof(InputRecord), count, file);
+    std::fclose(file);
+    // A recording cut short by a crash is still useful, keep what is complete
+    m_records.resize(read);
+    m_tickRate = header.tickRate;
+    m_next = 0;
+}
+
+void InputReplay::attach(InputManager& input) const {
+    input.setClock([this, &input]() { return clockAt(input.tick()); });
+}
+
+void InputReplay::feed(uint32_t tick, InputManager& input) {
+    ms timestamp = clockAt(tick);
+    while (m_next < m_records.size() && m_records[m_next].tick <= tick) {
+        const InputRecord& record = m_records[m_next++];
+        InputEvent event{};
+        event.type = static_cast<InputEventType>(record.type);
+        event.button = record.button;
+        event.scancode = static_cast<SDL_Scancode>(record.scancode);
+        event.key = static_cast<SDL_Keycode>(record.key);
+        event.position = glm::vec2(record.x, record.y);
+        event.timestamp = timestamp;
+        input.queueEvent(event);
+    }
+}
+
+uint32_t InputReplay::lastTick() const noexcept {
+    return m_records.empty() ? 0 : m_records.back().tick;
+}
+
+ms InputReplay::clockAt(uint32_t tick) const noexcept {
+    return static_cast<ms>(tick) * 1000 / m_tickRate;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#include <input/matcher.h>
+
+/** Source input/input.h */
+class InputManager;
+
+/**
+ * On disk layout of a recorded event. Little endian, as every platform we ship on is.
+ * Files start with an InputRecordingHeader, followed by records ordered by tick.
+ */
+struct InputRecordingHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+    /** Ticks per second the recording was made at, replays run their virtual clock at this rate */
+    uint32_t tickRate;
+};
+
+struct InputRecord {
+    uint32_t tick;
+    uint8_t type;
+    uint8_t button;
+    uint16_t scancode;
+    /** Keycode the scancode mapped to under the layout active while recording, replays don't map it again */
+    uint32_t key;
+    float x;
+    float y;
+};
+static_assert(sizeof(InputRecordingHeader) == 12, "InputRecordingHeader is written as is, and must not contain padding");
+static_assert(sizeof(InputRecord) == 20, "InputRecord is written as is, and must not contain padding");
+
+/** Appends every event InputManager applies to a file, tagged with the tick it was applied on */
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    /** Truncates the file and writes the header. Returns false if the file could not be opened */
+    bool open(const char* path, uint32_t tickRate = 60);
+    void record(uint32_t tick, const InputEvent& event) noexcept;
+    /** Flushes and closes. Also done on destruction */
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return m_file != nullptr; }
+    size_t recordedEvents() const noexcept { return m_recorded; }
+
+private:
+    FILE* m_file = nullptr;
+    size_t m_recorded = 0;
+};
+
+/**
+ * Feeds a recording back through InputManager on a virtual clock, where tick N is always at the same time.
+ * Two replays of the same recording are identical down to the tick, regardless of how fast either ran.
+ */
+class InputReplay {
+public:
+    InputReplay() = default;
+
+    /** Reads the entire recording into memory. Throws if the file is missing or malformed */
+    void load(const char* path);
+
+    /** Replace the clock of input with the virtual one of this replay. The replay must outlive input, or the clock be replaced again */
+    void attach(InputManager& input) const;
+    /** Queue all events recorded for the given tick. Call right before that tick runs */
+    void feed(uint32_t tick, InputManager& input);
+    /** Whether all events have been fed */
+    bool finished() const noexcept { return m_next >= m_records.size(); }
+    /** The tick of the last recorded event */
+    uint32_t lastTick() const noexcept;
+    uint32_t tickRate() const noexcept { return m_tickRate; }
+    ms clockAt(uint32_t tick) const noexcept;
+
+private:
+    std::vector<InputRecord> m_records;
+    size_t m_next = 0;
+    uint32_t m_tickRate = 60;
+};
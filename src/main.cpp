@@ -3,31 +3,172 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 #include <glm/glm.hpp>
 
 /* Internal Dependencies */
 #include <meta/ApplicationContext.h>
+#include <meta/pipeline.h>
+#include <input/recording.h>
 #include <scene/scene.h>
+#include <scene/sceneManager.h>
 #include <scene/TestScreen.cpp>
+#include <scene/StressScreen.h>
+#include <scene/tickScheduler.h>
+#include <meta/memoryStats.h>
+#include <meta/log.h>
 
 #define DEBUG_MODE 1
 
 /** Initialized on SDL_AppInit */
 static std::shared_ptr<ApplicationContext> ctx;
+/** Initialized on SDL_AppInit, after ctx */
+static std::unique_ptr<FramePipeline> pipeline;
+/** Set by --record <path> */
+static std::unique_ptr<InputRecorder> recorder;
+/** Set by --replay <path>. Replaces all live input, and exits once the recording is exhausted */
+static std::unique_ptr<InputReplay> replay;
+/** Set by --headless. Hidden window, nothing is drawn */
+static bool headless = false;
+/** Wall clock at the first replayed tick, see FrameStatistics::now() */
+static double replayStart = 0.0;
+/** Set by --stress <entities>. Replaces TestScreen. Set once it finished loading */
+static StressScreen* stress = nullptr;
+/** The first scene is built on a loader thread. Until it is in place, frames only draw the LoadingScreen and nothing ticks */
+static bool loadingFirstScene = true;
+/** Set by --ticks <n>. Exit after this many ticks, 0 to run until closed */
+static uint32_t tickLimit = 0;
+/** Set by --min-tps <n>. Exit with failure if fewer ticks per second than this were reached */
+static double minTicksPerSecond = 0.0;
+/** Wall clock at the first tick of a --ticks run */
+static double runStart = 0.0;
+/** Set by --frames-csv <path>. Frame timings of the last window are written there on exit, F5 writes them at any time */
+static const char* framesCsvPath = "frames.csv";
+static bool framesCsvOnExit = false;
+
+static void exportFrames() {
+    if (ctx->frames().statistics().exportCsv(framesCsvPath)) {
+        Log::info("Frame timings written to {}", framesCsvPath);
+    } else {
+        Log::error("Couldn't write frame timings to {}", framesCsvPath);
+    }
+}
+
+/** Logs replay throughput, the reason to replay in the first place */
+static void reportReplay() {
+    const RollingHistogram& ticks = ctx->frames().statistics().tickTimes();
+    double elapsed = FrameStatistics::now() - replayStart;
+    uint32_t tickCount = ctx->input().tick();
+    Log::info(
+        "Replay finished: {} ticks in {:.1f}ms ({:.1f} ticks/s). Tick p50 {:.2f}ms p95 {:.2f}ms p99 {:.2f}ms max {:.2f}ms",
+        tickCount, elapsed, elapsed > 0.0 ? tickCount * 1000.0 / elapsed : 0.0,
+        ticks.percentile(0.50), ticks.percentile(0.95), ticks.percentile(0.99), ticks.max()
+    );
+    MemoryAccounting::log();
+}
+
+/** Logs throughput of a --ticks run, and whether it met --min-tps */
+static bool reportRun() {
+    double elapsed = FrameStatistics::now() - runStart;
+    uint32_t tickCount = ctx->input().tick();
+    double ticksPerSecond = elapsed > 0.0 ? tickCount * 1000.0 / elapsed : 0.0;
+    const RollingHistogram& ticks = ctx->frames().statistics().tickTimes();
+    Log::info(
+        "Ran {} ticks in {:.1f}ms ({:.1f} ticks/s). Tick p50 {:.2f}ms p95 {:.2f}ms max {:.2f}ms. Peak memory {:.1f} MiB",
+        tickCount, elapsed, ticksPerSecond,
+        ticks.percentile(0.50), ticks.percentile(0.95), ticks.max(),
+        peakResidentBytes() / (1024.0 * 1024.0)
+    );
+
+    if (stress != nullptr) {
+        const char* names[] = {"entities", "collisions", "events"};
+        for (size_t i = 0; i < static_cast<size_t>(StressStage::Count); i++) {
+            const RollingHistogram& stage = stress->stageTimes(static_cast<StressStage>(i));
+            Log::info("Stage {:<10} p50 {:.2f}ms p95 {:.2f}ms max {:.2f}ms",
+                names[i], stage.percentile(0.50), stage.percentile(0.95), stage.max());
+        }
+        if (stress->scheduler() != nullptr) {
+            Log::info("Tick LOD: {} of {} entities ticked last frame, {} deferred",
+                stress->scheduler()->tickedLastFrame(), stress->scheduler()->size(), stress->scheduler()->deferredLastFrame());
+        }
+        SceneMemory memory = stress->memory();
+        Log::info("Scene: {} entities ({:.1f} KiB, peak {} / {:.1f} KiB), {} components ({:.1f} KiB), {} allocations last frame",
+            memory.entities, memory.entityBytes / 1024.0, memory.peakEntities, memory.peakEntityBytes / 1024.0,
+            memory.components, memory.componentBytes / 1024.0, memory.allocationsLastFrame);
+    }
+    MemoryAccounting::log();
+
+    if (minTicksPerSecond > 0.0 && ticksPerSecond < minTicksPerSecond) {
+        Log::error("Throughput regressed: {:.1f} ticks/s, expected at least {:.1f}", ticksPerSecond, minTicksPerSecond);
+        return false;
+    }
+    return true;
+}
 
 /* This function runs once per frame, and is the heart of the program. */
 SDL_AppResult SDL_AppIterate(void* comeOnGuysGenericsExist)
 {
-    ctx->onTick();
-    
-    ctx->onDrawCallRisingEdge();
+    if (loadingFirstScene) {
+        // Nothing ticks meanwhile, so runs, recordings and replays all start counting on the loaded scene
+        ctx->onDrawCallRisingEdge();
+        if (ctx->scenes().isLoading()) {
+            if (!headless) {
+                ctx->onDraw();
+                SDL_RenderPresent(&ctx->frames().renderer());
+            }
+            return SDL_APP_CONTINUE;
+        }
+        if (dynamic_cast<LoadingScreen*>(ctx->currentScene()) != nullptr) {
+            Log::critical("The first scene failed to load");
+            return SDL_APP_FAILURE;
+        }
+        loadingFirstScene = false;
+        stress = dynamic_cast<StressScreen*>(ctx->currentScene());
+        runStart = FrameStatistics::now();
+    }
+
+    if (tickLimit > 0) {
+        // The tick count of InputManager belongs to the pipeline worker while a tick is in flight.
+        // Nothing ticked while loading, so every tick started counts towards the run
+        if (pipeline->ticksStarted() >= tickLimit) {
+            // Waits for the tick in flight, everything below is safe to read from here on
+            pipeline->setPipelined(false);
+            return reportRun() ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+        }
+    }
+
+    if (replay != nullptr) {
+        uint32_t nextTick = ctx->input().tick() + 1;
+        if (nextTick == 1) {
+            replayStart = FrameStatistics::now();
+        }
+        if (replay->finished() && nextTick > replay->lastTick()) {
+            reportReplay();
+            return SDL_APP_SUCCESS;
+        }
+        replay->feed(nextTick, ctx->input());
+    }
+
+    // Ticks the next frame on the pipeline worker, while this one is drawn below
+    const RenderSnapshot* snapshot = pipeline->beginFrame();
+    if (headless) {
+        return SDL_APP_CONTINUE;
+    }
 
     SDL_Renderer& renderer = ctx->frames().renderer();
 
     SDL_SetRenderDrawColor(&renderer, 255, 0, 0, 255);
     SDL_RenderClear(&renderer);
 
-    ctx->onDraw();
+    double drawStart = FrameStatistics::now();
+    if (snapshot != nullptr) {
+        snapshot->draw(renderer, ctx->frames().tileChunks());
+    } else {
+        ctx->onDraw();
+    }
+    ctx->frames().statistics().recordDraw(FrameStatistics::now() - drawStart);
+    ctx->frames().statistics().drawOverlay(renderer);
 
     SDL_RenderPresent(&renderer);
     return SDL_APP_CONTINUE;  /* carry on with the program! */
@@ -43,17 +184,37 @@ SDL_AppResult SDL_AppEvent(void* comeOnGuysGenericsExist, SDL_Event* event)
     // Force shutdown
     // Check if Ctrl + W is held down
     if (event->type == SDL_EVENT_KEY_DOWN) {
+        // Frame time overlay
+        if (event->key.scancode == SDL_SCANCODE_F3 && !event->key.repeat) {
+            FrameStatistics& statistics = ctx->frames().statistics();
+            statistics.setOverlayVisible(!statistics.isOverlayVisible());
+        }
+        // Memory per component type, to the log
+        if (event->key.scancode == SDL_SCANCODE_F4 && !event->key.repeat) {
+            MemoryAccounting::log();
+        }
+        // Frame timings of the last window, to a file
+        if (event->key.scancode == SDL_SCANCODE_F5 && !event->key.repeat) {
+            exportFrames();
+        }
+
         SDL_Keymod modState = SDL_GetModState();
         if (modState & SDL_KMOD_CTRL) {
             // Check if the 'W' key was pressed
             if (event->key.key == SDLK_W) {
-                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Ctrl + W pressed. Exiting application.");
+                Log::info("Ctrl + W pressed. Exiting application.");
                 return SDL_APP_SUCCESS;  // Results in exit code 0 (success)
             }
         }
     }
 
-    ctx->input().onEvent(event);
+    // Replays must not be contaminated by whatever the keyboard is doing meanwhile
+    if (replay != nullptr) {
+        return SDL_APP_CONTINUE;
+    }
+
+    // Applied by whichever tick runs next
+    pipeline->queueEvent(*event);
     
     return SDL_APP_CONTINUE;
 }
@@ -61,27 +222,61 @@ SDL_AppResult SDL_AppEvent(void* comeOnGuysGenericsExist, SDL_Event* event)
 SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
 {
     SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LogPriority::SDL_LOG_PRIORITY_TRACE);
+    // Formatted and written on a thread of its own from here on, see Log
+    Log::start();
 
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Game starting up!");
-    SDL_LogTrace(SDL_LOG_CATEGORY_APPLICATION, "Initializing app metadata...");
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    size_t stressEntities = 0;
+    bool tickLod = false;
+    double hitchFactor = 2.0;
+    double hitchMinimumMs = 1000.0 / 30.0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--stress") == 0 && i + 1 < argc) {
+            stressEntities = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--lod") == 0) {
+            tickLod = true;
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            tickLimit = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--min-tps") == 0 && i + 1 < argc) {
+            minTicksPerSecond = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--hitch") == 0 && i + 2 < argc) {
+            hitchFactor = std::strtod(argv[++i], nullptr);
+            hitchMinimumMs = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--frames-csv") == 0 && i + 1 < argc) {
+            framesCsvPath = argv[++i];
+            framesCsvOnExit = true;
+        } else {
+            Log::warn("Unknown argument: {}", argv[i]);
+        }
+    }
+
+    Log::info("Game starting up!");
+    Log::trace("Initializing app metadata...");
     if(!SDL_SetAppMetadata("SDL Game", "0.1", "gbw.games.sdlgame")) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Couldn't set app metadata: %s", SDL_GetError());
+        Log::critical("Couldn't set app metadata: {}", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
-    SDL_LogTrace(SDL_LOG_CATEGORY_APPLICATION, "Initializing Video subsystem...");
+    Log::trace("Initializing Video subsystem...");
     if (!SDL_Init(SDL_INIT_VIDEO)) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s", SDL_GetError());
+        Log::critical("Couldn't initialize SDL: {}", SDL_GetError());
         return SDL_APP_FAILURE;
     }
     
-    SDL_LogTrace(SDL_LOG_CATEGORY_APPLICATION, "Getting primary display...");
+    Log::trace("Getting primary display...");
     SDL_DisplayID displayID = SDL_GetPrimaryDisplay();  
     SDL_Rect displayBounds;
 
-    SDL_LogTrace(SDL_LOG_CATEGORY_APPLICATION, "Loading display information...");
+    Log::trace("Loading display information...");
     if (!SDL_GetDisplayUsableBounds(displayID, &displayBounds)){
-        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Couldn't get display bounds: %s", SDL_GetError());
+        Log::critical("Couldn't get display bounds: {}", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
@@ -91,23 +286,67 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
         SDL_WINDOW_OPENGL |
         SDL_WINDOW_HIGH_PIXEL_DENSITY |
         SDL_WINDOW_TRANSPARENT;
+    if (headless) {
+        windowFlags = SDL_WINDOW_HIDDEN;
+    }
 
     SDL_Window* window;
     SDL_Renderer* renderer;
 
-    SDL_LogTrace(SDL_LOG_CATEGORY_APPLICATION, "Initializing window and renderer...");
+    Log::trace("Initializing window and renderer...");
     if (!SDL_CreateWindowAndRenderer("SDL Game", 800, 600, windowFlags, &window, &renderer)) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create window/renderer: %s", SDL_GetError());
+        Log::critical("Couldn't create window/renderer: {}", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
     glm::fvec2 displaySize = glm::fvec2(displayBounds.w, displayBounds.h);
-    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Display bounds: %.1f %.1f", displaySize.x, displaySize.y);
+    Log::debug("Display bounds: {:.1f} {:.1f}", displaySize.x, displaySize.y);
 
     ctx = ApplicationContext::create(
         &displaySize,windowFlags,window,renderer
     );    
-    ctx->changeScene(new TestScreen(ctx));
+    // Built on a loader thread, so the window keeps responding however long that takes
+    ctx->changeScene(new LoadingScreen(ctx));
+    if (stressEntities > 0) {
+        Log::info("Spawning {} entities for stress testing...", stressEntities);
+        ctx->scenes().changeSceneAsync(ctx, [stressEntities, tickLod](std::shared_ptr<ApplicationContext> loaderCtx) {
+            return std::make_unique<StressScreen>(loaderCtx, StressConfig{.entities = stressEntities, .tickLod = tickLod});
+        });
+    } else {
+        ctx->scenes().changeSceneAsync(ctx, [](std::shared_ptr<ApplicationContext> loaderCtx) {
+            return std::make_unique<TestScreen>(loaderCtx);
+        });
+    }
+    ctx->frames().statistics().setHitchThreshold(hitchFactor, hitchMinimumMs);
+    ctx->frames().statistics().onHitch([](const FrameSample& sample, double medianFrameMs) {
+        Log::warn("Hitch on frame {}: {:.2f}ms (tick {:.2f}ms, draw {:.2f}ms), median is {:.2f}ms",
+            sample.frame, sample.frameMs, sample.tickMs, sample.drawMs, medianFrameMs);
+    });
+    pipeline = std::make_unique<FramePipeline>(ctx);
+
+    if (replayPath != nullptr) {
+        replay = std::make_unique<InputReplay>();
+        try {
+            replay->load(replayPath);
+        } catch (std::runtime_error& e) {
+            Log::critical("{}", e.what());
+            return SDL_APP_FAILURE;
+        }
+        // Virtual clock, fixed timestep and no pipelining, so every run of a replay ticks exactly the same
+        replay->attach(ctx->input());
+        ctx->frames().setFixedDeltaT(1.0f);
+        pipeline->setPipelined(false);
+        Log::info("Replaying {}, {} ticks", replayPath, replay->lastTick());
+    }
+    if (recordPath != nullptr) {
+        recorder = std::make_unique<InputRecorder>();
+        if (!recorder->open(recordPath)) {
+            Log::critical("Couldn't open {} for recording", recordPath);
+            return SDL_APP_FAILURE;
+        }
+        ctx->input().setRecorder(recorder.get());
+        Log::info("Recording input to {}", recordPath);
+    }
 
     return SDL_APP_CONTINUE;  /* carry on with the program! */
 }
@@ -116,6 +355,16 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
 void SDL_AppQuit(void* comeOnGuysGenericsExist, SDL_AppResult result)
 {
     std::cout << "Game over" << std::endl;
+    /* Joins the simulation worker before anything it might be touching goes away */
+    pipeline.reset();
+    if (framesCsvOnExit && ctx != nullptr) {
+        exportFrames();
+    }
+    if (recorder != nullptr) {
+        ctx->input().setRecorder(nullptr);
+        recorder.reset();
+    }
+    Log::stop();
     /* SDL cleans up the window/renderer */
     /* ApplicationContext SHOULD loose last reference here and be collected... */
 }
@@ -3,10 +3,13 @@
 #include <iostream>
 
 #include <scene/scene.h>
+#include <scene/sceneManager.h>
 #include <meta/ApplicationContext.h>
+#include <tilemap/tilemap.h>
+#include <meta/memoryStats.h>
 
 ViewportState::ViewportState(glm::fvec2* bounds, SDL_WindowFlags settings, SDL_Window* window) {
-    m_bounds = bounds;
+    m_bounds = *bounds;
     m_window = window;
     m_settings = settings;
 }
@@ -14,7 +17,7 @@ ViewportState::~ViewportState() {
     SDL_DestroyWindow(m_window);
 }
 SDL_Window& ViewportState::window() const noexcept { return *m_window; }
-glm::fvec2* ViewportState::bounds() const noexcept { return m_bounds; }
+const glm::fvec2* ViewportState::bounds() const noexcept { return &m_bounds; }
 
 FrameData::FrameData(SDL_Renderer* renderer, double gameStartTime) {
     this->m_number = 0;
@@ -23,8 +26,11 @@ FrameData::FrameData(SDL_Renderer* renderer, double gameStartTime) {
     this->m_gameStartTime = gameStartTime;
     this->m_lastFrameTime = gameStartTime;
     this->m_renderer = renderer;
+    this->m_lastFrameTimePrecise = FrameStatistics::now();
+    this->m_tileChunks = std::make_unique<TileChunkCache>();
 }
 FrameData::~FrameData() {
+    m_tileChunks.reset();
     SDL_DestroyRenderer(m_renderer);
 }
 SDL_Renderer& FrameData::renderer() const noexcept { return *m_renderer; }
@@ -37,36 +43,70 @@ void FrameData::onDrawCallRisingEdge() {
     //Preventing division by zero
     delta = delta == 0 ? 1 : delta;
 
-    this->m_deltaT = this->m_expectedTimePerFrame / delta;
-    this->m_fps = 1.0f / this->m_deltaT;
+    this->m_deltaT = m_fixedDeltaT > 0.0 ? m_fixedDeltaT : this->m_expectedTimePerFrame / delta;
+    this->m_fps = 1000.0f / delta;
     this->m_lastFrameTime = now;
+
+    double nowPrecise = FrameStatistics::now();
+    m_statistics.onFrame(m_number, nowPrecise - m_lastFrameTimePrecise);
+    this->m_lastFrameTimePrecise = nowPrecise;
+    m_tileChunks->trim();
+    MemoryAccounting::onFrame();
+}
+float FrameData::deltaT() const noexcept { return m_deltaT * m_deltaTScale; }
+float FrameData::fps() const noexcept { return m_fps; }
+uint32_t FrameData::number() const noexcept { return m_number; }
+FrameStatistics& FrameData::statistics() noexcept { return m_statistics; }
+TileChunkCache& FrameData::tileChunks() noexcept { return *m_tileChunks; }
+void FrameData::setFixedDeltaT(float deltaT) noexcept {
+    m_fixedDeltaT = deltaT;
+    if (deltaT > 0.0f) {
+        m_deltaT = deltaT;
+    }
 }
-float FrameData::deltaT() const noexcept { return m_deltaT; }
 
+ApplicationContext::ApplicationContext(
+    glm::fvec2* bounds, SDL_WindowFlags settings, 
+    SDL_Window* window, SDL_Renderer* renderer
+) {
+    // Allocate memory for viewport and frames
+    m_viewport = std::make_unique<ViewportState>(
+        bounds, settings, window
+    );
+    m_frames = std::make_unique<FrameData>(
+        renderer, SDL_GetTicks()
+    );
+    m_input = std::make_unique<InputManager>();
+    m_scenes = std::make_unique<SceneManager>();
+}
 ApplicationContext::~ApplicationContext() { }
 
 ViewportState& ApplicationContext::viewport() const noexcept { return *m_viewport; }
 FrameData& ApplicationContext::frames() const noexcept { return *m_frames; }
 InputManager& ApplicationContext::input() const noexcept { return *m_input; }
-IScene& ApplicationContext::currentScene() const noexcept { return *m_currentScene; }
-void ApplicationContext::changeScene(IScene* scene) noexcept { 
-    if (m_currentScene != nullptr) {
-        m_currentScene->onTearDown();
-    }
-    m_currentScene.reset(scene); 
-}
+SceneManager& ApplicationContext::scenes() const noexcept { return *m_scenes; }
+IScene* ApplicationContext::currentScene() const noexcept { return m_scenes->current(); }
+void ApplicationContext::changeScene(IScene* scene) noexcept { m_scenes->changeScene(scene); }
 
-void ApplicationContext::onDrawCallRisingEdge() const noexcept {
+void ApplicationContext::onDrawCallRisingEdge() {
     m_frames->onDrawCallRisingEdge();
-    m_currentScene->onDrawCallRisingEdge();
+    m_scenes->onDrawCallRisingEdge(shared_from_this());
 }
 
 void ApplicationContext::onDraw() noexcept {
-    m_currentScene->draw(shared_from_this());
+    m_scenes->onDraw(shared_from_this());
+}
+
+bool ApplicationContext::onCapture(RenderSnapshot& snapshot) const noexcept {
+    return m_scenes->onCapture(snapshot);
 }
 
 void ApplicationContext::onTick() {
+    double start = FrameStatistics::now();
+
     m_input->onTickRisingEdge();
-    m_currentScene->tick(shared_from_this());
+    m_scenes->onTick(shared_from_this());
+
+    m_frames->statistics().recordTick(FrameStatistics::now() - start);
 }
 
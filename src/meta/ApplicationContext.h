@@ -5,20 +5,28 @@
 #include <input/input.h>
 #include <glm/glm.hpp>
 
-#include <scene/sceneManager.h> 
 #include <meta/processing.h>
+#include <meta/frameStats.h>
+
+/** Source scene/scene.h */
+class IScene;
+/** Source scene/sceneManager.h */
+class SceneManager;
+/** Source tilemap/tilemap.h */
+class TileChunkCache;
 
 class ViewportState {
 public:
+    /** bounds is copied */
     ViewportState(glm::fvec2* bounds, SDL_WindowFlags settings, SDL_Window* window);
     ~ViewportState();
 
     SDL_Window& window() const noexcept;
     /** Display bounds, may not actually be viewport dimensions */
-    glm::fvec2* bounds() const noexcept;
+    const glm::fvec2* bounds() const noexcept;
 
 private:
-    glm::fvec2* m_bounds;
+    glm::fvec2 m_bounds;
     SDL_Window* m_window;
     SDL_WindowFlags m_settings;
 };
@@ -36,15 +44,35 @@ public:
      *  did the last frame take. I.e. (1000 / 60) / (nowMs - lastFrameMs) 
      */
     float deltaT() const noexcept;
+    /** Based on the duration of the last frame only, see statistics() for anything more reliable */
+    float fps() const noexcept;
+    uint32_t number() const noexcept;
+    FrameStatistics& statistics() noexcept;
+    /** Makes deltaT constant regardless of wall clock time, for deterministic replays. Values <= 0 go back to measuring */
+    void setFixedDeltaT(float deltaT) noexcept;
+    /**
+     * Multiplies deltaT until set back to 1, for whatever ticks next to catch up on frames it skipped. Simulation thread only,
+     * see TickScheduler
+     */
+    void setDeltaTScale(float scale) noexcept { m_deltaTScale = scale; }
+    /** Textures of tilemap chunks. Render thread only */
+    TileChunkCache& tileChunks() noexcept;
 
 private:
     uint32_t m_number;
     float m_fps;
+    /** High resolution timestamp of the last frame, see FrameStatistics::now() */
+    double m_lastFrameTimePrecise;
+    FrameStatistics m_statistics;
     double m_deltaT;
     ms m_gameStartTime;
     ms m_lastFrameTime;
     SDL_Renderer* m_renderer;
+    /** Released before the renderer */
+    std::unique_ptr<TileChunkCache> m_tileChunks;
     double m_expectedTimePerFrame = 1000.0 / 60.0;
+    double m_fixedDeltaT = 0.0;
+    float m_deltaTScale = 1.0f;
 };
 
 class ApplicationContext : public std::enable_shared_from_this<ApplicationContext> {
@@ -62,28 +90,25 @@ public:
     ApplicationContext(
         glm::fvec2* bounds, SDL_WindowFlags settings, 
         SDL_Window* window, SDL_Renderer* renderer
-    ) {
-        // Allocate memory for viewport and frames
-        m_viewport = std::make_unique<ViewportState>(
-            bounds, settings, window
-        );
-        m_frames = std::make_unique<FrameData>(
-            renderer, SDL_GetTicks()
-        );
-        m_input = std::make_unique<InputManager>();
-    };
+    );
 
     ViewportState& viewport() const noexcept;
     FrameData& frames() const noexcept;
     InputManager& input() const noexcept;
-    SceneManager& scene() noexcept;
-    void onDrawCallRisingEdge() const noexcept;
+    SceneManager& scenes() const noexcept;
+    /** Top of the scene stack. nullptr until the first scene change has been applied */
+    IScene* currentScene() const noexcept;
+    /** Takes effect on the next frame boundary, see SceneManager */
+    void changeScene(IScene* scene) noexcept;
+    void onDrawCallRisingEdge();
     void onTick();
     void onDraw() noexcept;
+    /** Capture the current scenes for drawing on another thread. Returns false if any of them isn't an ISnapshotDrawable */
+    bool onCapture(RenderSnapshot& snapshot) const noexcept;
     
 private:
     std::unique_ptr<ViewportState> m_viewport;
     std::unique_ptr<FrameData> m_frames;
     std::unique_ptr<InputManager> m_input;
-    std::unique_ptr<SceneManager> m_sceneManager;
+    std::unique_ptr<SceneManager> m_scenes;
 };
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <span>
+#include <atomic>
+#include <typeindex>
+#include <algorithm>
+#include <iterator>
+
+/** Published by IEntity on destruction. Only the id, the entity itself is gone by the time anyone sees this */
+struct EntityDestroyed {
+    long long entityId;
+};
+
+struct ComponentAdded {
+    long long entityId;
+    std::type_index type;
+};
+
+struct ComponentRemoved {
+    long long entityId;
+    std::type_index type;
+};
+
+/** Published by whatever tests collisions, like StressScreen. An id of -1 is something that isn't an entity */
+struct CollisionBegan {
+    long long entityA;
+    long long entityB;
+};
+
+struct CollisionEnded {
+    long long entityA;
+    long long entityB;
+};
+
+using EventSubscriptionId = int;
+
+/**
+ * Typed events, queued per type as they are published and handed to subscribers in batches on dispatch().
+ * Publishing is a push_back into a vector that keeps its capacity, so nothing is allocated per event once warmed up.
+ * Not thread safe, publish and dispatch from the simulation thread.
+ */
+class EventBus {
+public:
+    EventBus() = default;
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    template<typename E>
+    void publish(const E& event) {
+        queue<E>().events.push_back(event);
+    }
+
+    /**
+     * handler receives every event of type E published since the previous dispatch, in order.
+     * Safe to call from within a handler, subscribing during a dispatch of E takes effect from the next one
+     */
+    template<typename E>
+    EventSubscriptionId subscribe(std::function<void(std::span<const E> events)> handler) {
+        EventSubscriptionId id = m_nextSubscriptionId++;
+        EventQueue<E>& events = queue<E>();
+        (events.isDispatching ? events.added : events.subscribers).push_back(Subscriber<E>{id, std::move(handler)});
+        return id;
+    }
+
+    /** Returns false if no such subscription exists. Safe to call from within a handler, including the one unsubscribed */
+    bool unsubscribe(EventSubscriptionId id) {
+        for (size_t i = 0; i < m_queues.size(); i++) {
+            if (m_queues[i] != nullptr && m_queues[i]->unsubscribe(id)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Hand all queued events to their subscribers, one batch per type. Events published by handlers
+     * are queued for the next dispatch, so a handler reacting to its own type can't loop forever.
+     */
+    void dispatch() {
+        // By index, handlers publishing or subscribing to a type not seen before grow m_queues
+        for (size_t i = 0; i < m_queues.size(); i++) {
+            if (m_queues[i] != nullptr) {
+                m_queues[i]->dispatch();
+            }
+        }
+    }
+
+    template<typename E>
+    size_t pending() const noexcept {
+        size_t slot = typeSlot<E>();
+        if (slot >= m_queues.size() || m_queues[slot] == nullptr) {
+            return 0;
+        }
+        return static_cast<const EventQueue<E>*>(m_queues[slot].get())->events.size();
+    }
+
+private:
+    class IEventQueue {
+    public:
+        virtual ~IEventQueue() = default;
+        virtual void dispatch() = 0;
+        virtual bool unsubscribe(EventSubscriptionId id) = 0;
+    };
+
+    template<typename E>
+    struct Subscriber {
+        EventSubscriptionId id;
+        std::function<void(std::span<const E>)> handler;
+        /** Unsubscribed while dispatching, erased once done. The handler may be the one running */
+        bool removed = false;
+    };
+
+    template<typename E>
+    class EventQueue : public IEventQueue {
+    public:
+        std::vector<E> events;
+        /** What is being handed out, while events collects anything published meanwhile */
+        std::vector<E> dispatching;
+        std::vector<Subscriber<E>> subscribers;
+        /** Subscribed while dispatching, so subscribers never reallocates under a running handler */
+        std::vector<Subscriber<E>> added;
+        bool isDispatching = false;
+
+        void dispatch() override {
+            // A handler dispatching again leaves this type to the outer dispatch
+            if (events.empty() || isDispatching) {
+                return;
+            }
+            dispatching.swap(events);
+            isDispatching = true;
+            for (Subscriber<E>& subscriber : subscribers) {
+                if (!subscriber.removed) {
+                    subscriber.handler(std::span<const E>(dispatching));
+                }
+            }
+            isDispatching = false;
+            dispatching.clear();
+            std::erase_if(subscribers, [](const Subscriber<E>& subscriber) { return subscriber.removed; });
+            std::move(added.begin(), added.end(), std::back_inserter(subscribers));
+            added.clear();
+        }
+
+        bool unsubscribe(EventSubscriptionId id) override {
+            for (Subscriber<E>& subscriber : subscribers) {
+                if (subscriber.id == id && !subscriber.removed) {
+                    if (isDispatching) {
+                        subscriber.removed = true;
+                    } else {
+                        std::erase_if(subscribers, [id](const Subscriber<E>& subscriber) { return subscriber.id == id; });
+                    }
+                    return true;
+                }
+            }
+            return std::erase_if(added, [id](const Subscriber<E>& subscriber) { return subscriber.id == id; }) != 0;
+        }
+    };
+
+    /** Indexed by typeSlot, so finding a queue is an array lookup rather than a hash */
+    std::vector<std::unique_ptr<IEventQueue>> m_queues;
+    EventSubscriptionId m_nextSubscriptionId = 0;
+
+    static inline std::atomic<size_t> s_nextSlot = 0;
+
+    template<typename E>
+    static size_t typeSlot() noexcept {
+        static const size_t slot = s_nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    template<typename E>
+    EventQueue<E>& queue() {
+        size_t slot = typeSlot<E>();
+        if (slot >= m_queues.size()) {
+            m_queues.resize(slot + 1);
+        }
+        if (m_queues[slot] == nullptr) {
+            m_queues[slot] = std::make_unique<EventQueue<E>>();
+        }
+        return static_cast<EventQueue<E>&>(*m_queues[slot]);
+    }
+};
@@ -0,0 +1,166 @@
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include <meta/frameStats.h>
+
+RollingHistogram::RollingHistogram(size_t window, double bucketWidth, size_t bucketCount)
+    : m_samples(std::max<size_t>(window, 1), 0.0), m_buckets(std::max<size_t>(bucketCount, 1), 0), m_bucketWidth(bucketWidth) {}
+
+size_t RollingHistogram::bucketOf(double sample) const noexcept {
+    if (sample <= 0.0) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(sample / m_bucketWidth);
+    return std::min(bucket, m_buckets.size() - 1);
+}
+
+void RollingHistogram::push(double sample) noexcept {
+    if (m_count == m_samples.size()) {
+        double evicted = m_samples[m_head];
+        m_buckets[bucketOf(evicted)]--;
+        m_sum -= evicted;
+    } else {
+        m_count++;
+    }
+
+    m_samples[m_head] = sample;
+    m_buckets[bucketOf(sample)]++;
+    m_sum += sample;
+    m_head = (m_head + 1) % m_samples.size();
+}
+
+void RollingHistogram::clear() noexcept {
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_head = 0;
+    m_count = 0;
+    m_sum = 0.0;
+}
+
+double RollingHistogram::latest() const noexcept {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    return m_samples[(m_head + m_samples.size() - 1) % m_samples.size()];
+}
+
+double RollingHistogram::mean() const noexcept {
+    return m_count == 0 ? 0.0 : m_sum / m_count;
+}
+
+double RollingHistogram::max() const noexcept {
+    // Only ever asked for a few times per frame, so a scan is cheaper than keeping a monotonic queue up to date
+    double result = 0.0;
+    for (size_t i = 0; i < m_count; i++) {
+        result = std::max(result, m_samples[i]);
+    }
+    return result;
+}
+
+double RollingHistogram::percentile(double fraction) const noexcept {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    size_t target = static_cast<size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * m_count));
+    target = std::max<size_t>(target, 1);
+
+    size_t seen = 0;
+    for (size_t bucket = 0; bucket < m_buckets.size() - 1; bucket++) {
+        seen += m_buckets[bucket];
+        if (seen >= target) {
+            return (bucket + 1) * m_bucketWidth;
+        }
+    }
+    // Landed in the overflow bucket, which has no meaningful upper edge
+    return max();
+}
+
+FrameStatistics::FrameStatistics(size_t window)
+    : m_frameTimes(window), m_tickTimes(window), m_drawTimes(window), m_samples(std::max<size_t>(window, 1)) {}
+
+double FrameStatistics::now() noexcept {
+    static const double msPerCount = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    return static_cast<double>(SDL_GetPerformanceCounter()) * msPerCount;
+}
+
+void FrameStatistics::onFrame(uint32_t frame, double frameMs) {
+    FrameSample sample{frame, frameMs, m_pendingTickMs, m_pendingDrawMs};
+
+    // Compare against the history before this frame is part of it
+    if (!m_hitchCallbacks.empty() && m_frameTimes.count() >= std::min(m_hitchWarmup, m_samples.size())) {
+        double median = m_frameTimes.percentile(0.5);
+        if (frameMs > m_hitchMinimumMs && frameMs > median * m_hitchFactor) {
+            for (const OnHitchCallback& callback : m_hitchCallbacks) {
+                callback(sample, median);
+            }
+        }
+    }
+
+    m_frameTimes.push(frameMs);
+    m_tickTimes.push(m_pendingTickMs);
+    m_drawTimes.push(m_pendingDrawMs);
+
+    m_samples[m_head] = sample;
+    m_head = (m_head + 1) % m_samples.size();
+    m_count = std::min(m_count + 1, m_samples.size());
+}
+
+void FrameStatistics::setHitchThreshold(double factor, double minimumMs) noexcept {
+    m_hitchFactor = factor;
+    m_hitchMinimumMs = minimumMs;
+}
+
+void FrameStatistics::onHitch(OnHitchCallback callback) {
+    m_hitchCallbacks.push_back(callback);
+}
+
+bool FrameStatistics::exportCsv(const char* path) const {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::fprintf(file, "frame,frame_ms,tick_ms,draw_ms\n");
+    size_t oldest = (m_head + m_samples.size() - m_count) % m_samples.size();
+    for (size_t i = 0; i < m_count; i++) {
+        const FrameSample& sample = m_samples[(oldest + i) % m_samples.size()];
+        std::fprintf(file, "%u,%.4f,%.4f,%.4f\n", sample.frame, sample.frameMs, sample.tickMs, sample.drawMs);
+    }
+
+    return std::fclose(file) == 0;
+}
+
+static void drawHistogramLine(SDL_Renderer& renderer, float y, const char* label, const RollingHistogram& histogram) noexcept {
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-5s p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f ms",
+        label,
+        histogram.percentile(0.50),
+        histogram.percentile(0.95),
+        histogram.percentile(0.99),
+        histogram.max()
+    );
+    SDL_RenderDebugText(&renderer, 8.0f, y, line);
+}
+
+void FrameStatistics::drawOverlay(SDL_Renderer& renderer) const noexcept {
+    if (!m_overlayVisible) {
+        return;
+    }
+    const float lineHeight = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE + 4.0f;
+
+    SDL_SetRenderDrawBlendMode(&renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, 180);
+    SDL_FRect background{4.0f, 4.0f, 440.0f, lineHeight * 4 + 8.0f};
+    SDL_RenderFillRect(&renderer, &background);
+
+    SDL_SetRenderDrawColor(&renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    char line[64];
+    double meanFrameMs = m_frameTimes.mean();
+    std::snprintf(line, sizeof(line), "FPS %6.1f (%zu frames)", meanFrameMs > 0.0 ? 1000.0 / meanFrameMs : 0.0, m_frameTimes.count());
+    SDL_RenderDebugText(&renderer, 8.0f, 8.0f, line);
+
+    drawHistogramLine(renderer, 8.0f + lineHeight, "frame", m_frameTimes);
+    drawHistogramLine(renderer, 8.0f + lineHeight * 2, "tick", m_tickTimes);
+    drawHistogramLine(renderer, 8.0f + lineHeight * 3, "draw", m_drawTimes);
+}
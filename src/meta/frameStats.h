@@ -0,0 +1,107 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Histogram over the last N samples. Bucket counts are updated as samples enter and leave the window,
+ * so percentiles cost a walk over the buckets rather than a sort of the window.
+ */
+class RollingHistogram {
+public:
+    /** Samples beyond bucketWidth * bucketCount all end up in the last bucket */
+    RollingHistogram(size_t window = 600, double bucketWidth = 0.25, size_t bucketCount = 400);
+
+    void push(double sample) noexcept;
+    void clear() noexcept;
+
+    size_t count() const noexcept { return m_count; }
+    double latest() const noexcept;
+    double mean() const noexcept;
+    double max() const noexcept;
+    /** fraction in [0, 1]. Accurate to the bucket width, the upper edge of the bucket is returned */
+    double percentile(double fraction) const noexcept;
+
+private:
+    std::vector<double> m_samples;
+    std::vector<uint32_t> m_buckets;
+    double m_bucketWidth;
+    /** Index of the next sample to be written */
+    size_t m_head = 0;
+    size_t m_count = 0;
+    double m_sum = 0.0;
+
+    size_t bucketOf(double sample) const noexcept;
+};
+
+/** Timings of a single frame, in milliseconds */
+struct FrameSample {
+    uint32_t frame;
+    double frameMs;
+    /** Last completed tick at the time the frame ended */
+    double tickMs;
+    /** Last completed draw at the time the frame ended */
+    double drawMs;
+};
+
+/** Invoked on the main thread with the offending frame and the median frame time it was compared against */
+using OnHitchCallback = std::function<void(const FrameSample& sample, double medianFrameMs)>;
+
+/**
+ * Rolling frame, tick and draw time statistics. Tick and draw durations are only recorded as pending,
+ * and committed together on onFrame, which must happen while no tick is in flight.
+ */
+class FrameStatistics {
+public:
+    FrameStatistics(size_t window = 600);
+
+    /** High resolution timestamp in milliseconds, for measuring durations */
+    static double now() noexcept;
+
+    void recordTick(double ms) noexcept { m_pendingTickMs = ms; }
+    void recordDraw(double ms) noexcept { m_pendingDrawMs = ms; }
+    void onFrame(uint32_t frame, double frameMs);
+
+    const RollingHistogram& frameTimes() const noexcept { return m_frameTimes; }
+    const RollingHistogram& tickTimes() const noexcept { return m_tickTimes; }
+    const RollingHistogram& drawTimes() const noexcept { return m_drawTimes; }
+
+    /**
+     * A frame is a hitch if it took more than factor times the median frame time, and at least minimumMs.
+     * Nothing is reported until the window has some history to compare against.
+     */
+    void setHitchThreshold(double factor, double minimumMs) noexcept;
+    void onHitch(OnHitchCallback callback);
+
+    /** Writes all samples in the window, oldest first. Returns false if the file could not be written */
+    bool exportCsv(const char* path) const;
+
+    void setOverlayVisible(bool visible) noexcept { m_overlayVisible = visible; }
+    bool isOverlayVisible() const noexcept { return m_overlayVisible; }
+    /** Draws percentiles in the top left corner, if the overlay is visible */
+    void drawOverlay(SDL_Renderer& renderer) const noexcept;
+
+private:
+    RollingHistogram m_frameTimes;
+    RollingHistogram m_tickTimes;
+    RollingHistogram m_drawTimes;
+
+    /** Ring buffer of the same window as the histograms, kept for export */
+    std::vector<FrameSample> m_samples;
+    size_t m_head = 0;
+    size_t m_count = 0;
+
+    double m_pendingTickMs = 0.0;
+    double m_pendingDrawMs = 0.0;
+
+    double m_hitchFactor = 2.0;
+    double m_hitchMinimumMs = 1000.0 / 30.0;
+    /** Samples required before hitches are reported */
+    const size_t m_hitchWarmup = 30;
+    std::vector<OnHitchCallback> m_hitchCallbacks;
+
+    bool m_overlayVisible = false;
+};
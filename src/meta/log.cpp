@@ -0,0 +1,271 @@
+#include <SDL3/SDL.h>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+#include <meta/log.h>
+#include <types/ringBuffer.h>
+
+namespace {
+    struct ThreadRecords {
+        SPSCRingBuffer<LogRecord, Log::s_recordsPerThread> records;
+        /** Set once the thread exited, the writer forgets the buffer after draining it */
+        std::atomic<bool> retired = false;
+    };
+
+    struct LogState {
+        std::mutex mutex;
+        std::condition_variable workSignal;
+        std::condition_variable flushedSignal;
+        std::vector<std::shared_ptr<ThreadRecords>> threads;
+        Log::Sink sink;
+        std::thread writer;
+        std::atomic<bool> running = false;
+        bool stopping = false;
+        uint64_t flushRequested = 0;
+        uint64_t flushed = 0;
+        std::atomic<uint32_t> rateLimit = 10;
+        std::atomic<uint64_t> dropped = 0;
+        /** Writer thread only */
+        uint64_t droppedReported = 0;
+        std::vector<LogRecord> batch;
+        std::string text;
+
+        ~LogState() {
+            // Nobody called Log::stop(), a joinable thread would terminate the program on exit
+            if (writer.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                workSignal.notify_all();
+                writer.join();
+            }
+        }
+    };
+
+    LogState& state() {
+        static LogState state;
+        return state;
+    }
+
+    /** Registers the buffer of a thread on first use, and retires it when the thread exits */
+    struct ThreadHandle {
+        std::shared_ptr<ThreadRecords> records;
+
+        ThreadRecords& get() {
+            if (records == nullptr) {
+                records = std::make_shared<ThreadRecords>();
+                std::lock_guard<std::mutex> lock(state().mutex);
+                state().threads.push_back(records);
+            }
+            return *records;
+        }
+        ~ThreadHandle() {
+            if (records != nullptr) {
+                records->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local ThreadHandle t_records;
+
+    struct RateWindow {
+        const void* site = nullptr;
+        uint64_t start = 0;
+        uint32_t count = 0;
+        uint32_t suppressed = 0;
+    };
+    /** Direct mapped by call site. Sites sharing a slot just restart each others window */
+    thread_local std::array<RateWindow, 64> t_rateWindows;
+
+    SDL_LogPriority priorityOf(LogLevel level) noexcept {
+        switch (level) {
+            case LogLevel::Trace: return SDL_LOG_PRIORITY_TRACE;
+            case LogLevel::Debug: return SDL_LOG_PRIORITY_DEBUG;
+            case LogLevel::Info: return SDL_LOG_PRIORITY_INFO;
+            case LogLevel::Warn: return SDL_LOG_PRIORITY_WARN;
+            case LogLevel::Error: return SDL_LOG_PRIORITY_ERROR;
+            default: return SDL_LOG_PRIORITY_CRITICAL;
+        }
+    }
+
+    void writeToSdl(LogLevel level, std::string_view message) {
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, priorityOf(level), "%.*s", static_cast<int>(message.size()), message.data());
+    }
+
+    /** Formats record into text, replacing what it held */
+    void format(const LogRecord& record, std::string& text) {
+        text.clear();
+        if (record.formatter != nullptr) {
+            try {
+                record.formatter(record.format, record.payload, text);
+            } catch (std::exception& e) {
+                text.append("Log message failed to format: ").append(e.what());
+            }
+        } else {
+            text.append(reinterpret_cast<const char*>(record.payload), record.payloadSize);
+        }
+        if (record.suppressed > 0) {
+            text.append(std::format(" ({} more like this suppressed)", record.suppressed));
+        }
+    }
+
+    /** Writer thread, or whoever stopped it */
+    void drain(LogState& log, const Log::Sink& sink) {
+        std::vector<std::shared_ptr<ThreadRecords>> threads;
+        {
+            std::lock_guard<std::mutex> lock(log.mutex);
+            threads = log.threads;
+        }
+
+        log.batch.clear();
+        for (const std::shared_ptr<ThreadRecords>& thread : threads) {
+            // Checked first, anything pushed before retiring is popped below
+            bool retired = thread->retired.load(std::memory_order_acquire);
+            LogRecord record;
+            while (thread->records.tryPop(record)) {
+                log.batch.push_back(record);
+            }
+            if (retired) {
+                std::lock_guard<std::mutex> lock(log.mutex);
+                std::erase(log.threads, thread);
+            }
+        }
+        // Interleaved across threads as they were logged
+        std::stable_sort(log.batch.begin(), log.batch.end(), [](const LogRecord& a, const LogRecord& b) {
+            return a.timestamp < b.timestamp;
+        });
+
+        for (const LogRecord& record : log.batch) {
+            format(record, log.text);
+            sink(record.level, log.text);
+        }
+
+        uint64_t dropped = log.dropped.load(std::memory_order_relaxed);
+        if (dropped != log.droppedReported) {
+            sink(LogLevel::Warn, std::format("{} log messages dropped, logging faster than they can be written", dropped - log.droppedReported));
+            log.droppedReported = dropped;
+        }
+    }
+
+    void writerLoop() {
+        LogState& log = state();
+        std::unique_lock<std::mutex> lock(log.mutex);
+        while (true) {
+            uint64_t requested = log.flushRequested;
+            bool stopping = log.stopping;
+            lock.unlock();
+            drain(log, log.sink);
+            lock.lock();
+
+            log.flushed = requested;
+            log.flushedSignal.notify_all();
+            if (stopping) {
+                return;
+            }
+            // Woken early by flush and stop, otherwise records pile up a little, to be written in larger batches
+            log.workSignal.wait_for(lock, std::chrono::milliseconds(5), [&log]() {
+                return log.stopping || log.flushRequested != log.flushed;
+            });
+        }
+    }
+}
+
+void Log::start(Sink sink) {
+    LogState& log = state();
+    if (log.running.load()) {
+        return;
+    }
+    log.sink = sink != nullptr ? std::move(sink) : Sink(writeToSdl);
+    log.stopping = false;
+    log.dropped.store(0);
+    log.droppedReported = 0;
+    log.writer = std::thread(writerLoop);
+    log.running.store(true, std::memory_order_release);
+}
+
+void Log::stop() {
+    LogState& log = state();
+    if (!log.running.load()) {
+        return;
+    }
+    log.running.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.stopping = true;
+    }
+    log.workSignal.notify_all();
+    log.writer.join();
+    // Whatever was pushed by threads that still saw the writer running
+    drain(log, log.sink);
+    log.sink = nullptr;
+}
+
+void Log::flush() {
+    LogState& log = state();
+    if (!log.running.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(log.mutex);
+    uint64_t request = ++log.flushRequested;
+    log.workSignal.notify_all();
+    log.flushedSignal.wait(lock, [&log, request]() { return log.flushed >= request || log.stopping; });
+}
+
+void Log::setRateLimit(uint32_t perSecond) noexcept {
+    state().rateLimit.store(perSecond, std::memory_order_relaxed);
+}
+
+uint64_t Log::dropped() noexcept {
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t Log::now() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool Log::admit(const void* site, uint32_t& suppressed) noexcept {
+    uint32_t limit = state().rateLimit.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return true;
+    }
+    RateWindow& window = t_rateWindows[(reinterpret_cast<uintptr_t>(site) >> 3) % t_rateWindows.size()];
+    uint64_t time = now();
+    if (window.site != site) {
+        window = RateWindow{site, time, 0, 0};
+    }
+    if (time - window.start >= 1000000000ull) {
+        window.start = time;
+        window.count = 0;
+    }
+    if (window.count >= limit) {
+        window.suppressed++;
+        return false;
+    }
+    window.count++;
+    suppressed = window.suppressed;
+    window.suppressed = 0;
+    return true;
+}
+
+void Log::submit(const LogRecord& record) noexcept {
+    LogState& log = state();
+    if (log.running.load(std::memory_order_acquire)) {
+        if (!t_records.get().records.tryPush(record)) {
+            log.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    // No writer, written right away
+    std::string text;
+    format(record, text);
+    writeToSdl(record.level, text);
+}
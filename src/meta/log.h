@@ -0,0 +1,200 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <format>
+#include <functional>
+#include <tuple>
+#include <iterator>
+#include <type_traits>
+#include <concepts>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+/** Calls below this level compile to nothing. 0 keeps everything, 5 only Log::critical */
+#ifndef SDLGAME_LOG_LEVEL
+#define SDLGAME_LOG_LEVEL 0
+#endif
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Critical
+};
+
+/**
+ * A log call, as it travels from the logging thread to the writer. Arguments are copied into payload as they are,
+ * and only formatted on the writer thread, by formatter. Trivially copyable, records live in ring buffers.
+ */
+struct LogRecord {
+    static constexpr size_t s_payloadSize = 216;
+    /** Appends the formatted message to out */
+    using Formatter = void (*)(std::string_view format, const std::byte* payload, std::string& out);
+
+    uint64_t timestamp;
+    std::string_view format;
+    /** nullptr if payload holds the finished message, payloadSize long */
+    Formatter formatter;
+    /** Messages of the same call site dropped by the rate limit since this one last got through */
+    uint32_t suppressed;
+    uint16_t payloadSize;
+    LogLevel level;
+    std::byte payload[s_payloadSize];
+};
+
+namespace logArgs {
+    /** Copied as characters, the pointer may not outlive the call */
+    template<typename T>
+    constexpr bool isText = std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>
+        || std::is_same_v<std::decay_t<T>, std::string> || std::is_same_v<std::decay_t<T>, std::string_view>;
+
+    template<typename T>
+    using Stored = std::conditional_t<isText<T>, std::string_view, std::decay_t<T>>;
+
+    template<typename T>
+    bool encode(std::byte*& at, const std::byte* end, const T& value) noexcept {
+        if constexpr (isText<T>) {
+            std::string_view text;
+            if constexpr (std::is_pointer_v<T>) {
+                text = value != nullptr ? std::string_view(value) : std::string_view("(null)");
+            } else {
+                text = std::string_view(value);
+            }
+            if (static_cast<size_t>(end - at) < sizeof(uint16_t) + text.size()) {
+                return false;
+            }
+            uint16_t length = static_cast<uint16_t>(text.size());
+            std::memcpy(at, &length, sizeof(length));
+            std::memcpy(at + sizeof(length), text.data(), text.size());
+            at += sizeof(length) + text.size();
+        } else {
+            static_assert(std::is_trivially_copyable_v<std::decay_t<T>>,
+                "Log arguments are formatted later on another thread, and must be text or trivially copyable");
+            if (static_cast<size_t>(end - at) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(at, &value, sizeof(T));
+            at += sizeof(T);
+        }
+        return true;
+    }
+
+    template<typename T>
+    Stored<T> decode(const std::byte*& at) noexcept {
+        if constexpr (isText<T>) {
+            uint16_t length;
+            std::memcpy(&length, at, sizeof(length));
+            std::string_view text(reinterpret_cast<const char*>(at + sizeof(length)), length);
+            at += sizeof(length) + length;
+            return text;
+        } else {
+            Stored<T> value;
+            std::memcpy(&value, at, sizeof(value));
+            at += sizeof(value);
+            return value;
+        }
+    }
+
+    template<typename... Args>
+    void format(std::string_view format, const std::byte* payload, std::string& out) {
+        // Unused by calls without arguments
+        [[maybe_unused]] const std::byte* at = payload;
+        // Braced, so the arguments are decoded left to right
+        std::tuple<Stored<Args>...> values{decode<Args>(at)...};
+        std::apply([&](auto&... decoded) {
+            std::vformat_to(std::back_inserter(out), format, std::make_format_args(decoded...));
+        }, values);
+    }
+}
+
+/** Format string of a log call, checked against its arguments at compile time, like std::format does */
+template<typename... Args>
+struct LogFormat {
+    std::string_view text;
+
+    template<typename S> requires std::convertible_to<const S&, std::string_view>
+    consteval LogFormat(const S& format) : text(format) {
+        (void)std::format_string<Args...>(format);
+    }
+};
+
+/**
+ * Logging that costs the calling thread about a memcpy. Each thread pushes records into its own lock free ring buffer,
+ * and a writer thread formats and writes them, see start(). Warnings and worse are rate limited per call site,
+ * so an error firing every frame can't take the frame rate down with it. std::format syntax, checked at compile time.
+ * Until start(), and after stop(), calls format and write right away instead.
+ */
+class Log {
+public:
+    using Sink = std::function<void(LogLevel level, std::string_view message)>;
+    /** Per thread. Records logged while full are dropped, see dropped() */
+    static constexpr size_t s_recordsPerThread = 1024;
+
+    /** Starts the writer thread. The default sink writes through SDL_LogMessage */
+    static void start(Sink sink = nullptr);
+    /** Writes everything still queued, then stops the writer thread */
+    static void stop();
+    /** Blocks until everything logged before the call was written */
+    static void flush();
+
+    /** Messages per second and call site for warnings and worse. 0 to never limit */
+    static void setRateLimit(uint32_t perSecond) noexcept;
+    /** Lost to full ring buffers, since start */
+    static uint64_t dropped() noexcept;
+
+    template<typename... Args>
+    static void trace(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Trace, Args...>(format.text, args...); }
+    template<typename... Args>
+    static void debug(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Debug, Args...>(format.text, args...); }
+    template<typename... Args>
+    static void info(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Info, Args...>(format.text, args...); }
+    template<typename... Args>
+    static void warn(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Warn, Args...>(format.text, args...); }
+    template<typename... Args>
+    static void error(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Error, Args...>(format.text, args...); }
+    template<typename... Args>
+    static void critical(LogFormat<std::type_identity_t<Args>...> format, Args&&... args) { write<LogLevel::Critical, Args...>(format.text, args...); }
+
+private:
+    template<LogLevel L, typename... Args>
+    static void write(std::string_view format, const std::remove_reference_t<Args>&... args) {
+        if constexpr (static_cast<int>(L) >= SDLGAME_LOG_LEVEL) {
+            uint32_t suppressed = 0;
+            if constexpr (L >= LogLevel::Warn) {
+                // Format strings are literals, their address tells call sites apart
+                if (!admit(format.data(), suppressed)) {
+                    return;
+                }
+            }
+            LogRecord record;
+            record.timestamp = now();
+            record.format = format;
+            record.suppressed = suppressed;
+            record.level = L;
+
+            std::byte* at = record.payload;
+            const std::byte* end = record.payload + LogRecord::s_payloadSize;
+            if ((logArgs::encode(at, end, args) && ...)) {
+                record.formatter = &logArgs::format<Args...>;
+                record.payloadSize = static_cast<uint16_t>(at - record.payload);
+            } else {
+                // Too long to defer, formatted here and cut to fit
+                std::string text = std::vformat(format, std::make_format_args(args...));
+                record.formatter = nullptr;
+                record.payloadSize = static_cast<uint16_t>(std::min(text.size(), LogRecord::s_payloadSize));
+                std::memcpy(record.payload, text.data(), record.payloadSize);
+            }
+            submit(record);
+        }
+    }
+
+    static uint64_t now() noexcept;
+    /** Rate limit, per thread and call site. Sets suppressed to the messages dropped since the site last got through */
+    static bool admit(const void* site, uint32_t& suppressed) noexcept;
+    static void submit(const LogRecord& record) noexcept;
+};
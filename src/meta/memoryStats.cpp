@@ -0,0 +1,115 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#include <mutex>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
+
+#include <meta/memoryStats.h>
+#include <meta/log.h>
+
+size_t peakResidentBytes() noexcept {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    // Bytes on macOS
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Kilobytes on Linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        /** Stable addresses, handed out to MemoryAccounting::of */
+        std::vector<std::unique_ptr<TypeMemoryStats>> types;
+    };
+
+    Registry& registry() {
+        // Constructed on first use, components may well be created during static initialization
+        static Registry instance;
+        return instance;
+    }
+
+    std::string readableName(const std::type_info& type) {
+#if defined(__GNUG__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+            std::string name(demangled);
+            std::free(demangled);
+            return name;
+        }
+#endif
+        return type.name();
+    }
+}
+
+TypeMemoryStats& MemoryAccounting::registerType(const std::type_info& type, size_t size) {
+    Registry& types = registry();
+    std::lock_guard<std::mutex> lock(types.mutex);
+    types.types.push_back(std::make_unique<TypeMemoryStats>(readableName(type), size));
+    return *types.types.back();
+}
+
+void MemoryAccounting::onFrame() noexcept {
+    Registry& types = registry();
+    std::lock_guard<std::mutex> lock(types.mutex);
+    for (const std::unique_ptr<TypeMemoryStats>& stats : types.types) {
+        uint64_t allocations = stats->allocations.load(std::memory_order_relaxed);
+        stats->allocationsLastFrame = allocations - stats->allocationsAtFrameStart;
+        stats->allocationsAtFrameStart = allocations;
+    }
+}
+
+std::vector<TypeMemoryReport> MemoryAccounting::report() {
+    std::vector<TypeMemoryReport> rows;
+    {
+        Registry& types = registry();
+        std::lock_guard<std::mutex> lock(types.mutex);
+        for (const std::unique_ptr<TypeMemoryStats>& stats : types.types) {
+            int64_t live = stats->live.load(std::memory_order_relaxed);
+            int64_t peak = stats->peakLive.load(std::memory_order_relaxed);
+            rows.push_back(TypeMemoryReport{
+                stats->name,
+                live,
+                static_cast<size_t>(std::max<int64_t>(live, 0)) * stats->size,
+                static_cast<size_t>(peak) * stats->size,
+                stats->allocationsLastFrame,
+                stats->allocations.load(std::memory_order_relaxed)
+            });
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const TypeMemoryReport& a, const TypeMemoryReport& b) { return a.bytes > b.bytes; });
+    return rows;
+}
+
+void MemoryAccounting::log() {
+    Log::info("Memory: peak resident {:.1f} MiB", peakResidentBytes() / (1024.0 * 1024.0));
+    Log::info("{:<32} {:>10} {:>12} {:>12} {:>10} {:>12}", "type", "live", "KiB", "peak KiB", "allocs/f", "allocs");
+    for (const TypeMemoryReport& row : report()) {
+        Log::info("{:<32} {:>10} {:>12.1f} {:>12.1f} {:>10} {:>12}",
+            row.name, row.live, row.bytes / 1024.0, row.peakBytes / 1024.0, row.allocationsLastFrame, row.allocations);
+    }
+}
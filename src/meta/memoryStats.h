@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <typeinfo>
+
+/** Highest resident memory of this process so far, in bytes. 0 if the platform doesn't tell */
+size_t peakResidentBytes() noexcept;
+
+/**
+ * Live instances of a single type, counted as they are created and destroyed. Updated from whichever thread
+ * creates them, scenes may be loaded in the background, so counters are atomic. Relaxed, they are only ever read for reporting.
+ */
+struct TypeMemoryStats {
+    std::string name;
+    size_t size;
+    std::atomic<int64_t> live = 0;
+    std::atomic<int64_t> peakLive = 0;
+    /** Heap allocations ever made. Instances in storage owned by someone else, e.g. PrefabInstances, aren't allocations */
+    std::atomic<uint64_t> allocations = 0;
+    /** Main thread only, see MemoryAccounting::onFrame */
+    uint64_t allocationsAtFrameStart = 0;
+    uint64_t allocationsLastFrame = 0;
+
+    TypeMemoryStats(std::string name, size_t size) : name(std::move(name)), size(size) {};
+
+    void onCreated(bool allocated) noexcept {
+        int64_t now = live.fetch_add(1, std::memory_order_relaxed) + 1;
+        int64_t peak = peakLive.load(std::memory_order_relaxed);
+        while (now > peak && !peakLive.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+        if (allocated) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void onDestroyed() noexcept {
+        live.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+struct TypeMemoryReport {
+    std::string name;
+    int64_t live;
+    size_t bytes;
+    size_t peakBytes;
+    uint64_t allocationsLastFrame;
+    uint64_t allocations;
+};
+
+/**
+ * Memory used per component type, and by entities themselves. Each type registers itself the first time an instance is made.
+ * Bytes are sizeof the type times live instances, so anything a component allocates on its own isn't included.
+ */
+class MemoryAccounting {
+public:
+    template<typename T>
+    static TypeMemoryStats& of() {
+        static TypeMemoryStats& stats = registerType(typeid(T), sizeof(T));
+        return stats;
+    }
+
+    /** Roll allocations per frame over. Called on the frame boundary, see FrameData::onDrawCallRisingEdge */
+    static void onFrame() noexcept;
+    /** Every registered type, most bytes first */
+    static std::vector<TypeMemoryReport> report();
+    /** Logs report() as a table, along with the peak resident memory of the process */
+    static void log();
+
+private:
+    static TypeMemoryStats& registerType(const std::type_info& type, size_t size);
+};
@@ -0,0 +1,182 @@
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <exception>
+
+#include <meta/pipeline.h>
+#include <meta/ApplicationContext.h>
+#include <meta/log.h>
+
+void RenderSnapshot::clear() noexcept {
+    frame = 0;
+    clearColour = {0, 0, 0, SDL_ALPHA_OPAQUE};
+    rects.clear();
+    triangleXY.clear();
+    triangleColours.clear();
+    chunks.clear();
+    chunkTiles.clear();
+}
+
+void RenderSnapshot::pushRect(const TransformComponent& transform, glm::fvec2 size, SDL_Color colour) {
+    rects.push_back(SnapshotRect{TransformSnapshot(transform), size, colour});
+}
+
+void RenderSnapshot::finalize() noexcept {
+    std::stable_sort(rects.begin(), rects.end(), [](const SnapshotRect& a, const SnapshotRect& b) {
+        return a.transform.position.z < b.transform.position.z;
+    });
+}
+
+void RenderSnapshot::draw(SDL_Renderer& renderer, TileChunkCache& chunkCache) const noexcept {
+    SDL_SetRenderDrawColor(&renderer, clearColour.r, clearColour.g, clearColour.b, clearColour.a);
+    SDL_RenderClear(&renderer);
+
+    for (const SnapshotChunk& chunk : chunks) {
+        const TileId* tiles = chunk.tiles == SnapshotChunk::s_noTiles ? nullptr : chunkTiles.data() + chunk.tiles;
+        chunkCache.draw(renderer, chunk.state, chunk.chunk, chunk.version, chunk.destination, tiles);
+    }
+
+    for (const SnapshotRect& rect : rects) {
+        SDL_SetRenderDrawColor(&renderer, rect.colour.r, rect.colour.g, rect.colour.b, rect.colour.a);
+        SDL_FRect area{
+            rect.transform.position.x,
+            rect.transform.position.y,
+            rect.size.x * rect.transform.scale.x,
+            rect.size.y * rect.transform.scale.y
+        };
+        if (!SDL_RenderFillRect(&renderer, &area)) {
+            Log::error("Could not draw snapshot rect: {}", SDL_GetError());
+        }
+    }
+
+    if (!triangleColours.empty()) {
+        int vertices = static_cast<int>(triangleColours.size());
+        if (!SDL_RenderGeometryRaw(&renderer, nullptr, triangleXY.data(), sizeof(float) * 2, triangleColours.data(), sizeof(SDL_FColor),
+                nullptr, 0, vertices, nullptr, 0, 0)) {
+            Log::error("Could not draw snapshot triangles: {}", SDL_GetError());
+        }
+    }
+}
+
+FramePipeline::FramePipeline(std::shared_ptr<ApplicationContext> ctx) : m_ctx(ctx) {
+    m_worker = std::thread(&FramePipeline::workerLoop, this);
+}
+
+FramePipeline::~FramePipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_shutdown = true;
+    }
+    m_workerSignal.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+const RenderSnapshot* FramePipeline::beginFrame() {
+    if (!m_pipelined) {
+        // Scene changes are applied on the rising edge, so the tick below already runs on the new scene
+        m_ctx->onDrawCallRisingEdge();
+        m_ticksStarted++;
+        m_ctx->onTick();
+        return nullptr;
+    }
+
+    // From here until kickTick() the simulation is idle, and the main thread owns all of it
+    bool workerTicked = waitForTick();
+    m_ctx->onDrawCallRisingEdge();
+
+    if (!m_lastTickCaptured) {
+        // Either the very first frame, or the current scene cannot be captured.
+        // Don't tick twice in one frame if the worker already did so.
+        if (!workerTicked) {
+            m_ticksStarted++;
+            m_lastTickCaptured = tickAndCapture();
+        }
+        if (!m_lastTickCaptured) {
+            return nullptr;
+        }
+    }
+
+    m_snapshots.acquire();
+    kickTick();
+    return &m_snapshots.read();
+}
+
+void FramePipeline::queueEvent(const SDL_Event& event) {
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    SDL_Event copy = event;
+    if (!m_ctx->input().onEvent(&copy)) {
+        Log::warn("Input queue full, event dropped");
+    }
+}
+
+void FramePipeline::setPipelined(bool pipelined) {
+    waitForTick();
+    m_pipelined = pipelined;
+    // Whatever was captured last is stale by the time pipelining is turned back on
+    m_lastTickCaptured = false;
+}
+
+void FramePipeline::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    while (true) {
+        m_workerSignal.wait(lock, [this] { return m_tickRequested || m_shutdown; });
+        if (m_shutdown) {
+            return;
+        }
+        m_tickRequested = false;
+        lock.unlock();
+
+        bool captured = false;
+        std::exception_ptr error = nullptr;
+        try {
+            captured = tickAndCapture();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        m_lastTickCaptured = captured;
+        m_workerError = error;
+        m_tickInFlight = false;
+        m_workerSignal.notify_all();
+    }
+}
+
+bool FramePipeline::tickAndCapture() {
+    m_ctx->onTick();
+
+    RenderSnapshot& snapshot = m_snapshots.write();
+    snapshot.clear();
+    snapshot.frame = ++m_ticks;
+    if (!m_ctx->onCapture(snapshot)) {
+        return false;
+    }
+    snapshot.finalize();
+    m_snapshots.publish();
+    return true;
+}
+
+void FramePipeline::kickTick() {
+    m_ticksStarted++;
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_tickRequested = true;
+        m_tickInFlight = true;
+    }
+    m_workerSignal.notify_all();
+}
+
+bool FramePipeline::waitForTick() {
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool wasInFlight = m_tickInFlight;
+    m_workerSignal.wait(lock, [this] { return !m_tickInFlight; });
+
+    if (m_workerError != nullptr) {
+        // Surface exceptions thrown by tick on the main thread, just like a sequential tick would
+        std::exception_ptr error = m_workerError;
+        m_workerError = nullptr;
+        std::rethrow_exception(error);
+    }
+    return wasInFlight;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <glm/glm.hpp>
+
+#include <entities/components.h>
+#include <tilemap/tilemap.h>
+
+/** Source meta/ApplicationContext.h */
+class ApplicationContext;
+
+/**
+ * Lock free single producer / single consumer triple buffer.
+ * The producer always has a slot to write into, and the consumer always has a complete slot to read from,
+ * so neither side ever waits on the other. Slots are reused, so any capacity a T has grown to is kept.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    /** Producer side: the slot currently being written */
+    T& write() noexcept { return m_slots[m_write]; }
+
+    /** Producer side: hand the written slot over to the consumer */
+    void publish() noexcept {
+        uint8_t previous = m_middle.exchange(m_write | s_fresh, std::memory_order_acq_rel);
+        m_write = previous & s_indexMask;
+    }
+
+    /** Consumer side: swap in the most recently published slot, if any. Returns false if nothing new was published */
+    bool acquire() noexcept {
+        if ((m_middle.load(std::memory_order_acquire) & s_fresh) == 0) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & s_indexMask;
+        return true;
+    }
+
+    /** Consumer side: the slot currently being read. Immutable until the next acquire() */
+    const T& read() const noexcept { return m_slots[m_read]; }
+
+private:
+    static constexpr uint8_t s_fresh = 0b100;
+    static constexpr uint8_t s_indexMask = 0b011;
+
+    std::array<T, 3> m_slots;
+    uint8_t m_write = 0;
+    uint8_t m_read = 1;
+    std::atomic<uint8_t> m_middle = 2;
+};
+
+/** Copy of the world transform of a TransformComponent, detached from the entity owning it */
+struct TransformSnapshot {
+    glm::fvec3 position = glm::fvec3(0.0f, 0.0f, 0.0f);
+    glm::fvec2 scale = glm::fvec2(1.0f, 1.0f);
+    float rotation = 0.0f;
+
+    TransformSnapshot() = default;
+    TransformSnapshot(const TransformComponent& transform)
+        : position(transform.worldPosition()), scale(transform.worldScale()), rotation(transform.worldRotation()) {};
+};
+
+struct SnapshotRect {
+    TransformSnapshot transform;
+    /** Unscaled size, multiplied by transform.scale when drawn */
+    glm::fvec2 size;
+    SDL_Color colour;
+};
+
+/** A tilemap chunk to draw from TileChunkCache, see Tilemap::capture */
+struct SnapshotChunk {
+    static constexpr uint32_t s_noTiles = UINT32_MAX;
+
+    std::shared_ptr<TilemapRasterState> state;
+    uint32_t chunk;
+    uint32_t version;
+    SDL_FRect destination;
+    /** Offset into RenderSnapshot::chunkTiles, or s_noTiles if the render thread had this version already */
+    uint32_t tiles;
+};
+
+/**
+ * Everything the render thread needs to draw one frame. Captured on the simulation thread after tick,
+ * and never touched by the simulation again until the renderer has let go of it.
+ */
+struct RenderSnapshot {
+    uint32_t frame = 0;
+    SDL_Color clearColour = {0, 0, 0, SDL_ALPHA_OPAQUE};
+    std::vector<SnapshotRect> rects;
+    /** Untextured triangles, drawn on top of rects in a single call. Three points and three colours each, see ParticleEmitter */
+    std::vector<float> triangleXY;
+    std::vector<SDL_FColor> triangleColours;
+    /** Drawn first, underneath everything else */
+    std::vector<SnapshotChunk> chunks;
+    std::vector<TileId> chunkTiles;
+
+    /** Keeps capacity, so steady state capturing does not allocate */
+    void clear() noexcept;
+    void pushRect(const TransformComponent& transform, glm::fvec2 size, SDL_Color colour);
+    /** Sorts by z, lower is "earlier" in the draw order. Called once capturing is done */
+    void finalize() noexcept;
+    void draw(SDL_Renderer& renderer, TileChunkCache& chunkCache) const noexcept;
+};
+
+/**
+ * Runs the tick of frame N+1 on a worker thread while the main thread draws frame N from a RenderSnapshot.
+ * The two only synchronize in beginFrame(), which is also the only place the simulation sees
+ * a new deltaT or a scene change. Input is queued without waiting on the tick, and picked up by whichever tick runs next.
+ * If the current scene isn't an ISnapshotDrawable, the frame falls back to tick then immediate mode draw on the main thread.
+ */
+class FramePipeline {
+public:
+    FramePipeline(std::shared_ptr<ApplicationContext> ctx);
+    ~FramePipeline();
+
+    /**
+     * Frame boundary. Waits for the in-flight tick, starts the next one and returns
+     * the latest snapshot to draw. Returns nullptr if the frame has to be drawn in immediate mode through ApplicationContext::onDraw.
+     */
+    const RenderSnapshot* beginFrame();
+    /**
+     * Queued for the next tick to apply, even while a tick is in flight. Thread safe. Producers are serialized
+     * with a mutex, as the input queue has a single producer, but the tick draining it never takes that lock
+     */
+    void queueEvent(const SDL_Event& event);
+
+    /** Disabling pipelining ticks and draws on the main thread, like the pipeline didn't exist */
+    void setPipelined(bool pipelined);
+    bool isPipelined() const noexcept { return m_pipelined; }
+    /** Ticks run or started so far, including the one in flight. Main thread only */
+    uint32_t ticksStarted() const noexcept { return m_ticksStarted; }
+
+private:
+    std::shared_ptr<ApplicationContext> m_ctx;
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    bool m_pipelined = true;
+    /** Ticks run through the pipeline, only touched by whichever thread currently owns the simulation */
+    uint32_t m_ticks = 0;
+    uint32_t m_ticksStarted = 0;
+
+    /** InputManager takes a single producer, this serializes any threads SDL happens to deliver events on */
+    std::mutex m_eventMutex;
+
+    std::thread m_worker;
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerSignal;
+    bool m_tickRequested = false;
+    bool m_tickInFlight = false;
+    bool m_shutdown = false;
+    /** Whether the tick that just finished managed to capture a snapshot */
+    bool m_lastTickCaptured = false;
+    /** Exception thrown by the last tick on the worker, rethrown on the main thread */
+    std::exception_ptr m_workerError = nullptr;
+
+    void workerLoop();
+    /** Tick and capture, run on whichever thread owns the simulation at the time */
+    bool tickAndCapture();
+    void kickTick();
+    /** Returns whether a tick was in flight */
+    bool waitForTick();
+};
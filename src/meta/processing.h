@@ -6,6 +6,8 @@
 class ApplicationContext;
 /** Source scene/scene.h */
 class SceneContext;
+/** Source meta/pipeline.h */
+struct RenderSnapshot;
 
 class ITickable {
 public:
@@ -21,3 +23,10 @@ public:
     // Lower is "earlier" in the draw order
     double getZIndex() const noexcept { return 0; }
 };
+
+/** Drawable from a RenderSnapshot, allowing it to be drawn on another thread while the next tick runs */
+class ISnapshotDrawable {
+public:
+    /** Called on the simulation thread after tick. Record everything needed to draw the current state */
+    virtual void capture(RenderSnapshot& snapshot) const noexcept = 0;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/** A data member of T, as listed by Reflection<T>::fields */
+template<typename T, typename M>
+struct ReflectedField {
+    using Owner = T;
+    using Type = M;
+
+    const char* name;
+    M T::* member;
+};
+
+template<typename T, typename M>
+constexpr ReflectedField<T, M> field(const char* name, M T::* member) noexcept {
+    return ReflectedField<T, M>{name, member};
+}
+
+/**
+ * Compile time description of a type, specialized next to the type itself:
+ *
+ *     template<> struct Reflection<HealthComponent> {
+ *         static constexpr const char* name = "HealthComponent";
+ *         static constexpr auto fields = std::tuple{field("health", &HealthComponent::health)};
+ *     };
+ *
+ * The name identifies the type on disk, so it must not change once saved.
+ */
+template<typename T>
+struct Reflection;
+
+template<typename T>
+concept Reflected = requires {
+    { Reflection<T>::name } -> std::convertible_to<const char*>;
+    Reflection<T>::fields;
+};
+
+/**
+ * Components that are plain data: no virtual functions, no base class, copyable with memcpy.
+ * Stored by value in pages per type rather than allocated one by one, see PlainComponentPool.
+ */
+template<typename T>
+concept PlainComponent = Reflected<T> && std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>
+    && !std::is_polymorphic_v<T> && std::is_default_constructible_v<T>;
+
+/** Where a field sits within its type, for anything walking fields at runtime */
+struct FieldLayout {
+    const char* name;
+    size_t offset;
+    size_t size;
+};
+
+/** Layout of a reflected type, size and alignment as stored, and whether its fields cover it without padding */
+template<Reflected T>
+struct TypeLayout {
+    static constexpr const char* name = Reflection<T>::name;
+    static constexpr size_t size = sizeof(T);
+    static constexpr size_t alignment = alignof(T);
+    static constexpr bool trivial = std::is_trivially_copyable_v<T>;
+    static constexpr size_t fieldCount = std::tuple_size_v<std::remove_cvref_t<decltype(Reflection<T>::fields)>>;
+    /** Sum of the sizes of all fields */
+    static constexpr size_t fieldBytes = std::apply([](const auto&... fields) {
+        return (sizeof(typename std::remove_cvref_t<decltype(fields)>::Type) + ... + size_t(0));
+    }, Reflection<T>::fields);
+    /** Fields add up to the whole type, so records can be copied as a whole rather than field by field */
+    static constexpr bool packed = trivial && fieldBytes == size;
+
+    /** Offsets aren't constant expressions for member pointers, so they are measured on an instance */
+    static std::vector<FieldLayout> fields() {
+        std::vector<FieldLayout> layout;
+        layout.reserve(fieldCount);
+        T sample{};
+        const std::byte* base = reinterpret_cast<const std::byte*>(&sample);
+        std::apply([&](const auto&... fields) {
+            (layout.push_back(FieldLayout{
+                fields.name,
+                static_cast<size_t>(reinterpret_cast<const std::byte*>(&(sample.*fields.member)) - base),
+                sizeof(typename std::remove_cvref_t<decltype(fields)>::Type)
+            }), ...);
+        }, Reflection<T>::fields);
+        return layout;
+    }
+
+    /** Calls func(name, value) for every field of value, in order */
+    template<typename Value, typename Func>
+    static void forEachField(Value& value, Func&& func) {
+        std::apply([&](const auto&... fields) {
+            (func(fields.name, value.*fields.member), ...);
+        }, Reflection<T>::fields);
+    }
+};
@@ -0,0 +1,271 @@
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include <navigation/navGrid.h>
+#include <tilemap/tilemap.h>
+#include <collisions/collider.h>
+
+namespace {
+    /**
+     * Orthogonal first, a diagonal step needs both orthogonal cells next to it free, so agents don't clip corners.
+     * Opposite offsets are paired, direction ^ 1 reverses a direction
+     */
+    constexpr int s_offsetX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+    constexpr int s_offsetY[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+    constexpr float s_stepLength[8] = {1.0f, 1.0f, 1.0f, 1.0f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f};
+    constexpr float s_infinity = std::numeric_limits<float>::infinity();
+
+    bool canStep(const NavGrid& grid, int x, int y, int direction) noexcept {
+        int toX = x + s_offsetX[direction];
+        int toY = y + s_offsetY[direction];
+        if (!grid.isWalkable(toX, toY)) {
+            return false;
+        }
+        return direction < 4 || (grid.isWalkable(toX, y) && grid.isWalkable(x, toY));
+    }
+
+    /** Admissible, as no cell costs less than 1 */
+    float octile(int fromX, int fromY, int toX, int toY) noexcept {
+        int dx = std::abs(fromX - toX);
+        int dy = std::abs(fromY - toY);
+        return static_cast<float>(std::max(dx, dy)) + 0.41421356f * static_cast<float>(std::min(dx, dy));
+    }
+}
+
+NavGrid::NavGrid(int width, int height, float cellSize, glm::fvec2 origin)
+    : m_width(width), m_height(height), m_cellSize(cellSize), m_origin(origin) {
+    if (width <= 0 || height <= 0 || cellSize <= 0.0f) {
+        throw std::runtime_error(std::format("Cannot create a {}x{} navigation grid with cells of {}", width, height, cellSize));
+    }
+    m_cost.assign(static_cast<size_t>(width) * height, 1);
+    m_changed.assign(m_cost.size(), 0);
+}
+
+void NavGrid::setCost(int x, int y, uint8_t cost) {
+    if (!inBounds(x, y)) {
+        throw std::runtime_error(std::format("Cell {}, {} is outside the {}x{} navigation grid", x, y, m_width, m_height));
+    }
+    int cell = index(x, y);
+    if (m_cost[cell] == cost) {
+        return;
+    }
+    m_cost[cell] = cost;
+    m_version++;
+    if (!m_changed[cell]) {
+        m_changed[cell] = 1;
+        m_changes.push_back(cell);
+    }
+}
+
+void NavGrid::blockSolidTiles(const Tilemap& tilemap) {
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            if (tilemap.isSolidAt(centre(glm::ivec2(x, y)))) {
+                setBlocked(x, y, true);
+            }
+        }
+    }
+}
+
+void NavGrid::blockColliders(std::span<const ICollider* const> colliders) {
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            glm::fvec2 point = centre(glm::ivec2(x, y));
+            glm::fvec3 point3(point, 0.0f);
+            for (const ICollider* collider : colliders) {
+                if (collider != nullptr && collider->overlaps(&point3)) {
+                    setBlocked(x, y, true);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+glm::ivec2 NavGrid::cellAt(glm::fvec2 point) const noexcept {
+    return glm::ivec2(
+        static_cast<int>(std::floor((point.x - m_origin.x) / m_cellSize)),
+        static_cast<int>(std::floor((point.y - m_origin.y) / m_cellSize))
+    );
+}
+
+glm::fvec2 NavGrid::centre(glm::ivec2 cell) const noexcept {
+    return glm::fvec2(
+        m_origin.x + (static_cast<float>(cell.x) + 0.5f) * m_cellSize,
+        m_origin.y + (static_cast<float>(cell.y) + 0.5f) * m_cellSize
+    );
+}
+
+std::vector<int> NavGrid::takeChanges() {
+    for (int cell : m_changes) {
+        m_changed[cell] = 0;
+    }
+    std::vector<int> changes;
+    changes.swap(m_changes);
+    return changes;
+}
+
+std::vector<glm::ivec2> PathSearch::find(const NavGrid& grid, glm::ivec2 start, glm::ivec2 goal) {
+    m_expanded = 0;
+    if (!grid.isWalkable(start.x, start.y) || !grid.isWalkable(goal.x, goal.y)) {
+        return {};
+    }
+
+    size_t cells = static_cast<size_t>(grid.width()) * grid.height();
+    if (m_stamps.size() != cells || m_stamp >= std::numeric_limits<uint32_t>::max() - 2) {
+        m_cost.assign(cells, 0.0f);
+        m_parent.assign(cells, -1);
+        m_stamps.assign(cells, 0);
+        m_stamp = 0;
+    }
+    // Odd stamps mark open cells, the following even ones closed cells
+    m_stamp += 2;
+    uint32_t open = m_stamp - 1;
+    uint32_t closed = m_stamp;
+
+    int startCell = grid.index(start.x, start.y);
+    int goalCell = grid.index(goal.x, goal.y);
+    m_open.clear();
+    m_cost[startCell] = 0.0f;
+    m_parent[startCell] = -1;
+    m_stamps[startCell] = open;
+    m_open.push_back(Open{octile(start.x, start.y, goal.x, goal.y), startCell});
+
+    while (!m_open.empty()) {
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<Open>());
+        int cell = m_open.back().cell;
+        m_open.pop_back();
+        // Stale duplicate of a cell reached more cheaply since
+        if (m_stamps[cell] == closed) {
+            continue;
+        }
+        m_stamps[cell] = closed;
+        m_expanded++;
+
+        if (cell == goalCell) {
+            std::vector<glm::ivec2> path;
+            for (int at = goalCell; at != -1; at = m_parent[at]) {
+                path.push_back(glm::ivec2(at % grid.width(), at / grid.width()));
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        int x = cell % grid.width();
+        int y = cell / grid.width();
+        for (int direction = 0; direction < 8; direction++) {
+            if (!canStep(grid, x, y, direction)) {
+                continue;
+            }
+            int toX = x + s_offsetX[direction];
+            int toY = y + s_offsetY[direction];
+            int to = grid.index(toX, toY);
+            if (m_stamps[to] == closed) {
+                continue;
+            }
+            float cost = m_cost[cell] + s_stepLength[direction] * grid.cost(toX, toY);
+            if (m_stamps[to] == open && cost >= m_cost[to]) {
+                continue;
+            }
+            m_stamps[to] = open;
+            m_cost[to] = cost;
+            m_parent[to] = cell;
+            m_open.push_back(Open{cost + octile(toX, toY, goal.x, goal.y), to});
+            std::push_heap(m_open.begin(), m_open.end(), std::greater<Open>());
+        }
+    }
+    return {};
+}
+
+FlowField::FlowField(const NavGrid& grid, glm::ivec2 goal)
+    : m_goal(goal), m_gridVersion(grid.version()), m_width(grid.width()), m_height(grid.height()),
+    m_cellSize(grid.cellSize()), m_origin(grid.origin()) {
+    size_t cells = static_cast<size_t>(m_width) * m_height;
+    m_distance.assign(cells, s_infinity);
+    m_direction.assign(cells, s_noDirection);
+    if (!grid.isWalkable(goal.x, goal.y)) {
+        return;
+    }
+
+    struct Open {
+        float distance;
+        int cell;
+        bool operator>(const Open& other) const noexcept { return distance > other.distance; }
+    };
+    std::vector<Open> open;
+    int goalCell = grid.index(goal.x, goal.y);
+    m_distance[goalCell] = 0.0f;
+    open.push_back(Open{0.0f, goalCell});
+
+    // Expanding outwards from the goal, stepping from a cell onto the one it was reached from costs the latter
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<Open>());
+        Open current = open.back();
+        open.pop_back();
+        if (current.distance > m_distance[current.cell]) {
+            continue;
+        }
+        int x = current.cell % m_width;
+        int y = current.cell / m_width;
+        float enter = static_cast<float>(grid.cost(x, y));
+        for (int direction = 0; direction < 8; direction++) {
+            if (!canStep(grid, x, y, direction)) {
+                continue;
+            }
+            int from = grid.index(x + s_offsetX[direction], y + s_offsetY[direction]);
+            float distance = current.distance + s_stepLength[direction] * enter;
+            if (distance < m_distance[from]) {
+                m_distance[from] = distance;
+                m_direction[from] = static_cast<uint8_t>(direction ^ 1);
+                open.push_back(Open{distance, from});
+                std::push_heap(open.begin(), open.end(), std::greater<Open>());
+            }
+        }
+    }
+}
+
+bool FlowField::reachable(glm::ivec2 cell) const noexcept {
+    return distance(cell) != s_infinity;
+}
+
+float FlowField::distance(glm::ivec2 cell) const noexcept {
+    if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || cell.y >= m_height) {
+        return s_infinity;
+    }
+    return m_distance[cell.y * m_width + cell.x];
+}
+
+glm::fvec2 FlowField::direction(glm::ivec2 cell) const noexcept {
+    if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || cell.y >= m_height) {
+        return glm::fvec2(0.0f, 0.0f);
+    }
+    uint8_t direction = m_direction[cell.y * m_width + cell.x];
+    if (direction == s_noDirection) {
+        return glm::fvec2(0.0f, 0.0f);
+    }
+    float length = s_stepLength[direction];
+    return glm::fvec2(s_offsetX[direction] / length, s_offsetY[direction] / length);
+}
+
+glm::fvec2 FlowField::directionAt(glm::fvec2 point) const noexcept {
+    return direction(glm::ivec2(
+        static_cast<int>(std::floor((point.x - m_origin.x) / m_cellSize)),
+        static_cast<int>(std::floor((point.y - m_origin.y) / m_cellSize))
+    ));
+}
+
+bool FlowField::affectedBy(int cellIndex) const noexcept {
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (reachable(glm::ivec2(x + dx, y + dy))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/** Source tilemap/tilemap.h */
+class Tilemap;
+/** Source collisions/collider.h */
+class ICollider;
+
+/**
+ * Walkable cells for pathfinding, each with the cost of stepping onto it. 0 blocks a cell outright.
+ * Changes are logged per cell, so whoever caches paths over the grid can tell exactly what they invalidate, see Pathfinder.
+ */
+class NavGrid {
+public:
+    static constexpr uint8_t s_blocked = 0;
+
+    /** Cells start walkable at cost 1. origin is the world position of the top left corner. Throws on an empty grid */
+    NavGrid(int width, int height, float cellSize, glm::fvec2 origin = glm::fvec2(0.0f, 0.0f));
+
+    /** Throws out of bounds */
+    void setCost(int x, int y, uint8_t cost);
+    void setBlocked(int x, int y, bool blocked) { setCost(x, y, blocked ? s_blocked : 1); }
+    /** s_blocked out of bounds */
+    uint8_t cost(int x, int y) const noexcept {
+        return inBounds(x, y) ? m_cost[index(x, y)] : s_blocked;
+    }
+    bool isWalkable(int x, int y) const noexcept { return cost(x, y) != s_blocked; }
+    bool inBounds(int x, int y) const noexcept { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+
+    /** Blocks every cell whose centre is on a solid tile */
+    void blockSolidTiles(const Tilemap& tilemap);
+    /** Blocks every cell whose centre overlaps one of colliders. Meant for static geometry, it tests every cell against every collider */
+    void blockColliders(std::span<const ICollider* const> colliders);
+
+    /** Cell containing point, which may be out of bounds */
+    glm::ivec2 cellAt(glm::fvec2 point) const noexcept;
+    glm::fvec2 centre(glm::ivec2 cell) const noexcept;
+
+    int width() const noexcept { return m_width; }
+    int height() const noexcept { return m_height; }
+    float cellSize() const noexcept { return m_cellSize; }
+    glm::fvec2 origin() const noexcept { return m_origin; }
+    int index(int x, int y) const noexcept { return y * m_width + x; }
+    /** Changes whenever a cell does */
+    uint64_t version() const noexcept { return m_version; }
+
+    /** Indices of the cells changed since the last call, each once */
+    std::vector<int> takeChanges();
+
+private:
+    int m_width;
+    int m_height;
+    float m_cellSize;
+    glm::fvec2 m_origin;
+    std::vector<uint8_t> m_cost;
+    uint64_t m_version = 0;
+    std::vector<int> m_changes;
+    /** Per cell, whether it is in m_changes already */
+    std::vector<uint8_t> m_changed;
+};
+
+/**
+ * A* over a NavGrid, 8 connected without cutting corners. Keeps its buffers between searches and stamps cells
+ * rather than clearing them, so a search only costs the cells it actually visits. One per thread.
+ */
+class PathSearch {
+public:
+    /** Cells from start to goal, both included. Empty if there is no way */
+    std::vector<glm::ivec2> find(const NavGrid& grid, glm::ivec2 start, glm::ivec2 goal);
+    /** Cells expanded by the last search */
+    size_t expanded() const noexcept { return m_expanded; }
+
+private:
+    struct Open {
+        float estimate;
+        int cell;
+        bool operator>(const Open& other) const noexcept { return estimate > other.estimate; }
+    };
+
+    std::vector<float> m_cost;
+    std::vector<int> m_parent;
+    /** Cells whose m_cost and m_parent belong to this search have m_stamp - 1, m_stamp once closed */
+    std::vector<uint32_t> m_stamps;
+    uint32_t m_stamp = 0;
+    std::vector<Open> m_open;
+    size_t m_expanded = 0;
+};
+
+/**
+ * Direction towards a goal from every cell of a NavGrid, for any number of agents heading there to look up.
+ * Built once by a Dijkstra expansion from the goal, costing about as much as a single A* search across the whole grid.
+ */
+class FlowField {
+public:
+    static constexpr uint8_t s_noDirection = 8;
+
+    FlowField(const NavGrid& grid, glm::ivec2 goal);
+
+    glm::ivec2 goal() const noexcept { return m_goal; }
+    /** Of the grid it was built from */
+    uint64_t gridVersion() const noexcept { return m_gridVersion; }
+
+    bool reachable(glm::ivec2 cell) const noexcept;
+    /** Cost to reach the goal, infinity if it can't be */
+    float distance(glm::ivec2 cell) const noexcept;
+    /** Unit direction towards the next cell on the way, zero at the goal or where it can't be reached */
+    glm::fvec2 direction(glm::ivec2 cell) const noexcept;
+    /** direction() of the cell containing point */
+    glm::fvec2 directionAt(glm::fvec2 point) const noexcept;
+
+    /** Whether changing the cell may change the field, that is if it or any neighbour was reachable */
+    bool affectedBy(int cellIndex) const noexcept;
+
+private:
+    glm::ivec2 m_goal;
+    uint64_t m_gridVersion;
+    int m_width;
+    int m_height;
+    float m_cellSize;
+    glm::fvec2 m_origin;
+    std::vector<float> m_distance;
+    /** Index into the neighbour offsets, or s_noDirection */
+    std::vector<uint8_t> m_direction;
+};
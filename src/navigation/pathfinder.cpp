@@ -0,0 +1,205 @@
+#include <algorithm>
+
+#include <navigation/pathfinder.h>
+#include <meta/ApplicationContext.h>
+
+Pathfinder::Pathfinder(NavGrid grid, unsigned workers, size_t maxFlowFields)
+    : m_grid(std::move(grid)), m_maxFlowFields(std::max<size_t>(maxFlowFields, 1)) {
+    m_grid.takeChanges();
+    m_published = std::make_shared<const NavGrid>(m_grid);
+    for (unsigned i = 0; i < workers; i++) {
+        m_workers.emplace_back(&Pathfinder::work, this);
+    }
+}
+
+Pathfinder::~Pathfinder() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_workSignal.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void Pathfinder::update() {
+    if (m_workers.empty()) {
+        while (!m_jobs.empty()) {
+            Job job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            job(m_inlineSearch);
+        }
+    }
+    collectFinished();
+
+    std::vector<int> changes = m_grid.takeChanges();
+    if (!changes.empty()) {
+        m_published = std::make_shared<const NavGrid>(m_grid);
+        for (auto& [goal, entry] : m_fields) {
+            if (entry.building) {
+                entry.staleOnArrival = true;
+            } else if (entry.field != nullptr && !entry.stale) {
+                entry.stale = std::any_of(changes.begin(), changes.end(), [&](int cell) {
+                    return cell == goal || entry.field->affectedBy(cell);
+                });
+            }
+        }
+    }
+
+    trimFlowFields();
+    m_updates++;
+}
+
+void Pathfinder::finish() {
+    if (!m_workers.empty()) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleSignal.wait(lock, [this]() { return m_jobs.empty() && m_busy == 0; });
+    }
+    update();
+}
+
+PathRequestId Pathfinder::requestPath(glm::ivec2 start, glm::ivec2 goal) {
+    PathRequestId id = m_nextRequest++;
+    m_requested.insert(id);
+    enqueue([this, id, start, goal, grid = m_published](PathSearch& search) {
+        PathResult result{search.find(*grid, start, goal), grid->version()};
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishedPaths.emplace_back(id, std::move(result));
+    });
+    return id;
+}
+
+std::optional<PathResult> Pathfinder::takePath(PathRequestId id) {
+    auto it = m_paths.find(id);
+    if (it == m_paths.end()) {
+        return std::nullopt;
+    }
+    PathResult result = std::move(it->second);
+    m_paths.erase(it);
+    m_requested.erase(id);
+    return result;
+}
+
+void Pathfinder::cancelPath(PathRequestId id) noexcept {
+    // Still searched for if already queued, the result is dropped on arrival
+    m_requested.erase(id);
+    m_paths.erase(id);
+}
+
+std::shared_ptr<const FlowField> Pathfinder::flowField(glm::ivec2 goal) {
+    if (!m_grid.inBounds(goal.x, goal.y)) {
+        return nullptr;
+    }
+    FieldEntry& entry = m_fields[m_grid.index(goal.x, goal.y)];
+    entry.lastUsed = m_updates;
+    if ((entry.field == nullptr || entry.stale) && !entry.building) {
+        entry.building = true;
+        entry.stale = false;
+        m_fieldsBuilt++;
+        enqueue([this, goal, grid = m_published](PathSearch&) {
+            auto field = std::make_shared<const FlowField>(*grid, goal);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finishedFields.push_back(std::move(field));
+        });
+    }
+    return entry.field;
+}
+
+void Pathfinder::enqueue(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_workSignal.notify_one();
+}
+
+void Pathfinder::work() {
+    PathSearch search;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_workSignal.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy++;
+        lock.unlock();
+        job(search);
+        lock.lock();
+        m_busy--;
+        if (m_jobs.empty() && m_busy == 0) {
+            m_idleSignal.notify_all();
+        }
+    }
+}
+
+void Pathfinder::collectFinished() {
+    std::vector<std::pair<PathRequestId, PathResult>> paths;
+    std::vector<std::shared_ptr<const FlowField>> fields;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        paths.swap(m_finishedPaths);
+        fields.swap(m_finishedFields);
+    }
+
+    for (auto& [id, result] : paths) {
+        if (m_requested.contains(id)) {
+            m_paths.emplace(id, std::move(result));
+        }
+    }
+    for (std::shared_ptr<const FlowField>& field : fields) {
+        FieldEntry& entry = m_fields[m_grid.index(field->goal().x, field->goal().y)];
+        entry.field = std::move(field);
+        entry.building = false;
+        entry.stale = entry.staleOnArrival;
+        entry.staleOnArrival = false;
+    }
+}
+
+void Pathfinder::trimFlowFields() {
+    while (m_fields.size() > m_maxFlowFields) {
+        auto oldest = m_fields.end();
+        for (auto it = m_fields.begin(); it != m_fields.end(); ++it) {
+            if (!it->second.building && (oldest == m_fields.end() || it->second.lastUsed < oldest->second.lastUsed)) {
+                oldest = it;
+            }
+        }
+        // Everything is being built, trimmed once it arrived
+        if (oldest == m_fields.end()) {
+            return;
+        }
+        m_fields.erase(oldest);
+    }
+}
+
+FlowFieldAgent::FlowFieldAgent(ComponentRetriever compRet, Pathfinder& pathfinder, float speed)
+    : IDependentEntityComponent(compRet), speed(speed), m_pathfinder(&pathfinder) {
+    m_transform = requireComponent<TransformComponent>("FlowFieldAgent requires a TransformComponent");
+}
+
+void FlowFieldAgent::tick(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    update(ctx->frames().deltaT());
+}
+
+bool FlowFieldAgent::update(float deltaT) noexcept {
+    if (!m_hasGoal) {
+        return true;
+    }
+    std::shared_ptr<const FlowField> field = m_pathfinder->flowField(m_goalCell);
+    if (field == nullptr) {
+        return false;
+    }
+    // Steered where it is in the world, but moved by its local position. The same as long as parents don't rotate or scale
+    glm::fvec2 direction = field->directionAt(glm::fvec2(m_transform->worldPosition()));
+    m_transform->position.x += direction.x * speed * deltaT;
+    m_transform->position.y += direction.y * speed * deltaT;
+    return true;
+}
+
+void FlowFieldAgent::setGoal(glm::fvec2 goal) noexcept {
+    m_goalCell = m_pathfinder->grid().cellAt(goal);
+    m_hasGoal = true;
+}
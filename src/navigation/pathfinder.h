@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <entities/components.h>
+#include <meta/processing.h>
+#include <navigation/navGrid.h>
+
+using PathRequestId = uint64_t;
+
+struct PathResult {
+    /** From start to goal, both included. Empty if there is no way */
+    std::vector<glm::ivec2> cells;
+    /** Of the grid it was found on, compare with NavGrid::version() to tell whether it may be out of date */
+    uint64_t gridVersion;
+};
+
+/**
+ * Paths and flow fields over a NavGrid, computed on worker threads so the tick only pays for handing requests over.
+ * Workers search a copy of the grid, published by update() whenever grid() changed. Flow fields are cached by goal,
+ * so a crowd chasing the same target shares a single field, and a change only invalidates the fields it could affect.
+ * Everything but the workers themselves runs on the simulation thread.
+ */
+class Pathfinder {
+public:
+    /** With no workers, requests are run by update() instead, in order, which keeps replays deterministic */
+    explicit Pathfinder(NavGrid grid, unsigned workers = 2, size_t maxFlowFields = 32);
+    ~Pathfinder();
+    Pathfinder(const Pathfinder&) = delete;
+    Pathfinder& operator=(const Pathfinder&) = delete;
+
+    /** Edits are seen by requests made after the next update() */
+    NavGrid& grid() noexcept { return m_grid; }
+    const NavGrid& grid() const noexcept { return m_grid; }
+
+    /** Once per tick. Publishes changes to grid(), invalidates the flow fields they affect and collects finished work */
+    void update();
+    /** Waits for everything requested so far, then update()s. For tests and loading screens, rather than every tick */
+    void finish();
+
+    PathRequestId requestPath(glm::ivec2 start, glm::ivec2 goal);
+    /** The result once found by a previous update(), nullopt until then. Taking it forgets the request */
+    std::optional<PathResult> takePath(PathRequestId id);
+    void cancelPath(PathRequestId id) noexcept;
+
+    /**
+     * Shared field towards goal, nullptr until it was first built. Fields invalidated by changes to the grid
+     * keep being returned until their replacement is ready, so agents don't stall meanwhile.
+     */
+    std::shared_ptr<const FlowField> flowField(glm::ivec2 goal);
+
+    size_t cachedFlowFields() const noexcept { return m_fields.size(); }
+    /** Over the lifetime of the pathfinder, to tell how often invalidation leads to rebuilds */
+    size_t flowFieldsBuilt() const noexcept { return m_fieldsBuilt; }
+
+private:
+    using Job = std::function<void(PathSearch& search)>;
+
+    struct FieldEntry {
+        std::shared_ptr<const FlowField> field;
+        uint64_t lastUsed = 0;
+        bool building = false;
+        /** Invalidated, and to be rebuilt when next asked for */
+        bool stale = false;
+        /** Invalidated while building, so what is being built is stale already */
+        bool staleOnArrival = false;
+    };
+
+    NavGrid m_grid;
+    /** What workers search, replaced rather than modified */
+    std::shared_ptr<const NavGrid> m_published;
+    size_t m_maxFlowFields;
+    uint64_t m_updates = 0;
+    size_t m_fieldsBuilt = 0;
+
+    PathRequestId m_nextRequest = 0;
+    std::unordered_set<PathRequestId> m_requested;
+    std::unordered_map<PathRequestId, PathResult> m_paths;
+    /** By goal cell index */
+    std::unordered_map<int, FieldEntry> m_fields;
+
+    std::vector<std::thread> m_workers;
+    /** Guards everything below */
+    std::mutex m_mutex;
+    std::condition_variable m_workSignal;
+    std::condition_variable m_idleSignal;
+    std::deque<Job> m_jobs;
+    size_t m_busy = 0;
+    bool m_stopping = false;
+    std::vector<std::pair<PathRequestId, PathResult>> m_finishedPaths;
+    std::vector<std::shared_ptr<const FlowField>> m_finishedFields;
+    /** Runs jobs when there are no workers */
+    PathSearch m_inlineSearch;
+
+    void enqueue(Job job);
+    void work();
+    void collectFinished();
+    void trimFlowFields();
+};
+
+/** Moves its entity along the flow field towards a goal, shared by every agent with the same goal */
+class FlowFieldAgent : public IDependentEntityComponent, public ITickable {
+public:
+    /** pathfinder must outlive the agent */
+    FlowFieldAgent(ComponentRetriever compRet, Pathfinder& pathfinder, float speed);
+
+    void tick(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    /** Moves by speed times deltaT. Returns false while no flow field is ready */
+    bool update(float deltaT) noexcept;
+
+    /** World space */
+    void setGoal(glm::fvec2 goal) noexcept;
+    void clearGoal() noexcept { m_hasGoal = false; }
+
+    float speed = 1.0f;
+
+private:
+    TransformComponent* m_transform;
+    Pathfinder* m_pathfinder;
+    glm::ivec2 m_goalCell = glm::ivec2(0, 0);
+    bool m_hasGoal = false;
+};
@@ -6,6 +6,8 @@
 #include <scene/scene.h>
 #include <input/input.h>
 #include <meta/processing.h>
+#include <meta/pipeline.h>
+#include <meta/log.h>
 
 class Player : public IGameplayEntity {
 private:
@@ -14,7 +16,7 @@ private:
 public:
     Player(std::shared_ptr<ApplicationContext> appCtx) noexcept {
         auto screenBounds = appCtx->viewport().bounds();
-        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Screen bounds: %d %d", screenBounds->x, screenBounds->y);
+        Log::info("Screen bounds: {} {}", screenBounds->x, screenBounds->y);
         glm::fvec3 position = glm::fvec3(
             screenBounds->x * 0.5,
             screenBounds->y * 0.5, 
@@ -27,7 +29,7 @@ public:
         IGameplayEntity::tick(appCtx, ctx);
 
         // Move the player
-        auto input = appCtx->input();
+        const InputSnapshot& input = appCtx->input().snapshot();
         if (input.isDown(SDL_SCANCODE_W)) {
             m_transform->position.y -= 1.0f;
         }
@@ -48,17 +50,24 @@ public:
         SDL_Renderer& renderer = appCtx->frames().renderer();
 
         SDL_SetRenderDrawColor(&renderer, 0, 0, 255, 255);
+        glm::fvec3 position = m_transform->worldPosition();
         SDL_FRect rect{
-            m_transform->position.x, 
-            m_transform->position.y, 
+            position.x, 
+            position.y, 
             100.0f, 100.0f
         };
         bool drawSuccess = SDL_RenderFillRect(&renderer, &rect);
         if (!drawSuccess) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error: %s", SDL_GetError());
+            Log::error("Could not draw player: {}", SDL_GetError());
         }
     }
 
+    void capture(RenderSnapshot& snapshot) const noexcept override {
+        IGameplayEntity::capture(snapshot);
+
+        snapshot.pushRect(*m_transform, glm::fvec2(100.0f, 100.0f), SDL_Color{0, 0, 255, 255});
+    }
+
     float getZIndex() const noexcept { 
         return m_transform->position.z; 
     }
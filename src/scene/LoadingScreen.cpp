@@ -0,0 +1,18 @@
+#include <SDL3/SDL.h>
+
+#include <scene/scene.h>
+#include <meta/pipeline.h>
+
+void LoadingScreen::draw(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    SDL_Renderer& renderer = ctx->frames().renderer();
+
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(&renderer);
+
+    SDL_SetRenderDrawColor(&renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    SDL_RenderDebugText(&renderer, 8.0f, 8.0f, "Loading...");
+}
+
+void LoadingScreen::capture(RenderSnapshot& snapshot) const noexcept {
+    snapshot.clearColour = SDL_Color{0, 0, 0, SDL_ALPHA_OPAQUE};
+}
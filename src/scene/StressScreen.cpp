@@ -0,0 +1,193 @@
+#include <SDL3/SDL.h>
+#include <cmath>
+#include <algorithm>
+
+#include <scene/StressScreen.h>
+#include <collisions/collider.h>
+#include <meta/pipeline.h>
+#include <scene/tickScheduler.h>
+
+class StressEntity : public IGameplayEntity {
+private:
+    //ref cached locally for performance
+    TransformComponent* m_transform;
+    SDL_Color m_colour;
+
+public:
+    const ICollider* collider = nullptr;
+
+    StressEntity(glm::fvec3 position, glm::fvec3 direction, float force, int colliderKind, SDL_Color colour) : m_colour(colour) {
+        m_transform = addComponentAndGetRawPtr<TransformComponent>(position);
+        addComponent<ContinuousForceComponent>(direction, force);
+        if (colliderKind == 1) {
+            collider = addComponentAndGetRawPtr<SphereCollider>(2.0f);
+        } else if (colliderKind == 2) {
+            collider = addComponentAndGetRawPtr<BoxCollider>(glm::fvec3(2.0f, 2.0f, 2.0f));
+        }
+    }
+
+    void tick(std::shared_ptr<ApplicationContext> appCtx, std::shared_ptr<SceneContext> ctx, glm::fvec2 world) noexcept {
+        IGameplayEntity::tick(appCtx, ctx);
+
+        // Wrap around, so the field stays populated however long this runs
+        glm::fvec3& position = m_transform->position;
+        position.x = position.x - world.x * std::floor(position.x / world.x);
+        position.y = position.y - world.y * std::floor(position.y / world.y);
+    }
+
+    void draw(std::shared_ptr<ApplicationContext> appCtx) noexcept {
+        SDL_Renderer& renderer = appCtx->frames().renderer();
+        SDL_SetRenderDrawColor(&renderer, m_colour.r, m_colour.g, m_colour.b, m_colour.a);
+        glm::fvec3 position = m_transform->worldPosition();
+        SDL_FRect rect{position.x, position.y, 4.0f, 4.0f};
+        SDL_RenderFillRect(&renderer, &rect);
+    }
+
+    void capture(RenderSnapshot& snapshot) const noexcept override {
+        snapshot.pushRect(*m_transform, glm::fvec2(4.0f, 4.0f), m_colour);
+    }
+};
+
+StressScreen::StressScreen(std::shared_ptr<ApplicationContext> appCtx, StressConfig config)
+    : IScene::IScene(appCtx), m_config(config), m_random(config.seed == 0 ? 1 : config.seed) {
+    const glm::fvec2* bounds = appCtx->viewport().bounds();
+    m_world = glm::fvec2(std::max(bounds->x, 1.0f), std::max(bounds->y, 1.0f));
+    m_sceneCtx = std::make_shared<SceneContext>();
+
+    // Stages take far longer than frames do at a million entities
+    m_stageTimes.fill(RollingHistogram(600, 0.5, 2000));
+
+    if (m_config.tickLod) {
+        m_scheduler = std::make_unique<TickScheduler>();
+        m_scheduler->setFocus(m_world * 0.5f);
+        m_scheduler->setView(SDL_FRect{m_world.x * 0.25f, m_world.y * 0.25f, m_world.x * 0.5f, m_world.y * 0.5f});
+    }
+
+    IdSpace::Scope ids(m_sceneCtx->ids());
+    m_entities.reserve(m_config.entities);
+    m_colliders.reserve(m_config.entities);
+    for (size_t i = 0; i < m_config.entities; i++) {
+        m_entities.push_back(spawn(i));
+        m_colliders.push_back(m_entities.back()->collider);
+        m_sceneCtx->registerEntity(m_entities.back().get());
+        if (m_scheduler != nullptr) {
+            m_scheduler->add(m_entities.back().get());
+        }
+    }
+
+    for (size_t i = 0; i < m_config.probes; i++) {
+        m_probes.push_back(glm::fvec3(randomFloat(0.0f, m_world.x), randomFloat(0.0f, m_world.y), 0.0f));
+    }
+    m_overlapping.assign(m_colliders.size() * m_probes.size(), 0);
+}
+
+StressScreen::~StressScreen() = default;
+
+uint32_t StressScreen::nextRandom() noexcept {
+    // xorshift32, fast and the same on every platform, unlike std distributions
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+
+float StressScreen::randomFloat(float min, float max) noexcept {
+    return min + (max - min) * (nextRandom() / 4294967296.0f);
+}
+
+std::unique_ptr<StressEntity> StressScreen::spawn(size_t index) {
+    glm::fvec3 position(randomFloat(0.0f, m_world.x), randomFloat(0.0f, m_world.y), 0.0f);
+    float angle = randomFloat(0.0f, 6.2831853f);
+    glm::fvec3 direction(std::cos(angle), std::sin(angle), 0.0f);
+
+    int colliderKind = 0;
+    if (randomFloat(0.0f, 1.0f) < m_config.colliderFraction) {
+        colliderKind = index % 2 == 0 ? 1 : 2;
+    }
+    SDL_Color colour{
+        static_cast<Uint8>(64 + nextRandom() % 192),
+        static_cast<Uint8>(64 + nextRandom() % 192),
+        static_cast<Uint8>(64 + nextRandom() % 192),
+        SDL_ALPHA_OPAQUE
+    };
+    return std::make_unique<StressEntity>(position, direction, randomFloat(0.5f, 2.0f), colliderKind, colour);
+}
+
+void StressScreen::tick(std::shared_ptr<ApplicationContext> appCtx) {
+    double start = FrameStatistics::now();
+    if (m_scheduler != nullptr) {
+        m_scheduler->tick(appCtx, [&](IGameplayEntity& entity) {
+            static_cast<StressEntity&>(entity).tick(appCtx, m_sceneCtx, m_world);
+        });
+    } else {
+        for (const auto& entity : m_entities) {
+            entity->tick(appCtx, m_sceneCtx, m_world);
+        }
+    }
+
+    double collisionsStart = FrameStatistics::now();
+    size_t hits = 0;
+    for (size_t i = 0; i < m_colliders.size(); i++) {
+        if (m_colliders[i] == nullptr) {
+            continue;
+        }
+        for (size_t p = 0; p < m_probes.size(); p++) {
+            bool overlaps = m_colliders[i]->overlaps(&m_probes[p]);
+            hits += overlaps;
+            uint8_t& overlapped = m_overlapping[i * m_probes.size() + p];
+            if (overlaps == static_cast<bool>(overlapped)) {
+                continue;
+            }
+            // Probes aren't entities, so the other side is -1
+            long long entityId = m_entities[i]->getEntityId();
+            if (overlaps) {
+                m_sceneCtx->events().publish(CollisionBegan{entityId, -1});
+            } else {
+                m_sceneCtx->events().publish(CollisionEnded{entityId, -1});
+            }
+            overlapped = overlaps;
+        }
+    }
+    m_hits = hits;
+
+    double eventsStart = FrameStatistics::now();
+    size_t churn = static_cast<size_t>(m_entities.size() * m_config.churn);
+    IdSpace::Scope ids(m_sceneCtx->ids());
+    for (size_t i = 0; i < churn; i++) {
+        size_t index = m_nextChurn;
+        m_nextChurn = (m_nextChurn + 1) % m_entities.size();
+        if (m_scheduler != nullptr) {
+            m_scheduler->remove(m_entities[index].get());
+        }
+        m_entities[index] = spawn(index);
+        m_colliders[index] = m_entities[index]->collider;
+        std::fill_n(m_overlapping.begin() + index * m_probes.size(), m_probes.size(), 0);
+        m_sceneCtx->registerEntity(m_entities[index].get());
+        if (m_scheduler != nullptr) {
+            m_scheduler->add(m_entities[index].get());
+        }
+    }
+    m_sceneCtx->events().dispatch();
+    double end = FrameStatistics::now();
+
+    m_stageTimes[static_cast<size_t>(StressStage::Entities)].push(collisionsStart - start);
+    m_stageTimes[static_cast<size_t>(StressStage::Collisions)].push(eventsStart - collisionsStart);
+    m_stageTimes[static_cast<size_t>(StressStage::Events)].push(end - eventsStart);
+}
+
+void StressScreen::draw(std::shared_ptr<ApplicationContext> appCtx) noexcept {
+    SDL_Renderer& renderer = appCtx->frames().renderer();
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(&renderer);
+
+    for (const auto& entity : m_entities) {
+        entity->draw(appCtx);
+    }
+}
+
+void StressScreen::capture(RenderSnapshot& snapshot) const noexcept {
+    snapshot.clearColour = SDL_Color{0, 0, 0, SDL_ALPHA_OPAQUE};
+    for (const auto& entity : m_entities) {
+        entity->capture(snapshot);
+    }
+}
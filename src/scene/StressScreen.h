@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <scene/scene.h>
+#include <meta/frameStats.h>
+
+/** Source collisions/collider.h */
+class ICollider;
+
+struct StressConfig {
+    size_t entities = 10000;
+    /** Fraction of entities with a collider, alternating sphere and box */
+    float colliderFraction = 0.5f;
+    /** Points tested against every collider each tick */
+    size_t probes = 4;
+    /** Fraction of entities destroyed and respawned each tick, to exercise registration and events */
+    float churn = 0.001f;
+    uint32_t seed = 1;
+    /** Tick through a TickScheduler, as if a camera showed the middle of the world */
+    bool tickLod = false;
+};
+
+enum class StressStage {
+    Entities,
+    Collisions,
+    Events,
+    Count
+};
+
+/** Source scene/StressScreen.cpp */
+class StressEntity;
+/** Source scene/tickScheduler.h */
+class TickScheduler;
+
+/**
+ * Lots of moving entities, shaped like production content: transforms, forces, colliders, and a rect each to draw.
+ * Timed per stage, see main.cpp for the --stress harness reporting on it.
+ */
+class StressScreen : public IScene, public ISnapshotDrawable {
+public:
+    StressScreen(std::shared_ptr<ApplicationContext> appCtx, StressConfig config);
+    ~StressScreen();
+
+    void tick(std::shared_ptr<ApplicationContext> appCtx) override;
+    void draw(std::shared_ptr<ApplicationContext> appCtx) noexcept override;
+    void capture(RenderSnapshot& snapshot) const noexcept override;
+
+    const RollingHistogram& stageTimes(StressStage stage) const noexcept { return m_stageTimes[static_cast<size_t>(stage)]; }
+    size_t entityCount() const noexcept { return m_entities.size(); }
+    /** Collider hits last tick. Mostly there so the collision stage can't be optimized away */
+    size_t hits() const noexcept { return m_hits; }
+    SceneMemory memory() const noexcept { return m_sceneCtx->memory(); }
+    /** nullptr unless StressConfig::tickLod */
+    const TickScheduler* scheduler() const noexcept { return m_scheduler.get(); }
+
+private:
+    StressConfig m_config;
+    glm::fvec2 m_world;
+    std::shared_ptr<SceneContext> m_sceneCtx;
+    std::vector<std::unique_ptr<StressEntity>> m_entities;
+    std::vector<const ICollider*> m_colliders;
+    std::vector<glm::fvec3> m_probes;
+    /** Per collider and probe, whether they overlapped last tick. CollisionBegan and CollisionEnded are published on changes */
+    std::vector<uint8_t> m_overlapping;
+    std::unique_ptr<TickScheduler> m_scheduler;
+    std::array<RollingHistogram, static_cast<size_t>(StressStage::Count)> m_stageTimes;
+    size_t m_nextChurn = 0;
+    size_t m_hits = 0;
+    uint32_t m_random;
+
+    std::unique_ptr<StressEntity> spawn(size_t index);
+    uint32_t nextRandom() noexcept;
+    float randomFloat(float min, float max) noexcept;
+};
@@ -2,9 +2,11 @@
 #include <memory>
 
 #include <scene/scene.h>
+#include <meta/pipeline.h>
+#include <meta/log.h>
 #include <player/player.cpp>
 
-class TestScreen : public IScene {
+class TestScreen : public IScene, public ISnapshotDrawable {
 private:
     std::unique_ptr<Player> m_player;
     std::shared_ptr<SceneContext> m_sceneCtx;
@@ -13,11 +15,20 @@ public:
     TestScreen(std::shared_ptr<ApplicationContext> appCtx) noexcept : IScene::IScene(appCtx) {
         m_player = std::make_unique<Player>(appCtx);
         m_sceneCtx = std::make_shared<SceneContext>();
+        // Root of everything attached to the player. The scene context, and the hierarchy with it, goes before the player
+        m_sceneCtx->transforms().add(m_player->getComponent<TransformComponent>());
     };
     ~TestScreen() = default;
 
     void tick(std::shared_ptr<ApplicationContext> appCtx) noexcept override {
         m_player->tick(appCtx, m_sceneCtx);
+        try {
+            m_sceneCtx->behaviours()->update(appCtx->frames().deltaT(), appCtx->input().snapshot());
+        } catch (std::exception& e) {
+            Log::error("Behaviour failed, it was stopped: {}", e.what());
+        }
+        m_sceneCtx->transforms().update();
+        m_sceneCtx->events().dispatch();
     }
     
     void draw(std::shared_ptr<ApplicationContext> appCtx) noexcept override {
@@ -28,4 +39,9 @@ public:
 
         m_player->draw(appCtx);
     }
+
+    void capture(RenderSnapshot& snapshot) const noexcept override {
+        snapshot.clearColour = SDL_Color{0, 0, 0, SDL_ALPHA_OPAQUE};
+        m_player->capture(snapshot);
+    }
 };
@@ -0,0 +1,68 @@
+#include <new>
+
+#include <scene/prefab.h>
+
+PrefabInstances::~PrefabInstances() {
+    destroyAll();
+}
+
+PrefabInstances& PrefabInstances::operator=(PrefabInstances&& other) noexcept {
+    if (this != &other) {
+        destroyAll();
+        m_entities = std::move(other.m_entities);
+        m_arena = std::move(other.m_arena);
+    }
+    return *this;
+}
+
+void PrefabInstances::destroy(size_t index) noexcept {
+    if (m_entities[index] != nullptr) {
+        m_entities[index]->~IGameplayEntity();
+        m_entities[index] = nullptr;
+    }
+}
+
+void PrefabInstances::destroyAll() noexcept {
+    for (size_t i = m_entities.size(); i > 0; i--) {
+        destroy(i - 1);
+    }
+    m_entities.clear();
+}
+
+PrefabInstances Prefab::instantiate(size_t count) const {
+    size_t perInstance = sizeof(IGameplayEntity);
+    size_t plainParts = 0;
+    for (const Part& part : m_parts) {
+        if (part.size == 0) {
+            perInstance += sizeof(PlainComponentRef);
+            plainParts++;
+        } else {
+            perInstance += part.size + s_bookkeepingPerComponent;
+        }
+    }
+
+    PrefabInstances instances;
+    instances.m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>(count * perInstance + 256);
+    instances.m_entities.reserve(count);
+    std::pmr::memory_resource* arena = instances.m_arena.get();
+
+    // Entities first, then all components of a type back to back
+    std::byte* entityStorage = static_cast<std::byte*>(arena->allocate(count * sizeof(IGameplayEntity), alignof(IGameplayEntity)));
+    std::vector<std::byte*> partStorage;
+    partStorage.reserve(m_parts.size());
+    for (const Part& part : m_parts) {
+        partStorage.push_back(part.size == 0 ? nullptr : static_cast<std::byte*>(arena->allocate(count * part.size, part.align)));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        IGameplayEntity* entity = new (entityStorage + i * sizeof(IGameplayEntity)) IGameplayEntity(arena);
+        // Listed straight away, so it is cleaned up if a component below throws
+        instances.m_entities.push_back(entity);
+        entity->m_components.reserve(m_parts.size() - plainParts);
+        entity->m_plainComponents.reserve(plainParts);
+        for (size_t p = 0; p < m_parts.size(); p++) {
+            m_parts[p].construct(*entity, m_parts[p].size == 0 ? nullptr : partStorage[p] + i * m_parts[p].size);
+        }
+    }
+    return instances;
+}
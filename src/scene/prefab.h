@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <cstddef>
+
+#include <entities/entity.h>
+#include <scene/scene.h>
+
+/**
+ * Entities instantiated from a Prefab, and the storage they and their components live in.
+ * Instances are IGameplayEntity, destroyed along with this or individually through destroy, never with delete.
+ */
+class PrefabInstances {
+public:
+    PrefabInstances() = default;
+    ~PrefabInstances();
+
+    PrefabInstances(const PrefabInstances&) = delete;
+    PrefabInstances& operator=(const PrefabInstances&) = delete;
+    PrefabInstances(PrefabInstances&& other) noexcept = default;
+    PrefabInstances& operator=(PrefabInstances&& other) noexcept;
+
+    size_t size() const noexcept { return m_entities.size(); }
+    /** nullptr once destroyed */
+    IGameplayEntity* operator[](size_t index) const noexcept { return m_entities[index]; }
+    const std::vector<IGameplayEntity*>& entities() const noexcept { return m_entities; }
+
+    /** Runs the destructor of a single instance. Its storage is only released along with all others */
+    void destroy(size_t index) noexcept;
+
+private:
+    friend class Prefab;
+
+    /** Destroyed last, everything else lives in it */
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+    std::vector<IGameplayEntity*> m_entities;
+
+    void destroyAll() noexcept;
+};
+
+/**
+ * A set of components with the arguments to construct them with. Instantiating N at once allocates a single arena,
+ * laid out as all entities followed by one contiguous array per component type, and constructs everything in place.
+ * Components are constructed rather than copied, so each gets its own id, and dependent ones find their siblings.
+ */
+class Prefab {
+public:
+    Prefab() = default;
+
+    /**
+     * Constructed in the order added, so add dependencies first. Arguments are copied, and passed to every instance.
+     * Plain components live in their own pool rather than the arena, and still end up contiguous.
+     */
+    template<EntityComponent T, typename... Args>
+    Prefab& with(Args... args) {
+        if constexpr (PlainComponent<T>) {
+            m_parts.push_back(Part{0, 1, [args...](IEntity& entity, void*) {
+                entity.template addComponent<T>(args...);
+            }});
+        } else {
+            m_parts.push_back(Part{sizeof(T), alignof(T), [args...](IEntity& entity, void* storage) {
+                entity.template emplacePooledComponent<T>(storage, args...);
+            }});
+        }
+        return *this;
+    }
+
+    /** Throws whatever a component constructor throws, after destroying what was constructed so far */
+    PrefabInstances instantiate(size_t count) const;
+
+private:
+    struct Part {
+        /** 0 for plain components, which take no storage from the arena */
+        size_t size;
+        size_t align;
+        std::function<void(IEntity& entity, void* storage)> construct;
+    };
+
+    /** Rough size of a component map node and its share of buckets, to size the arena so it never grows */
+    static constexpr size_t s_bookkeepingPerComponent = 96;
+
+    std::vector<Part> m_parts;
+};
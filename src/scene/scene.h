@@ -1,19 +1,33 @@
 #pragma once
 
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <atomic>
+#include <format>
+
 #include <meta/ApplicationContext.h>
 #include <entities/entity.h>
+#include <entities/hierarchy.h>
+#include <entities/behaviour.h>
 #include <meta/processing.h>
 
 class IScene : public IDrawable, public ITickable {
 private:
-    // Simple id for each scene
-    static inline int s_id = 0;
+    // Simple id for each scene. Scenes may be built on a loader thread
+    static inline std::atomic<int> s_id = 0;
     int m_id;
 public:
-    IScene(std::shared_ptr<ApplicationContext> ctx) noexcept : m_id(s_id++) {};
+    IScene(std::shared_ptr<ApplicationContext> ctx) noexcept : m_id(s_id.fetch_add(1, std::memory_order_relaxed)) {};
     virtual ~IScene() = default;
-    void onTearDown() noexcept {};
-    void onDrawCallRisingEdge() noexcept {};
+    /**
+     * Called on the main thread when the scene becomes active. Scenes may be constructed on a loader thread,
+     * so anything touching the renderer, like textures, is created here rather than in the constructor
+     */
+    virtual void onEnter(std::shared_ptr<ApplicationContext>) noexcept {};
+    /** Called on the main thread right before the scene is destroyed */
+    virtual void onTearDown() noexcept {};
+    virtual void onDrawCallRisingEdge() noexcept {};
 
     int getSceneId() const noexcept { return m_id; }
 };
@@ -27,13 +41,25 @@ public:
     void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override;
 };
 
+/** Shown while the next scene is built on a loader thread, see SceneManager::changeSceneAsync. Cheap to construct */
+class LoadingScreen : public IScene, public ISnapshotDrawable {
+public:
+    LoadingScreen(std::shared_ptr<ApplicationContext> ctx) noexcept : IScene::IScene(ctx) {};
+    ~LoadingScreen() = default;
+
+    void tick(std::shared_ptr<ApplicationContext>) override {};
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    void capture(RenderSnapshot& snapshot) const noexcept override;
+};
+
 //Forward declaration
 class SceneContext;
 
 /** Anything in a scene, that is drawn and or ticked. Could be the player. Could be a wall. Who knows? */
-class IGameplayEntity : public IEntity, public IDrawable {
+class IGameplayEntity : public IEntity, public IDrawable, public ISnapshotDrawable {
 public:
     IGameplayEntity() = default;
+    explicit IGameplayEntity(std::pmr::memory_resource* resource) : IEntity(resource) {};
     virtual ~IGameplayEntity() = default;
 
     void tick(std::shared_ptr<ApplicationContext> appCtx, std::shared_ptr<SceneContext> ctx) noexcept {
@@ -46,33 +72,163 @@ public:
             drawable->draw(ctx);
         });
     };
+    void capture(RenderSnapshot& snapshot) const noexcept override {
+        forEachComponent<ISnapshotDrawable>([&](ISnapshotDrawable* drawable) {
+            drawable->capture(snapshot);
+        });
+    };
+};
+
+/** What the entities registered with a SceneContext take up, see MemoryAccounting for totals per type */
+struct SceneMemory {
+    size_t entities = 0;
+    size_t components = 0;
+    /** sizeof each component, not counting anything they allocate themselves */
+    size_t componentBytes = 0;
+    /** sizeof each entity's own type, see IEntity::accountAs */
+    size_t entityBytes = 0;
+    /** Most entities registered at once, and the most entityBytes, since the scene was made */
+    size_t peakEntities = 0;
+    size_t peakEntityBytes = 0;
+    /**
+     * Heap allocations last frame of each entity and component type in the scene, see MemoryAccounting::onFrame.
+     * Counted per type, so instances of the same types elsewhere count too
+     */
+    uint64_t allocationsLastFrame = 0;
 };
 
 class SceneContext : public IEntity {
 public:
-    SceneContext() = default;
-    ~SceneContext() = default;
+    SceneContext() : m_behaviours(std::make_shared<BehaviourScheduler>(&m_events)) {
+        m_events.subscribe<EntityDestroyed>([this](std::span<const EntityDestroyed> destroyed) {
+            handleEntityDestruction(destroyed);
+        });
+    };
+    ~SceneContext() {
+        // Behaviours may still hold on to entities, and are waiting on this bus
+        m_behaviours->clear();
+        // Forget the destroyed entities first, the rest must not publish into a bus that no longer exists
+        m_events.dispatch();
+        for (IGameplayEntity* entity : entities) {
+            entity->setEventBus(nullptr);
+        }
+    };
 
-    bool registerEntity(IGameplayEntity* entity) {
+    /** Entities whose type is exactly T are accounted as T from then on, see IEntity::accountAs */
+    template <std::derived_from<IGameplayEntity> T>
+    bool registerEntity(T* entity) {
         if (entity == nullptr) {
             throw std::runtime_error("Cannot register null entity");
         }
+        // Destroyed entities are only known by id, which is unique within its IdSpace alone
+        if (m_entitySpace == nullptr) {
+            m_entitySpace = &entity->idSpace();
+        } else if (m_entitySpace != &entity->idSpace()) {
+            throw std::runtime_error(std::format(
+                "Entity {} takes its id from another IdSpace than the entities already in this scene", entity->getEntityId()
+            ));
+        }
+
+        if (typeid(*entity) == typeid(T)) {
+            entity->template accountAs<T>();
+        }
 
         entities.push_back(entity);
-        entity->onDestruction(std::bind(&SceneContext::handleEntityDestruction, this, std::placeholders::_1));
+        entityIds.push_back(entity->getEntityId());
+        m_entityBytes.push_back(entity->memoryStats().size);
+        m_liveEntityBytes += entity->memoryStats().size;
+        m_peakEntities = std::max(m_peakEntities, entities.size());
+        m_peakEntityBytes = std::max(m_peakEntityBytes, m_liveEntityBytes);
+        entity->setEventBus(&m_events);
         return true;
     }
 
-    std::vector<IGameplayEntity*> getEntities() {
+    /** Entities destroyed since the last dispatch of events() are still listed, and must not be touched until then */
+    const std::vector<IGameplayEntity*>& getEntities() const noexcept {
         return entities;
     }
+
+    /** Walks all entities, meant for reporting rather than every frame */
+    SceneMemory memory() const noexcept {
+        SceneMemory memory;
+        memory.entities = entities.size();
+        memory.entityBytes = m_liveEntityBytes;
+        memory.peakEntities = m_peakEntities;
+        memory.peakEntityBytes = m_peakEntityBytes;
+
+        // A handful of types, a linear search beats hashing
+        std::vector<const TypeMemoryStats*> types;
+        auto countType = [&types](const TypeMemoryStats& stats) {
+            if (std::find(types.begin(), types.end(), &stats) == types.end()) {
+                types.push_back(&stats);
+            }
+        };
+        for (const IGameplayEntity* entity : entities) {
+            memory.components += entity->componentCount();
+            memory.componentBytes += entity->componentBytes();
+            countType(entity->memoryStats());
+            entity->forEachComponentStats(countType);
+        }
+        for (const TypeMemoryStats* stats : types) {
+            memory.allocationsLastFrame += stats->allocationsLastFrame;
+        }
+        return memory;
+    }
+
+    /** Dispatched by the scene at the end of its tick, see TestScreen */
+    EventBus& events() noexcept { return m_events; }
+    /** Updated by the scene after ticking its entities, see TestScreen */
+    TransformHierarchy& transforms() noexcept { return m_transforms; }
+    /** Updated by the scene after ticking its entities, see TestScreen. Shared with BehaviourComponents */
+    std::shared_ptr<BehaviourScheduler> behaviours() noexcept { return m_behaviours; }
+    /**
+     * Ids of this scene's entities, for those constructed under an IdSpace::Scope of it. Keeps them dense per scene,
+     * and independent of what other scenes or loader threads allocate. Such entities must be destroyed before the scene.
+     * A scene only registers entities of one IdSpace, this or any other
+     */
+    IdSpace& ids() noexcept { return m_ids; }
+
 private:
     std::vector<IGameplayEntity*> entities = {};
+    /** Parallel to entities. Destroyed entities can't be dereferenced, and their address may already be reused */
+    std::vector<long long> entityIds = {};
+    /** Parallel to entities, what each was accounted as when registered */
+    std::vector<size_t> m_entityBytes = {};
+    size_t m_liveEntityBytes = 0;
+    size_t m_peakEntities = 0;
+    size_t m_peakEntityBytes = 0;
+    /** Shared by all registered entities, set by the first one */
+    const IdSpace* m_entitySpace = nullptr;
     std::vector<IDrawable*> ui = {};
     std::vector<ITickable*> otherwiseTickable = {};
+    EventBus m_events;
+    TransformHierarchy m_transforms;
+    std::shared_ptr<BehaviourScheduler> m_behaviours;
+    std::vector<long long> m_destroyedScratch;
+    IdSpace m_ids;
 
-    void handleEntityDestruction(IEntity* entity) {
-        entities.erase(std::remove(entities.begin(), entities.end(), entity), entities.end());
+    /** One pass over all entities per batch, rather than one per destroyed entity */
+    void handleEntityDestruction(std::span<const EntityDestroyed> destroyed) {
+        std::vector<long long>& ids = m_destroyedScratch;
+        ids.clear();
+        for (const EntityDestroyed& event : destroyed) {
+            ids.push_back(event.entityId);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        size_t kept = 0;
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (!std::binary_search(ids.begin(), ids.end(), entityIds[i])) {
+                entities[kept] = entities[i];
+                entityIds[kept] = entityIds[i];
+                m_entityBytes[kept] = m_entityBytes[i];
+                kept++;
+            } else {
+                m_liveEntityBytes -= m_entityBytes[i];
+            }
+        }
+        entities.resize(kept);
+        entityIds.resize(kept);
+        m_entityBytes.resize(kept);
     }
 };
-
@@ -0,0 +1,167 @@
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+#include <scene/sceneManager.h>
+#include <meta/log.h>
+
+SceneManager::~SceneManager() {
+    if (m_loading.valid()) {
+        m_loading.wait();
+    }
+    while (!m_stack.empty()) {
+        tearDown(m_stack.back());
+        m_stack.pop_back();
+    }
+}
+
+void SceneManager::changeScene(IScene* scene) noexcept {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_generation++;
+    m_queuedFactory = nullptr;
+    m_queuedCtx.reset();
+    m_pending.push_back(PendingChange{ChangeType::Replace, std::unique_ptr<IScene>(scene), false});
+}
+
+void SceneManager::changeSceneAsync(std::shared_ptr<ApplicationContext> ctx, SceneFactory factory) {
+    if (factory == nullptr) {
+        throw std::runtime_error("Cannot load a scene without a factory");
+    }
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_generation++;
+    if (m_loading.valid()) {
+        m_queuedFactory = std::move(factory);
+        m_queuedCtx = ctx;
+        return;
+    }
+    startLoading(ctx, std::move(factory));
+}
+
+void SceneManager::pushOverlay(IScene* scene, bool pausesBelow) noexcept {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back(PendingChange{ChangeType::Push, std::unique_ptr<IScene>(scene), pausesBelow});
+}
+
+void SceneManager::popOverlay() noexcept {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back(PendingChange{ChangeType::Pop, nullptr, false});
+}
+
+bool SceneManager::isLoading() const noexcept {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return m_loading.valid() || m_queuedFactory != nullptr;
+}
+
+IScene* SceneManager::current() const noexcept {
+    return m_stack.empty() ? nullptr : m_stack.back().scene.get();
+}
+
+void SceneManager::startLoading(std::shared_ptr<ApplicationContext> ctx, SceneFactory factory) {
+    m_loadingGeneration = m_generation;
+    // The loader is owned by the context through us, so holding on to the context here would keep it alive forever
+    std::weak_ptr<ApplicationContext> weakCtx = ctx;
+    m_loading = std::async(std::launch::async, [factory = std::move(factory), weakCtx]() {
+        return factory(weakCtx.lock());
+    });
+}
+
+void SceneManager::collectLoaded() {
+    if (!m_loading.valid() || m_loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    std::unique_ptr<IScene> loaded;
+    try {
+        loaded = m_loading.get();
+    } catch (std::exception& e) {
+        Log::error("Scene failed to load, keeping the current one: {}", e.what());
+    }
+
+    // Anything requested since supersedes this load. It is simply dropped, it was never entered
+    if (loaded != nullptr && m_loadingGeneration == m_generation) {
+        m_pending.push_back(PendingChange{ChangeType::Replace, std::move(loaded), false});
+    }
+
+    if (m_queuedFactory != nullptr) {
+        startLoading(m_queuedCtx.lock(), std::move(m_queuedFactory));
+        m_queuedFactory = nullptr;
+        m_queuedCtx.reset();
+    }
+}
+
+void SceneManager::tearDown(Layer& layer) noexcept {
+    layer.scene->onTearDown();
+}
+
+void SceneManager::onDrawCallRisingEdge(std::shared_ptr<ApplicationContext> ctx) {
+    std::vector<PendingChange> changes;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        collectLoaded();
+        changes.swap(m_pending);
+    }
+
+    for (PendingChange& change : changes) {
+        switch (change.type) {
+            case ChangeType::Replace:
+                while (!m_stack.empty()) {
+                    tearDown(m_stack.back());
+                    m_stack.pop_back();
+                }
+                m_stack.push_back(Layer{std::move(change.scene), false});
+                m_stack.back().scene->onEnter(ctx);
+                break;
+            case ChangeType::Push:
+                m_stack.push_back(Layer{std::move(change.scene), change.pausesBelow});
+                m_stack.back().scene->onEnter(ctx);
+                break;
+            case ChangeType::Pop:
+                if (m_stack.size() > 1) {
+                    tearDown(m_stack.back());
+                    m_stack.pop_back();
+                }
+                break;
+        }
+    }
+
+    for (Layer& layer : m_stack) {
+        layer.scene->onDrawCallRisingEdge();
+    }
+}
+
+void SceneManager::onTick(std::shared_ptr<ApplicationContext> ctx) {
+    if (m_stack.empty()) {
+        return;
+    }
+
+    size_t first = m_stack.size() - 1;
+    while (first > 0 && !m_stack[first].pausesBelow) {
+        first--;
+    }
+    for (size_t i = first; i < m_stack.size(); i++) {
+        m_stack[i].scene->tick(ctx);
+    }
+}
+
+void SceneManager::onDraw(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    for (Layer& layer : m_stack) {
+        layer.scene->draw(ctx);
+    }
+}
+
+bool SceneManager::onCapture(RenderSnapshot& snapshot) const noexcept {
+    if (m_stack.empty()) {
+        return false;
+    }
+    for (const Layer& layer : m_stack) {
+        if (dynamic_cast<const ISnapshotDrawable*>(layer.scene.get()) == nullptr) {
+            return false;
+        }
+    }
+    for (const Layer& layer : m_stack) {
+        dynamic_cast<const ISnapshotDrawable*>(layer.scene.get())->capture(snapshot);
+    }
+    return true;
+}
@@ -1,18 +1,92 @@
 #pragma once
 
+#include <SDL3/SDL.h>
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <future>
+#include <functional>
+#include <cstdint>
 
 #include <scene/scene.h>
 #include <meta/ApplicationContext.h>
 
+/** Builds a scene. Runs on a loader thread, so it must not touch the renderer, see IScene::onEnter */
+using SceneFactory = std::function<std::unique_ptr<IScene>(std::shared_ptr<ApplicationContext> ctx)>;
+
+/**
+ * Owns the active scenes as a stack: a base scene, with overlays such as a pause menu on top.
+ * Every change is deferred to onDrawCallRisingEdge, where the simulation is idle and we are on the main thread,
+ * so scenes may request changes from within their own tick.
+ */
 class SceneManager {
 public:
     SceneManager() = default;
-    ~SceneManager() = default;
+    /** Waits for any scene still loading */
+    ~SceneManager();
+
+    SceneManager(const SceneManager&) = delete;
+    SceneManager& operator=(const SceneManager&) = delete;
 
-    void onTick(std::shared_ptr<ApplicationContext> ctx) const;
-    void onDraw(std::shared_ptr<ApplicationContext> ctx) const noexcept;
-    void onDrawCallRisingEdge() const noexcept;
-    void onEvent(SDL_Event* event) const noexcept;
+    /** Replace the whole stack with an already built scene. Supersedes any load in flight */
     void changeScene(IScene* scene) noexcept;
+    /**
+     * Build the next scene on a loader thread, while the current one keeps ticking and drawing.
+     * The whole stack is replaced on the first frame boundary after it completes. If another load is
+     * already in flight, this one starts once that finishes, and the result of that one is discarded.
+     */
+    void changeSceneAsync(std::shared_ptr<ApplicationContext> ctx, SceneFactory factory);
+    /** Overlays draw on top of everything below. If pausesBelow, scenes below it stop ticking until it is popped */
+    void pushOverlay(IScene* scene, bool pausesBelow = true) noexcept;
+    /** Pops the top scene, unless it is the only one */
+    void popOverlay() noexcept;
+
+    /** Applies pending changes. Main thread only, while no tick is in flight */
+    void onDrawCallRisingEdge(std::shared_ptr<ApplicationContext> ctx);
+    /** Ticks the top scene, and those below it down to the first overlay that pauses them */
+    void onTick(std::shared_ptr<ApplicationContext> ctx);
+    /** Draws every scene, bottom to top */
+    void onDraw(std::shared_ptr<ApplicationContext> ctx) noexcept;
+    /** Captures every scene, bottom to top. Returns false if any of them isn't an ISnapshotDrawable */
+    bool onCapture(RenderSnapshot& snapshot) const noexcept;
+
+    /** Top of the stack. nullptr until the first change has been applied */
+    IScene* current() const noexcept;
+    size_t depth() const noexcept { return m_stack.size(); }
+    bool isLoading() const noexcept;
+
+private:
+    struct Layer {
+        std::unique_ptr<IScene> scene;
+        bool pausesBelow;
+    };
+
+    enum class ChangeType {
+        Replace,
+        Push,
+        Pop
+    };
+
+    struct PendingChange {
+        ChangeType type;
+        std::unique_ptr<IScene> scene;
+        bool pausesBelow;
+    };
+
+    std::vector<Layer> m_stack;
+
+    /** Guards everything below, as changes may be requested from the tick thread */
+    mutable std::mutex m_pendingMutex;
+    std::vector<PendingChange> m_pending;
+    std::future<std::unique_ptr<IScene>> m_loading;
+    /** Generation of the replace m_loading was started for. Only the latest replace requested may be applied */
+    uint64_t m_loadingGeneration = 0;
+    uint64_t m_generation = 0;
+    SceneFactory m_queuedFactory;
+    std::weak_ptr<ApplicationContext> m_queuedCtx;
+
+    void startLoading(std::shared_ptr<ApplicationContext> ctx, SceneFactory factory);
+    /** Moves a completed load into m_pending, and starts the queued one if any */
+    void collectLoaded();
+    void tearDown(Layer& layer) noexcept;
 };
@@ -0,0 +1,198 @@
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <format>
+
+#include <scene/serialization.h>
+#include <collisions/collider.h>
+#include <types/mappedFile.h>
+#include <meta/log.h>
+
+static const char s_magic[4] = {'S', 'G', 'S', 'C'};
+static const uint16_t s_version = 1;
+static const uint32_t s_trivialBlock = 1;
+
+static uint32_t hashName(const char* name) noexcept {
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c != '\0'; c++) {
+        hash ^= static_cast<uint8_t>(*c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void padTo8(std::vector<std::byte>& out) {
+    out.resize((out.size() + 7) & ~size_t(7));
+}
+
+static size_t paddedTo8(size_t size) noexcept {
+    return (size + 7) & ~size_t(7);
+}
+
+SceneSerializer SceneSerializer::withBuiltinComponents() {
+    SceneSerializer serializer;
+    serializer.registerTrivial<TransformComponent>("TransformComponent",
+        &TransformComponent::position, &TransformComponent::scale, &TransformComponent::rotation);
+    serializer.registerPlain<HealthComponent>();
+
+    serializer.registerCustom<ContinuousForceComponent>("ContinuousForceComponent",
+        [](const ContinuousForceComponent& component, BinaryWriter& out) {
+            out.write(component.direction);
+            out.write(component.force);
+        },
+        [](IEntity& entity, BinaryReader& in) {
+            glm::fvec3 direction = in.read<glm::fvec3>();
+            float force = in.read<float>();
+            entity.addComponent<ContinuousForceComponent>(direction, force);
+        }
+    );
+    serializer.registerCustom<SphereCollider>("SphereCollider",
+        [](const SphereCollider& collider, BinaryWriter& out) { out.write(collider.radius()); },
+        [](IEntity& entity, BinaryReader& in) { entity.addComponent<SphereCollider>(in.read<float>()); }
+    );
+    serializer.registerCustom<BoxCollider>("BoxCollider",
+        [](const BoxCollider& collider, BinaryWriter& out) { out.write(collider.size()); },
+        [](IEntity& entity, BinaryReader& in) { entity.addComponent<BoxCollider>(in.read<glm::fvec3>()); }
+    );
+    serializer.registerCustom<PolygonCollider>("PolygonCollider",
+        [](const PolygonCollider& collider, BinaryWriter& out) {
+            out.write(static_cast<uint32_t>(collider.points().size()));
+            out.write(collider.points().data(), collider.points().size() * sizeof(glm::fvec3));
+        },
+        [](IEntity& entity, BinaryReader& in) {
+            uint32_t count = in.read<uint32_t>();
+            // Checked before allocating, a corrupt count could ask for gigabytes
+            if (size_t(count) * sizeof(glm::fvec3) > in.remaining()) {
+                throw std::runtime_error(std::format("PolygonCollider claims {} points, more than its record holds", count));
+            }
+            std::vector<glm::fvec3> points(count);
+            in.read(points.data(), points.size() * sizeof(glm::fvec3));
+            entity.addComponent<PolygonCollider>(std::move(points));
+        }
+    );
+    return serializer;
+}
+
+SceneSerializer::Codec SceneSerializer::makeCodec(const char* name, uint32_t recordSize) const {
+    Codec codec;
+    codec.type = hashName(name);
+    codec.name = name;
+    codec.recordSize = recordSize;
+    return codec;
+}
+
+void SceneSerializer::addCodec(Codec codec) {
+    if (findCodec(codec.type) != nullptr) {
+        throw std::runtime_error(std::format("Component {} is already registered, or its name collides with another", codec.name));
+    }
+    m_codecs.push_back(std::move(codec));
+}
+
+const SceneSerializer::Codec* SceneSerializer::findCodec(uint32_t type) const noexcept {
+    for (const Codec& codec : m_codecs) {
+        if (codec.type == type) {
+            return &codec;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::byte> SceneSerializer::serialize(const std::vector<IGameplayEntity*>& entities) const {
+    std::vector<std::byte> out(sizeof(SceneFileHeader));
+    SceneFileHeader header{};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.entityCount = static_cast<uint32_t>(entities.size());
+
+    std::vector<uint32_t> indices;
+    std::vector<std::byte> body;
+    // Trivial blocks first, see SceneFileHeader
+    for (bool trivialPass : {true, false}) {
+        for (const Codec& codec : m_codecs) {
+            if ((codec.recordSize != 0) != trivialPass) {
+                continue;
+            }
+            indices.clear();
+            body.clear();
+            codec.write(entities, indices, body);
+            if (indices.empty()) {
+                continue;
+            }
+
+            SceneBlockHeader block{};
+            block.type = codec.type;
+            block.flags = trivialPass ? s_trivialBlock : 0;
+            block.recordSize = codec.recordSize;
+            block.count = static_cast<uint32_t>(indices.size());
+            block.byteSize = paddedTo8(indices.size() * sizeof(uint32_t)) + paddedTo8(body.size());
+
+            BinaryWriter writer(out);
+            writer.write(block);
+            writer.write(indices.data(), indices.size() * sizeof(uint32_t));
+            padTo8(out);
+            writer.write(body.data(), body.size());
+            padTo8(out);
+            header.blockCount++;
+        }
+    }
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+
+void SceneSerializer::save(const char* path, const std::vector<IGameplayEntity*>& entities) const {
+    std::vector<std::byte> data = serialize(entities);
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        throw std::runtime_error(std::format("Could not open {} for writing", path));
+    }
+    size_t written = std::fwrite(data.data(), 1, data.size(), file);
+    std::fclose(file);
+    if (written != data.size()) {
+        throw std::runtime_error(std::format("Could not write scene to {}", path));
+    }
+}
+
+SceneEntities SceneSerializer::deserialize(const std::byte* data, size_t size) const {
+    BinaryReader in(data, size);
+    SceneFileHeader header = in.read<SceneFileHeader>();
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version) {
+        throw std::runtime_error("Not a scene file, or one of an unsupported version");
+    }
+
+    SceneEntities entities;
+    entities.reserve(header.entityCount);
+    for (uint32_t i = 0; i < header.entityCount; i++) {
+        entities.push_back(std::make_unique<IGameplayEntity>());
+    }
+
+    for (uint16_t b = 0; b < header.blockCount; b++) {
+        SceneBlockHeader block = in.read<SceneBlockHeader>();
+        BinaryReader body(in.take(block.byteSize), block.byteSize);
+
+        const Codec* codec = findCodec(block.type);
+        if (codec == nullptr) {
+            Log::warn("Skipping scene block of unknown component type {:08x}", block.type);
+            continue;
+        }
+        if (codec->recordSize != block.recordSize) {
+            throw std::runtime_error(std::format(
+                "Scene stores {} as {} bytes per component, but it is registered as {}", codec->name, block.recordSize, codec->recordSize
+            ));
+        }
+
+        // Mapped files are only guaranteed to be aligned to the header, which is why everything is padded to 8
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(body.take(paddedTo8(size_t(block.count) * sizeof(uint32_t))));
+        for (uint32_t i = 0; i < block.count; i++) {
+            if (indices[i] >= entities.size()) {
+                throw std::runtime_error(std::format("Scene block for {} refers to entity {} of {}", codec->name, indices[i], entities.size()));
+            }
+        }
+        codec->read(entities, indices, block.count, body);
+    }
+    return entities;
+}
+
+SceneEntities SceneSerializer::load(const char* path) const {
+    MappedFile file(path);
+    return deserialize(file.data(), file.size());
+}
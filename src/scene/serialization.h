@@ -0,0 +1,320 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <entities/entity.h>
+#include <entities/components.h>
+#include <meta/reflection.h>
+#include <scene/scene.h>
+
+/**
+ * On disk layout of a scene. Little endian, as every platform we ship on is.
+ * A SceneFileHeader is followed by one block per component type, each a SceneBlockHeader and its body.
+ * Blocks of trivially serialized components come first, so custom ones may depend on them when loaded.
+ */
+struct SceneFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t blockCount;
+    uint32_t entityCount;
+    uint32_t reserved;
+};
+
+/**
+ * Trivial blocks are the entity index of every record, then the records packed back to back.
+ * Custom blocks are the entity indices, then per record its size in bytes followed by the data.
+ * Both sections are padded to 8 bytes.
+ */
+struct SceneBlockHeader {
+    /** FNV-1a of the name the component was registered under */
+    uint32_t type;
+    uint32_t flags;
+    /** Bytes per record in trivial blocks, 0 in custom ones */
+    uint32_t recordSize;
+    uint32_t count;
+    /** Size of the body following this header */
+    uint64_t byteSize;
+};
+static_assert(sizeof(SceneFileHeader) == 16, "SceneFileHeader is written as is, and must not contain padding");
+static_assert(sizeof(SceneBlockHeader) == 24, "SceneBlockHeader is written as is, and must not contain padding");
+
+/** Appends trivially copyable values to a buffer */
+class BinaryWriter {
+public:
+    BinaryWriter(std::vector<std::byte>& out) : m_out(out) {};
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as is");
+        write(&value, sizeof(T));
+    }
+    void write(const void* data, size_t size) {
+        size_t offset = m_out.size();
+        m_out.resize(offset + size);
+        std::memcpy(m_out.data() + offset, data, size);
+    }
+
+private:
+    std::vector<std::byte>& m_out;
+};
+
+/** Reads trivially copyable values from a buffer it does not own. Throws rather than read past the end */
+class BinaryReader {
+public:
+    BinaryReader(const std::byte* data, size_t size) : m_data(data), m_size(size) {};
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as is");
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+    void read(void* out, size_t size) {
+        std::memcpy(out, take(size), size);
+    }
+    /** Returns a pointer to the next size bytes and skips past them */
+    const std::byte* take(size_t size) {
+        if (size > remaining()) {
+            throw std::runtime_error("Unexpected end of scene data");
+        }
+        const std::byte* at = m_data + m_offset;
+        m_offset += size;
+        return at;
+    }
+    size_t remaining() const noexcept { return m_size - m_offset; }
+
+private:
+    const std::byte* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+using SceneEntities = std::vector<std::unique_ptr<IGameplayEntity>>;
+
+/**
+ * Saves and loads the components of a set of entities. Components must be registered to be saved, anything else is skipped.
+ * Components made up of trivially copyable fields are stored per type as one contiguous block, and copied straight out of
+ * the mapped file on load. Plain components, see meta/reflection.h, describe their own fields.
+ * Anything else registers a custom save and load function.
+ */
+class SceneSerializer {
+public:
+    SceneSerializer() = default;
+
+    /** Registers the components in entities/components.h and collisions/collider.h */
+    static SceneSerializer withBuiltinComponents();
+
+    /**
+     * Store T as the given fields, packed back to back. The name identifies the block on disk, so it must not change.
+     * Adding or removing fields changes the record size, and old files will fail to load.
+     */
+    template<typename T, typename... Fields> requires StandaloneComponent<T> || PlainComponent<T>
+    void registerTrivial(const char* name, Fields T::*... fields) {
+        static_assert((std::is_trivially_copyable_v<Fields> && ...), "Fields of trivially serialized components must be trivially copyable");
+        static_assert(std::is_default_constructible_v<T>, "Trivially serialized components are default constructed, then have their fields copied in");
+        constexpr uint32_t recordSize = (sizeof(Fields) + ... + 0);
+
+        Codec codec = makeCodec(name, recordSize);
+        codec.write = [=](const std::vector<IGameplayEntity*>& entities, std::vector<uint32_t>& indices, std::vector<std::byte>& body) {
+            for (uint32_t i = 0; i < entities.size(); i++) {
+                const T* component = entities[i]->getComponent<T>();
+                if (component == nullptr) {
+                    continue;
+                }
+                indices.push_back(i);
+                size_t offset = body.size();
+                body.resize(offset + recordSize);
+                std::byte* out = body.data() + offset;
+                ((std::memcpy(out, &(component->*fields), sizeof(Fields)), out += sizeof(Fields)), ...);
+            }
+        };
+        codec.read = [=](SceneEntities& entities, const uint32_t* indices, uint32_t count, BinaryReader& body) {
+            const std::byte* records = body.take(size_t(count) * recordSize);
+            for (uint32_t i = 0; i < count; i++) {
+                T* component = entities[indices[i]]->template addComponentAndGetRawPtr<T>();
+                const std::byte* in = records + size_t(i) * recordSize;
+                ((std::memcpy(&(component->*fields), in, sizeof(Fields)), in += sizeof(Fields)), ...);
+            }
+        };
+        codec.find = [](IEntity& entity) -> void* {
+            return entity.getComponent<T>();
+        };
+        codec.pack = [=](void* const* components, size_t count, std::byte* out) {
+            for (size_t i = 0; i < count; i++) {
+                const T* component = static_cast<const T*>(components[i]);
+                ((std::memcpy(out, &(component->*fields), sizeof(Fields)), out += sizeof(Fields)), ...);
+            }
+        };
+        codec.unpack = [=](void* const* components, size_t count, const std::byte* in) {
+            for (size_t i = 0; i < count; i++) {
+                T* component = static_cast<T*>(components[i]);
+                ((std::memcpy(&(component->*fields), in, sizeof(Fields)), in += sizeof(Fields)), ...);
+            }
+        };
+        addCodec(std::move(codec));
+    }
+
+    /**
+     * Store a plain component as the fields listed in its Reflection, under the name given there. Records without padding
+     * are copied whole, and runs of them laid out back to back in their pool are copied at once.
+     */
+    template<PlainComponent T>
+    void registerPlain() {
+        using Layout = TypeLayout<T>;
+        constexpr uint32_t recordSize = Layout::fieldBytes;
+
+        Codec codec = makeCodec(Layout::name, recordSize);
+        codec.write = [](const std::vector<IGameplayEntity*>& entities, std::vector<uint32_t>& indices, std::vector<std::byte>& body) {
+            for (uint32_t i = 0; i < entities.size(); i++) {
+                const T* component = entities[i]->getComponent<T>();
+                if (component == nullptr) {
+                    continue;
+                }
+                indices.push_back(i);
+                size_t offset = body.size();
+                body.resize(offset + recordSize);
+                packPlain(component, body.data() + offset);
+            }
+        };
+        codec.read = [](SceneEntities& entities, const uint32_t* indices, uint32_t count, BinaryReader& body) {
+            const std::byte* records = body.take(size_t(count) * recordSize);
+            for (uint32_t i = 0; i < count; i++) {
+                T* component = entities[indices[i]]->template addComponentAndGetRawPtr<T>();
+                unpackPlain(component, records + size_t(i) * recordSize);
+            }
+        };
+        codec.find = [](IEntity& entity) -> void* {
+            return entity.getComponent<T>();
+        };
+        codec.pack = [](void* const* components, size_t count, std::byte* out) {
+            forEachRun<T>(components, count, [&](T* first, size_t run) {
+                if constexpr (Layout::packed) {
+                    std::memcpy(out, first, run * sizeof(T));
+                    out += run * sizeof(T);
+                } else {
+                    for (size_t i = 0; i < run; i++, out += recordSize) {
+                        packPlain(first + i, out);
+                    }
+                }
+            });
+        };
+        codec.unpack = [](void* const* components, size_t count, const std::byte* in) {
+            forEachRun<T>(components, count, [&](T* first, size_t run) {
+                if constexpr (Layout::packed) {
+                    std::memcpy(first, in, run * sizeof(T));
+                    in += run * sizeof(T);
+                } else {
+                    for (size_t i = 0; i < run; i++, in += recordSize) {
+                        unpackPlain(first + i, in);
+                    }
+                }
+            });
+        };
+        addCodec(std::move(codec));
+    }
+
+    /** Fallback for components that can't be stored as plain fields, e.g. those holding containers or other components */
+    template<EntityComponent T>
+    void registerCustom(const char* name, std::function<void(const T&, BinaryWriter&)> save, std::function<void(IEntity&, BinaryReader&)> load) {
+        Codec codec = makeCodec(name, 0);
+        codec.write = [save](const std::vector<IGameplayEntity*>& entities, std::vector<uint32_t>& indices, std::vector<std::byte>& body) {
+            BinaryWriter writer(body);
+            std::vector<std::byte> record;
+            BinaryWriter recordWriter(record);
+            for (uint32_t i = 0; i < entities.size(); i++) {
+                const T* component = entities[i]->getComponent<T>();
+                if (component == nullptr) {
+                    continue;
+                }
+                indices.push_back(i);
+                record.clear();
+                save(*component, recordWriter);
+                writer.write(static_cast<uint32_t>(record.size()));
+                writer.write(record.data(), record.size());
+            }
+        };
+        codec.read = [load](SceneEntities& entities, const uint32_t* indices, uint32_t count, BinaryReader& body) {
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t size = body.read<uint32_t>();
+                BinaryReader record(body.take(size), size);
+                load(*entities[indices[i]], record);
+            }
+        };
+        addCodec(std::move(codec));
+    }
+
+    std::vector<std::byte> serialize(const std::vector<IGameplayEntity*>& entities) const;
+    /** Throws if the file cannot be written */
+    void save(const char* path, const std::vector<IGameplayEntity*>& entities) const;
+
+    /** Throws if the data is malformed, or a block of a known component doesn't match its registration */
+    SceneEntities deserialize(const std::byte* data, size_t size) const;
+    /** Maps the file rather than reading it, so loading is bound by how fast pages come in */
+    SceneEntities load(const char* path) const;
+
+private:
+    friend class WorldSnapshot;
+
+    struct Codec {
+        uint32_t type;
+        std::string name;
+        /** 0 for custom codecs */
+        uint32_t recordSize;
+        std::function<void(const std::vector<IGameplayEntity*>&, std::vector<uint32_t>&, std::vector<std::byte>&)> write;
+        std::function<void(SceneEntities&, const uint32_t*, uint32_t, BinaryReader&)> read;
+        /** Trivial and plain codecs only. Copies the fields of already existing components, for WorldSnapshot */
+        std::function<void*(IEntity&)> find;
+        std::function<void(void* const*, size_t, std::byte*)> pack;
+        std::function<void(void* const*, size_t, const std::byte*)> unpack;
+    };
+
+    /** Only ever appended to, WorldSnapshot refers to codecs by index */
+    std::vector<Codec> m_codecs;
+
+    Codec makeCodec(const char* name, uint32_t recordSize) const;
+    void addCodec(Codec codec);
+    const Codec* findCodec(uint32_t type) const noexcept;
+
+    template<PlainComponent T>
+    static void packPlain(const T* component, std::byte* out) noexcept {
+        if constexpr (TypeLayout<T>::packed) {
+            std::memcpy(out, component, sizeof(T));
+        } else {
+            TypeLayout<T>::forEachField(*component, [&](const char*, const auto& value) {
+                std::memcpy(out, &value, sizeof(value));
+                out += sizeof(value);
+            });
+        }
+    }
+    template<PlainComponent T>
+    static void unpackPlain(T* component, const std::byte* in) noexcept {
+        if constexpr (TypeLayout<T>::packed) {
+            std::memcpy(component, in, sizeof(T));
+        } else {
+            TypeLayout<T>::forEachField(*component, [&](const char*, auto& value) {
+                std::memcpy(&value, in, sizeof(value));
+                in += sizeof(value);
+            });
+        }
+    }
+    /** Calls func(first, count) for each run of components that follow each other in memory */
+    template<PlainComponent T, typename Func>
+    static void forEachRun(void* const* components, size_t count, Func&& func) {
+        size_t start = 0;
+        for (size_t i = 1; i <= count; i++) {
+            if (i == count || static_cast<T*>(components[i]) != static_cast<T*>(components[i - 1]) + 1) {
+                func(static_cast<T*>(components[start]), i - start);
+                start = i;
+            }
+        }
+    }
+};
@@ -0,0 +1,114 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include <scene/snapshot.h>
+
+static size_t recordsPerChunk(size_t recordSize, size_t chunkSize) noexcept {
+    return std::max<size_t>(1, chunkSize / recordSize);
+}
+
+void WorldSnapshot::reserve(size_t entityCount) {
+    size_t bytesPerEntity = 0;
+    size_t codecs = 0;
+    for (const SceneSerializer::Codec& codec : m_serializer.m_codecs) {
+        if (codec.recordSize != 0) {
+            bytesPerEntity += codec.recordSize;
+            codecs++;
+        }
+    }
+    m_entityIds.reserve(entityCount);
+    m_structureVersions.reserve(entityCount);
+    m_components.reserve(entityCount * codecs);
+    m_blocks.reserve(codecs);
+    m_data.reserve(entityCount * bytesPerEntity);
+}
+
+void WorldSnapshot::capture(const std::vector<IGameplayEntity*>& entities) {
+    // Same entities with the same components as last time, the component lookups can be skipped
+    if (!empty() && matches(entities)) {
+        for (const Block& block : m_blocks) {
+            m_serializer.m_codecs[block.codec].pack(m_components.data() + block.firstComponent, block.count, m_data.data() + block.offset);
+        }
+        return;
+    }
+
+    m_entityIds.clear();
+    m_structureVersions.clear();
+    m_components.clear();
+    m_blocks.clear();
+    m_data.clear();
+    m_chunkCount = 0;
+
+    for (const IGameplayEntity* entity : entities) {
+        m_entityIds.push_back(entity->getEntityId());
+        m_structureVersions.push_back(entity->structureVersion());
+    }
+
+    size_t largestChunk = 0;
+    for (size_t index = 0; index < m_serializer.m_codecs.size(); index++) {
+        const SceneSerializer::Codec& codec = m_serializer.m_codecs[index];
+        if (codec.recordSize == 0) {
+            continue;
+        }
+
+        Block block{index, m_components.size(), 0, m_data.size()};
+        for (IGameplayEntity* entity : entities) {
+            void* component = codec.find(*entity);
+            if (component != nullptr) {
+                m_components.push_back(component);
+            }
+        }
+        block.count = m_components.size() - block.firstComponent;
+        if (block.count == 0) {
+            continue;
+        }
+
+        m_data.resize(block.offset + block.count * codec.recordSize);
+        codec.pack(m_components.data() + block.firstComponent, block.count, m_data.data() + block.offset);
+        m_blocks.push_back(block);
+
+        size_t perChunk = recordsPerChunk(codec.recordSize, s_chunkSize);
+        m_chunkCount += (block.count + perChunk - 1) / perChunk;
+        largestChunk = std::max(largestChunk, perChunk * codec.recordSize);
+    }
+    m_scratch.resize(std::max(m_scratch.size(), largestChunk));
+}
+
+bool WorldSnapshot::matches(const std::vector<IGameplayEntity*>& entities) const noexcept {
+    if (entities.size() != m_entityIds.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (entities[i]->getEntityId() != m_entityIds[i] || entities[i]->structureVersion() != m_structureVersions[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WorldSnapshot::restore(const std::vector<IGameplayEntity*>& entities) {
+    if (!matches(entities)) {
+        throw std::runtime_error("Cannot restore a snapshot after entities were added, removed or replaced, or had components added or removed");
+    }
+
+    m_restoredChunks = 0;
+    for (const Block& block : m_blocks) {
+        const SceneSerializer::Codec& codec = m_serializer.m_codecs[block.codec];
+        size_t perChunk = recordsPerChunk(codec.recordSize, s_chunkSize);
+
+        for (size_t first = 0; first < block.count; first += perChunk) {
+            size_t count = std::min(perChunk, block.count - first);
+            void* const* components = m_components.data() + block.firstComponent + first;
+            const std::byte* saved = m_data.data() + block.offset + first * codec.recordSize;
+            size_t bytes = count * codec.recordSize;
+
+            // Reading is unavoidable without write tracking in components, but untouched ones are never written to
+            codec.pack(components, count, m_scratch.data());
+            if (std::memcmp(m_scratch.data(), saved, bytes) != 0) {
+                codec.unpack(components, count, saved);
+                m_restoredChunks++;
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <scene/scene.h>
+#include <scene/serialization.h>
+
+/**
+ * Copy of the state of every trivially registered or plain component of a set of entities, for rollback and resimulation.
+ * Capturing again reuses all buffers, so after the first capture (or reserve) neither capture nor restore allocate.
+ * Capturing the same entities again without structural changes skips looking up their components.
+ * Restoring compares the live state against the snapshot a chunk at a time, and only writes back chunks that differ.
+ *
+ * Snapshots hold on to component pointers. Restoring after an entity was added or removed, or had components
+ * added or removed, throws rather than touch them.
+ */
+class WorldSnapshot {
+public:
+    /** Only components registered with registerTrivial or registerPlain are captured. The serializer must outlive the snapshot */
+    WorldSnapshot(const SceneSerializer& serializer) : m_serializer(serializer) {};
+
+    /** Preallocate for entityCount entities having every trivially registered component */
+    void reserve(size_t entityCount);
+
+    void capture(const SceneContext& scene) { capture(scene.getEntities()); }
+    void capture(const std::vector<IGameplayEntity*>& entities);
+    /** Throws if the entities changed structurally since capture, see above */
+    void restore(const SceneContext& scene) { restore(scene.getEntities()); }
+    void restore(const std::vector<IGameplayEntity*>& entities);
+
+    bool empty() const noexcept { return m_entityIds.empty(); }
+    /** Bytes of component state held */
+    size_t size() const noexcept { return m_data.size(); }
+    /** Chunks written back by the last restore, out of chunkCount() */
+    size_t restoredChunks() const noexcept { return m_restoredChunks; }
+    size_t chunkCount() const noexcept { return m_chunkCount; }
+
+private:
+    struct Block {
+        /** Into the serializer's codecs. Registering more may move them, but never reorders them */
+        size_t codec;
+        size_t firstComponent;
+        size_t count;
+        size_t offset;
+    };
+
+    /** Bytes compared at once on restore. Rounded down to whole records per component type */
+    static constexpr size_t s_chunkSize = 4096;
+
+    const SceneSerializer& m_serializer;
+    std::vector<long long> m_entityIds;
+    std::vector<uint32_t> m_structureVersions;
+    std::vector<void*> m_components;
+    std::vector<Block> m_blocks;
+    std::vector<std::byte> m_data;
+    /** Live state of the chunk being compared on restore */
+    std::vector<std::byte> m_scratch;
+    size_t m_chunkCount = 0;
+    size_t m_restoredChunks = 0;
+
+    /** Whether entities are the ones captured, with the same components */
+    bool matches(const std::vector<IGameplayEntity*>& entities) const noexcept;
+};
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include <scene/tickScheduler.h>
+#include <meta/frameStats.h>
+
+TickScheduler::TickScheduler(TickLodConfig config) : m_config(std::move(config)) {
+    m_config.maxInterval = std::max(m_config.maxInterval, 1u);
+    for (float distance : m_config.distances) {
+        m_distancesSquared.push_back(distance * distance);
+    }
+}
+
+void TickScheduler::add(IGameplayEntity* entity, TickPriority priority) {
+    if (entity == nullptr) {
+        throw std::runtime_error("Cannot schedule a null entity");
+    }
+    if (m_indices.contains(entity)) {
+        return;
+    }
+    // Consecutive phases, so entities sharing any interval that divides maxInterval are spread evenly over its frames
+    uint32_t phase = m_nextPhase;
+    m_nextPhase = (m_nextPhase + 1) % m_config.maxInterval;
+    m_indices.emplace(entity, m_entries.size());
+    m_entries.push_back(Entry{entity, entity->getComponent<TransformComponent>(), priority, 1, phase, m_frame, m_time});
+}
+
+bool TickScheduler::remove(IGameplayEntity* entity) noexcept {
+    auto it = m_indices.find(entity);
+    if (it == m_indices.end()) {
+        return false;
+    }
+    size_t index = it->second;
+    m_indices.erase(it);
+    if (index != m_entries.size() - 1) {
+        m_entries[index] = m_entries.back();
+        m_indices[m_entries[index].entity] = index;
+    }
+    m_entries.pop_back();
+    return true;
+}
+
+void TickScheduler::setPriority(IGameplayEntity* entity, TickPriority priority) {
+    auto it = m_indices.find(entity);
+    if (it == m_indices.end()) {
+        throw std::runtime_error(std::format("Entity {} is not scheduled", entity == nullptr ? -1 : entity->getEntityId()));
+    }
+    m_entries[it->second].priority = priority;
+}
+
+void TickScheduler::setView(const SDL_FRect& view) noexcept {
+    m_view = view;
+    m_customView = true;
+}
+
+uint32_t TickScheduler::interval(IGameplayEntity* entity) const noexcept {
+    auto it = m_indices.find(entity);
+    return it == m_indices.end() ? 0 : m_entries[it->second].interval;
+}
+
+uint32_t TickScheduler::intervalOf(const Entry& entry) const noexcept {
+    if (entry.priority == TickPriority::Critical || entry.transform == nullptr) {
+        return 1;
+    }
+    uint32_t interval = entry.priority == TickPriority::Background ? 2 : 1;
+
+    glm::fvec3 position = entry.transform->worldPosition();
+    bool onScreen = position.x >= m_view.x && position.x < m_view.x + m_view.w &&
+                    position.y >= m_view.y && position.y < m_view.y + m_view.h;
+    if (!onScreen) {
+        float deltaX = position.x - m_focus.x;
+        float deltaY = position.y - m_focus.y;
+        float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+        interval *= 2;
+        for (float band : m_distancesSquared) {
+            if (distanceSquared > band) {
+                interval *= 2;
+            }
+        }
+    }
+    return std::min(interval, m_config.maxInterval);
+}
+
+void TickScheduler::tick(std::shared_ptr<ApplicationContext> appCtx, const std::function<void(IGameplayEntity& entity)>& tickOne) {
+    if (!m_customView) {
+        const glm::fvec2* bounds = appCtx->viewport().bounds();
+        m_view = SDL_FRect{0.0f, 0.0f, bounds->x, bounds->y};
+    }
+    FrameData& frames = appCtx->frames();
+    tick(frames.deltaT(), [&](IGameplayEntity& entity, float scale) {
+        frames.setDeltaTScale(scale);
+        tickOne(entity);
+    });
+    frames.setDeltaTScale(1.0f);
+}
+
+void TickScheduler::tick(float deltaT, const TickFunction& tickOne) {
+    m_frame++;
+    m_time += deltaT;
+    m_critical.clear();
+    m_due.clear();
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        Entry& entry = m_entries[i];
+        entry.interval = intervalOf(entry);
+        // On its own frame of the interval, or late for it, e.g. deferred over budget or just slowed down
+        bool onPhase = (m_frame + entry.phase) % entry.interval == 0;
+        if (onPhase || m_frame - entry.lastTickFrame > entry.interval) {
+            (entry.priority == TickPriority::Critical ? m_critical : m_due).push_back(i);
+        }
+    }
+
+    auto run = [&](Entry& entry) {
+        float scale = deltaT > 0.0f ? static_cast<float>((m_time - entry.lastTickTime) / deltaT) : 1.0f;
+        entry.lastTickFrame = m_frame;
+        entry.lastTickTime = m_time;
+        tickOne(*entry.entity, scale);
+    };
+    for (size_t index : m_critical) {
+        run(m_entries[index]);
+    }
+
+    size_t ticked = 0;
+    if (m_config.budgetMs > 0.0) {
+        // Whatever was deferred before goes first, so nothing is starved
+        std::sort(m_due.begin(), m_due.end(), [this](size_t a, size_t b) {
+            return m_entries[a].lastTickFrame < m_entries[b].lastTickFrame;
+        });
+        double start = FrameStatistics::now();
+        for (; ticked < m_due.size(); ticked++) {
+            // Reading the clock costs about as much as a cheap tick, so only every so often
+            if (ticked % 16 == 0 && FrameStatistics::now() - start > m_config.budgetMs) {
+                break;
+            }
+            run(m_entries[m_due[ticked]]);
+        }
+    } else {
+        for (; ticked < m_due.size(); ticked++) {
+            run(m_entries[m_due[ticked]]);
+        }
+    }
+    m_ticked = m_critical.size() + ticked;
+    m_deferred = m_due.size() - ticked;
+}
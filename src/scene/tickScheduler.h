@@ -0,0 +1,98 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <scene/scene.h>
+
+enum class TickPriority : uint8_t {
+    /** Every frame, and never deferred by the budget. The player, whatever drives the camera */
+    Critical,
+    Normal,
+    /** Half as often as Normal would be, even on screen */
+    Background
+};
+
+struct TickLodConfig {
+    /** Off screen entities tick every 2nd frame, and half as often again beyond each of these distances from the focus. Ascending */
+    std::vector<float> distances = {500.0f, 1000.0f, 2000.0f};
+    uint32_t maxInterval = 16;
+    /** Milliseconds per frame for everything but Critical entities. Whatever doesn't fit is deferred to the next frame. <= 0 for no budget */
+    double budgetMs = 4.0;
+};
+
+/**
+ * Ticks entities at a rate that depends on how much they matter: on screen ones every frame, off screen ones
+ * less often the further they are from the focus, e.g. the player. Entities sharing an interval are spread over
+ * its frames round robin, rather than all ticking on the same one, and each gets a deltaT covering all the time since
+ * it last ticked. Once the budget for a frame is spent, the remaining entities are deferred, most overdue first next frame.
+ * Entities must not be added or removed from within a tick, and must be removed before they are destroyed.
+ */
+class TickScheduler {
+public:
+    /** scale is how many frames worth of deltaT this tick covers */
+    using TickFunction = std::function<void(IGameplayEntity& entity, float scale)>;
+
+    explicit TickScheduler(TickLodConfig config = {});
+
+    /** Entities without a TransformComponent always count as on screen */
+    void add(IGameplayEntity* entity, TickPriority priority = TickPriority::Normal);
+    /** Returns false if it wasn't scheduled */
+    bool remove(IGameplayEntity* entity) noexcept;
+    /** Throws if entity isn't scheduled */
+    void setPriority(IGameplayEntity* entity, TickPriority priority);
+
+    void setFocus(glm::fvec2 focus) noexcept { m_focus = focus; }
+    /** World space area that counts as on screen. Unless set, the viewport bounds when ticked with an ApplicationContext, nothing otherwise */
+    void setView(const SDL_FRect& view) noexcept;
+
+    /** Ticks everything due through tickOne, with FrameData::deltaT scaled to match while it runs */
+    void tick(std::shared_ptr<ApplicationContext> appCtx, const std::function<void(IGameplayEntity& entity)>& tickOne);
+    void tick(float deltaT, const TickFunction& tickOne);
+
+    size_t size() const noexcept { return m_entries.size(); }
+    size_t tickedLastFrame() const noexcept { return m_ticked; }
+    /** Due, but over budget */
+    size_t deferredLastFrame() const noexcept { return m_deferred; }
+    /** Frames between ticks as of the last tick, 0 if not scheduled */
+    uint32_t interval(IGameplayEntity* entity) const noexcept;
+
+private:
+    struct Entry {
+        IGameplayEntity* entity;
+        TransformComponent* transform;
+        TickPriority priority;
+        uint32_t interval;
+        /** Due on frames where frame + phase is a multiple of interval */
+        uint32_t phase;
+        int64_t lastTickFrame;
+        double lastTickTime;
+    };
+
+    TickLodConfig m_config;
+    /** Squared, so no square roots per entity */
+    std::vector<float> m_distancesSquared;
+    glm::fvec2 m_focus = glm::fvec2(0.0f, 0.0f);
+    SDL_FRect m_view = {0.0f, 0.0f, 0.0f, 0.0f};
+    bool m_customView = false;
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<IGameplayEntity*, size_t> m_indices;
+    /** Indices into m_entries, kept for their capacity */
+    std::vector<size_t> m_critical;
+    std::vector<size_t> m_due;
+
+    int64_t m_frame = 0;
+    uint32_t m_nextPhase = 0;
+    /** Sum of deltaT over all frames */
+    double m_time = 0.0;
+    size_t m_ticked = 0;
+    size_t m_deferred = 0;
+
+    uint32_t intervalOf(const Entry& entry) const noexcept;
+};
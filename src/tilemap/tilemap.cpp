@@ -0,0 +1,270 @@
+#include <cmath>
+#include <format>
+#include <stdexcept>
+#include <algorithm>
+
+#include <tilemap/tilemap.h>
+#include <meta/pipeline.h>
+#include <meta/ApplicationContext.h>
+#include <meta/log.h>
+
+TileChunkCache::~TileChunkCache() {
+    for (auto& [key, entry] : m_entries) {
+        release(key, entry);
+    }
+}
+
+bool TileChunkCache::draw(SDL_Renderer& renderer, const std::shared_ptr<TilemapRasterState>& state, uint32_t chunk, uint32_t version,
+    const SDL_FRect& destination, const TileId* tiles) noexcept {
+    Entry& entry = m_entries[Key{state.get(), chunk}];
+    if (entry.state == nullptr) {
+        entry.state = state;
+    }
+    entry.lastDrawn = m_frame;
+
+    if (entry.texture == nullptr || entry.version != version) {
+        // Not sent along, and not rasterised either. Capture will send it next frame
+        if (tiles == nullptr) {
+            return false;
+        }
+        if (!rasterise(renderer, entry, tiles)) {
+            return false;
+        }
+        entry.version = version;
+        state->rasterised[chunk].store(version, std::memory_order_release);
+    }
+
+    if (!SDL_RenderTexture(&renderer, entry.texture, nullptr, &destination)) {
+        Log::error("Could not draw tilemap chunk: {}", SDL_GetError());
+    }
+    return true;
+}
+
+bool TileChunkCache::rasterise(SDL_Renderer& renderer, Entry& entry, const TileId* tiles) noexcept {
+    const TilemapRasterState& state = *entry.state;
+    int size = Tilemap::s_chunkTiles * state.tileSize;
+    if (entry.texture == nullptr) {
+        entry.texture = SDL_CreateTexture(&renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size, size);
+        if (entry.texture == nullptr) {
+            Log::warn("Could not create tilemap chunk texture: {}", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND);
+    }
+
+    // Runs of the same tile along a row become a single rect, then one call per kind
+    m_scratch.resize(std::max(m_scratch.size(), state.palette.size()));
+    for (std::vector<SDL_FRect>& rects : m_scratch) {
+        rects.clear();
+    }
+    float tileSize = static_cast<float>(state.tileSize);
+    for (int y = 0; y < Tilemap::s_chunkTiles; y++) {
+        const TileId* row = tiles + y * Tilemap::s_chunkTiles;
+        int x = 0;
+        while (x < Tilemap::s_chunkTiles) {
+            TileId tile = row[x];
+            int start = x;
+            while (x < Tilemap::s_chunkTiles && row[x] == tile) {
+                x++;
+            }
+            if (tile != 0 && tile < state.palette.size()) {
+                m_scratch[tile].push_back(SDL_FRect{start * tileSize, y * tileSize, (x - start) * tileSize, tileSize});
+            }
+        }
+    }
+
+    // Chunks may be rasterised while drawing into something else, so restore whatever target was set
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(&renderer);
+    SDL_SetRenderTarget(&renderer, entry.texture);
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderClear(&renderer);
+    for (size_t kind = 1; kind < state.palette.size(); kind++) {
+        if (m_scratch[kind].empty()) {
+            continue;
+        }
+        SDL_Color colour = state.palette[kind].colour;
+        SDL_SetRenderDrawColor(&renderer, colour.r, colour.g, colour.b, colour.a);
+        SDL_RenderFillRects(&renderer, m_scratch[kind].data(), static_cast<int>(m_scratch[kind].size()));
+    }
+    SDL_SetRenderTarget(&renderer, previousTarget);
+    return true;
+}
+
+void TileChunkCache::trim() noexcept {
+    m_frame++;
+    std::erase_if(m_entries, [this](const auto& item) {
+        // Only the cache still knows of this tilemap
+        if (item.second.state.use_count() == 1) {
+            release(item.first, item.second);
+            return true;
+        }
+        return false;
+    });
+    if (m_entries.size() <= m_maxTextures) {
+        return;
+    }
+
+    std::vector<uint64_t> ages;
+    ages.reserve(m_entries.size());
+    for (const auto& [key, entry] : m_entries) {
+        ages.push_back(entry.lastDrawn);
+    }
+    size_t excess = m_entries.size() - m_maxTextures;
+    std::nth_element(ages.begin(), ages.begin() + (excess - 1), ages.end());
+    uint64_t cutoff = ages[excess - 1];
+
+    std::erase_if(m_entries, [&](const auto& item) {
+        if (excess == 0 || item.second.lastDrawn > cutoff) {
+            return false;
+        }
+        excess--;
+        release(item.first, item.second);
+        return true;
+    });
+}
+
+void TileChunkCache::release(const Key& key, const Entry& entry) noexcept {
+    if (entry.texture != nullptr) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    if (entry.state != nullptr) {
+        entry.state->rasterised[key.chunk].store(0, std::memory_order_release);
+    }
+}
+
+Tilemap::Tilemap(ComponentRetriever compRet, int width, int height, int tileSize, std::vector<TileKind> palette)
+    : IDependentEntityComponent(compRet), m_width(width), m_height(height), m_tileSize(tileSize) {
+    m_transform = requireComponent<TransformComponent>("Tilemap requires a TransformComponent");
+    if (width <= 0 || height <= 0 || tileSize <= 0) {
+        throw std::runtime_error(std::format("Tilemap dimensions must be positive, got {}x{} tiles of {}", width, height, tileSize));
+    }
+    if (palette.empty() || palette.size() > UINT16_MAX) {
+        throw std::runtime_error(std::format("Tilemap palette must have between 1 and {} kinds, got {}", UINT16_MAX, palette.size()));
+    }
+
+    m_chunksX = (width + s_chunkTiles - 1) / s_chunkTiles;
+    m_chunksY = (height + s_chunkTiles - 1) / s_chunkTiles;
+    m_chunks.resize(static_cast<size_t>(m_chunksX) * m_chunksY);
+    for (size_t kind = 0; kind < palette.size(); kind++) {
+        m_solid.push_back(kind != 0 && palette[kind].solid);
+    }
+    m_raster = std::make_shared<TilemapRasterState>(std::move(palette), tileSize, m_chunks.size());
+}
+
+TileId Tilemap::tile(int x, int y) const noexcept {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return 0;
+    }
+    const Chunk& chunk = m_chunks[(y / s_chunkTiles) * m_chunksX + x / s_chunkTiles];
+    return chunk.tiles[(y % s_chunkTiles) * s_chunkTiles + x % s_chunkTiles];
+}
+
+void Tilemap::setTile(int x, int y, TileId tile) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        throw std::runtime_error(std::format("Tile {}, {} is outside of the {}x{} tilemap", x, y, m_width, m_height));
+    }
+    if (tile >= m_solid.size()) {
+        throw std::runtime_error(std::format("Tile {} is not in the palette", tile));
+    }
+    Chunk& chunk = m_chunks[(y / s_chunkTiles) * m_chunksX + x / s_chunkTiles];
+    TileId& slot = chunk.tiles[(y % s_chunkTiles) * s_chunkTiles + x % s_chunkTiles];
+    if (slot == tile) {
+        return;
+    }
+    chunk.filled += (tile != 0) - (slot != 0);
+    slot = tile;
+    chunk.version++;
+}
+
+bool Tilemap::isSolid(int x, int y) const noexcept {
+    return m_solid[tile(x, y)];
+}
+
+bool Tilemap::isSolidAt(glm::fvec2 point) const noexcept {
+    glm::fvec3 origin = m_transform->worldPosition();
+    float x = std::floor((point.x - origin.x) / m_tileSize);
+    float y = std::floor((point.y - origin.y) / m_tileSize);
+    // Out of range floats don't convert to int, and anything that far out isn't on the map anyway
+    if (x < 0.0f || y < 0.0f || x >= m_width || y >= m_height) {
+        return false;
+    }
+    return isSolid(static_cast<int>(x), static_cast<int>(y));
+}
+
+void Tilemap::forEachSolidTile(const SDL_FRect& area, const std::function<void(int x, int y)>& func) const {
+    glm::fvec3 origin = m_transform->worldPosition();
+    float left = (area.x - origin.x) / m_tileSize;
+    float top = (area.y - origin.y) / m_tileSize;
+    int minX = static_cast<int>(std::clamp(std::floor(left), 0.0f, static_cast<float>(m_width)));
+    int minY = static_cast<int>(std::clamp(std::floor(top), 0.0f, static_cast<float>(m_height)));
+    int maxX = static_cast<int>(std::clamp(std::ceil(left + area.w / m_tileSize), 0.0f, static_cast<float>(m_width)));
+    int maxY = static_cast<int>(std::clamp(std::ceil(top + area.h / m_tileSize), 0.0f, static_cast<float>(m_height)));
+    for (int y = minY; y < maxY; y++) {
+        for (int x = minX; x < maxX; x++) {
+            if (isSolid(x, y)) {
+                func(x, y);
+            }
+        }
+    }
+}
+
+void Tilemap::setView(const SDL_FRect& view) noexcept {
+    m_view = view;
+    m_customView = true;
+}
+
+uint32_t Tilemap::chunkVersion(int x, int y) const noexcept {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return 0;
+    }
+    return m_chunks[(y / s_chunkTiles) * m_chunksX + x / s_chunkTiles].version;
+}
+
+void Tilemap::tick(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    if (!m_customView) {
+        const glm::fvec2* bounds = ctx->viewport().bounds();
+        m_view = SDL_FRect{0.0f, 0.0f, bounds->x, bounds->y};
+    }
+}
+
+void Tilemap::forEachVisibleChunk(const std::function<void(uint32_t index, const Chunk& chunk, const SDL_FRect& destination)>& func) const {
+    float chunkSize = static_cast<float>(s_chunkTiles * m_tileSize);
+    glm::fvec2 origin(m_transform->worldPosition());
+    int minX = static_cast<int>(std::clamp(std::floor((m_view.x - origin.x) / chunkSize), 0.0f, static_cast<float>(m_chunksX)));
+    int minY = static_cast<int>(std::clamp(std::floor((m_view.y - origin.y) / chunkSize), 0.0f, static_cast<float>(m_chunksY)));
+    int maxX = static_cast<int>(std::clamp(std::ceil((m_view.x + m_view.w - origin.x) / chunkSize), 0.0f, static_cast<float>(m_chunksX)));
+    int maxY = static_cast<int>(std::clamp(std::ceil((m_view.y + m_view.h - origin.y) / chunkSize), 0.0f, static_cast<float>(m_chunksY)));
+
+    for (int y = minY; y < maxY; y++) {
+        for (int x = minX; x < maxX; x++) {
+            uint32_t index = static_cast<uint32_t>(y * m_chunksX + x);
+            const Chunk& chunk = m_chunks[index];
+            if (chunk.filled == 0) {
+                continue;
+            }
+            // Relative to the view, which is where the screen is
+            SDL_FRect destination{origin.x + x * chunkSize - m_view.x, origin.y + y * chunkSize - m_view.y, chunkSize, chunkSize};
+            func(index, chunk, destination);
+        }
+    }
+}
+
+void Tilemap::draw(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    SDL_Renderer& renderer = ctx->frames().renderer();
+    TileChunkCache& cache = ctx->frames().tileChunks();
+    forEachVisibleChunk([&](uint32_t index, const Chunk& chunk, const SDL_FRect& destination) {
+        cache.draw(renderer, m_raster, index, chunk.version, destination, chunk.tiles.data());
+    });
+}
+
+void Tilemap::capture(RenderSnapshot& snapshot) const noexcept {
+    forEachVisibleChunk([&](uint32_t index, const Chunk& chunk, const SDL_FRect& destination) {
+        uint32_t tiles = SnapshotChunk::s_noTiles;
+        // Only copied if the render thread doesn't have this version yet
+        if (m_raster->rasterised[index].load(std::memory_order_acquire) != chunk.version) {
+            tiles = static_cast<uint32_t>(snapshot.chunkTiles.size());
+            snapshot.chunkTiles.insert(snapshot.chunkTiles.end(), chunk.tiles.begin(), chunk.tiles.end());
+        }
+        snapshot.chunks.push_back(SnapshotChunk{m_raster, index, chunk.version, destination, tiles});
+    });
+}
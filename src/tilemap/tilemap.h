@@ -0,0 +1,168 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <entities/components.h>
+#include <collisions/collider.h>
+#include <meta/processing.h>
+
+/** Index into the palette of a Tilemap. 0 is always empty */
+using TileId = uint16_t;
+
+struct TileKind {
+    SDL_Color colour;
+    bool solid;
+};
+
+/**
+ * The parts of a Tilemap the render thread needs, shared with it by snapshots. Holds no textures,
+ * so it may be released on any thread. rasterised is written by the render thread only, and lets capture
+ * know which chunks it already has, so tiles are only copied into snapshots when they actually changed.
+ */
+struct TilemapRasterState {
+    std::vector<TileKind> palette;
+    int tileSize;
+    /** Per chunk, the version last rasterised. 0 when there is no texture at all */
+    std::vector<std::atomic<uint32_t>> rasterised;
+
+    TilemapRasterState(std::vector<TileKind> palette, int tileSize, size_t chunks)
+        : palette(std::move(palette)), tileSize(tileSize), rasterised(chunks) {};
+};
+
+/**
+ * Textures of tilemap chunks, owned by the render thread, see FrameData::tileChunks().
+ * Chunks are rasterised when first drawn or when their version changed. Past the limit,
+ * the least recently drawn are released, and rasterised again should they come back into view.
+ */
+class TileChunkCache {
+public:
+    explicit TileChunkCache(size_t maxTextures = 256) : m_maxTextures(maxTextures) {};
+    ~TileChunkCache();
+    TileChunkCache(const TileChunkCache&) = delete;
+    TileChunkCache& operator=(const TileChunkCache&) = delete;
+
+    /**
+     * tiles may be null if this version was rasterised before. Returns false if it wasn't, or no texture could be created,
+     * in which case nothing is drawn.
+     */
+    bool draw(SDL_Renderer& renderer, const std::shared_ptr<TilemapRasterState>& state, uint32_t chunk, uint32_t version,
+        const SDL_FRect& destination, const TileId* tiles) noexcept;
+    /** Release textures past the limit, and those of tilemaps that no longer exist. Once per frame */
+    void trim() noexcept;
+
+    size_t size() const noexcept { return m_entries.size(); }
+
+private:
+    struct Key {
+        const TilemapRasterState* state;
+        uint32_t chunk;
+        bool operator==(const Key& other) const noexcept = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return std::hash<const void*>()(key.state) ^ (static_cast<size_t>(key.chunk) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+    struct Entry {
+        /** Keeps the address in the key from being reused while cached */
+        std::shared_ptr<TilemapRasterState> state;
+        SDL_Texture* texture = nullptr;
+        uint32_t version = 0;
+        uint64_t lastDrawn = 0;
+    };
+
+    size_t m_maxTextures;
+    uint64_t m_frame = 0;
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    /** Rects per tile kind while rasterising, kept between chunks */
+    std::vector<std::vector<SDL_FRect>> m_scratch;
+
+    bool rasterise(SDL_Renderer& renderer, Entry& entry, const TileId* tiles) noexcept;
+    /** Leaves entry as is, for it to be erased */
+    void release(const Key& key, const Entry& entry) noexcept;
+};
+
+/**
+ * Grid of tiles, stored in square chunks of s_chunkTiles tiles. Each chunk is drawn from a cached texture,
+ * and only chunks overlapping the view are drawn at all, so a frame costs a draw call per visible chunk
+ * however large the map is. The TransformComponent positions the top left corner.
+ * Collisions go through a single TilemapCollider, rather than a collider per tile.
+ */
+class Tilemap : public IDependentEntityComponent, public ITickable, public IDrawable, public ISnapshotDrawable {
+public:
+    static constexpr int s_chunkTiles = 32;
+
+    /** palette[0] stands for empty and is never drawn nor solid. Throws on an empty map or palette */
+    Tilemap(ComponentRetriever compRet, int width, int height, int tileSize, std::vector<TileKind> palette);
+
+    /** Tracks the viewport, unless a view was set */
+    void tick(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+    void capture(RenderSnapshot& snapshot) const noexcept override;
+
+    /** 0 out of bounds */
+    TileId tile(int x, int y) const noexcept;
+    /** Throws out of bounds, or for ids not in the palette */
+    void setTile(int x, int y, TileId tile);
+    bool isSolid(int x, int y) const noexcept;
+    /** point in world space */
+    bool isSolidAt(glm::fvec2 point) const noexcept;
+    /** Calls func with the coordinates of every solid tile overlapping area, in world space */
+    void forEachSolidTile(const SDL_FRect& area, const std::function<void(int x, int y)>& func) const;
+
+    /** World space area to draw, instead of the viewport bounds */
+    void setView(const SDL_FRect& view) noexcept;
+
+    int width() const noexcept { return m_width; }
+    int height() const noexcept { return m_height; }
+    int tileSize() const noexcept { return m_tileSize; }
+    /** Changes whenever a tile in the chunk containing x, y does */
+    uint32_t chunkVersion(int x, int y) const noexcept;
+
+private:
+    struct Chunk {
+        std::array<TileId, s_chunkTiles * s_chunkTiles> tiles{};
+        /** Starts at 1, 0 means nothing rasterised in TilemapRasterState */
+        uint32_t version = 1;
+        /** Non empty tiles, empty chunks aren't drawn */
+        uint32_t filled = 0;
+    };
+
+    TransformComponent* m_transform;
+    int m_width;
+    int m_height;
+    int m_tileSize;
+    int m_chunksX;
+    int m_chunksY;
+    std::vector<Chunk> m_chunks;
+    std::vector<uint8_t> m_solid;
+    std::shared_ptr<TilemapRasterState> m_raster;
+
+    SDL_FRect m_view = {0.0f, 0.0f, 0.0f, 0.0f};
+    bool m_customView = false;
+
+    /** Calls func for every non empty chunk overlapping the view, with where it goes on screen */
+    void forEachVisibleChunk(const std::function<void(uint32_t index, const Chunk& chunk, const SDL_FRect& destination)>& func) const;
+};
+
+/** Point queries against the solid tiles of the Tilemap on the same entity */
+class TilemapCollider : public ICollider {
+private:
+    Tilemap* m_tilemap;
+public:
+    TilemapCollider(ComponentRetriever compRet) : ICollider(compRet) {
+        m_tilemap = requireComponent<Tilemap>("TilemapCollider requires a Tilemap");
+    }
+
+    bool overlaps(const glm::fvec3* point) const noexcept override {
+        return m_tilemap->isSolidAt(glm::fvec2(point->x, point->y));
+    }
+};
@@ -0,0 +1,111 @@
+#include <stdexcept>
+#include <format>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <types/mappedFile.h>
+
+#ifdef _WIN32
+MappedFile::MappedFile(const char* path) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(std::format("Could not open {}", path));
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        throw std::runtime_error(std::format("Could not read the size of {}", path));
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    // Mapping an empty file fails, and there is nothing to map anyway
+    if (m_size == 0) {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+        close();
+        throw std::runtime_error(std::format("Could not map {}", path));
+    }
+    m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        close();
+        throw std::runtime_error(std::format("Could not map {}", path));
+    }
+}
+
+void MappedFile::close() noexcept {
+    if (m_data != nullptr) UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr) CloseHandle(m_mapping);
+    if (m_file != nullptr) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+#else
+MappedFile::MappedFile(const char* path) {
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error(std::format("Could not open {}", path));
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        ::close(file);
+        throw std::runtime_error(std::format("Could not read the size of {}", path));
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size > 0) {
+        void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(file);
+            throw std::runtime_error(std::format("Could not map {}", path));
+        }
+        madvise(mapped, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const std::byte*>(mapped);
+    }
+    // The mapping keeps the file alive
+    ::close(file);
+}
+
+void MappedFile::close() noexcept {
+    if (m_data != nullptr) {
+        munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
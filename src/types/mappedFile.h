@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+/** Read only view of a whole file, mapped into memory. Pages are read in by the OS as they are touched */
+class MappedFile {
+public:
+    MappedFile() = default;
+    /** Throws if the file cannot be opened or mapped */
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const std::byte* data() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+    void close() noexcept;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Fixed capacity, lock free, single producer / single consumer queue.
+ * One thread may push while another pops, without either ever blocking. Never allocates.
+ * Capacity must be a power of two.
+ */
+template<typename T, size_t Capacity>
+class SPSCRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "T is copied in and out of slots, and must be trivially copyable");
+public:
+    SPSCRingBuffer() = default;
+
+    /** Producer side. Returns false if full, in which case nothing is written */
+    bool tryPush(const T& value) noexcept {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail == Capacity) {
+            // Only reload the consumers position when the stale one says full
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail == Capacity) {
+                return false;
+            }
+        }
+        m_slots[head & s_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side. Returns false if empty */
+    bool tryPop(T& out) noexcept {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+        out = m_slots[tail & s_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Approximate when called while the other side is active */
+    size_t size() const noexcept {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    bool empty() const noexcept { return size() == 0; }
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t s_mask = Capacity - 1;
+
+    std::array<T, Capacity> m_slots;
+    // Producer and consumer positions on separate cache lines, so they don't invalidate each other
+    alignas(64) std::atomic<size_t> m_head = 0;
+    /** Producers last seen value of m_tail */
+    size_t m_cachedTail = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    /** Consumers last seen value of m_head */
+    size_t m_cachedHead = 0;
+};
@@ -1,11 +1,264 @@
 // Simple hierachical UI component system - based on Entity, because why not
 
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
 #include <glm/glm.hpp>
 
-#include <entities/entity.h>
-#include <entities/components.h>
-#include <meta/processing.h>
+#include <ui/ui.h>
+#include <meta/ApplicationContext.h>
+#include <meta/log.h>
 
-class UIElement : public IEntity, public IDrawable {
+static bool sameRect(const SDL_FRect& a, const SDL_FRect& b) noexcept {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
 
-};
+UIElement::~UIElement() {
+    releaseCache();
+}
+
+std::unique_ptr<UIElement> UIElement::removeChild(UIElement* child) {
+    auto it = std::find_if(m_children.begin(), m_children.end(), [child](const std::unique_ptr<UIElement>& owned) {
+        return owned.get() == child;
+    });
+    if (it == m_children.end()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<UIElement> released = std::move(*it);
+    m_children.erase(it);
+    released->m_parent = nullptr;
+
+    invalidateLayout();
+    invalidateVisuals();
+    return released;
+}
+
+void UIElement::adoptChild(std::unique_ptr<UIElement> child) {
+    child->m_parent = this;
+    m_children.push_back(std::move(child));
+
+    invalidateLayout();
+    invalidateVisuals();
+}
+
+void UIElement::setBox(const UIBox& box) noexcept {
+    m_box = box;
+    invalidateLayout();
+}
+
+void UIElement::setLayout(UILayout layout) noexcept {
+    if (m_layout == layout) {
+        return;
+    }
+    m_layout = layout;
+    invalidateLayout();
+}
+
+void UIElement::setVisible(bool visible) noexcept {
+    if (m_visible == visible) {
+        return;
+    }
+    m_visible = visible;
+    // Hidden elements take up no space when stacked, so siblings have to move
+    if (m_parent != nullptr) {
+        m_parent->invalidateLayout();
+        m_parent->invalidateVisuals();
+    }
+}
+
+void UIElement::setCachedToTexture(bool cached) noexcept {
+    if (m_cachedToTexture == cached) {
+        return;
+    }
+    m_cachedToTexture = cached;
+    if (!cached) {
+        releaseCache();
+    }
+    // Reset, so that invalidateVisuals propagates to any cached ancestors as well
+    m_cacheDirty = false;
+    invalidateVisuals();
+}
+
+void UIElement::invalidateLayout() noexcept {
+    m_layoutDirty = true;
+    // If an ancestor is already flagged, all ancestors above it are as well
+    for (UIElement* ancestor = m_parent; ancestor != nullptr && !ancestor->m_descendantLayoutDirty; ancestor = ancestor->m_parent) {
+        ancestor->m_descendantLayoutDirty = true;
+    }
+}
+
+void UIElement::invalidateVisuals() noexcept {
+    for (UIElement* element = this; element != nullptr; element = element->m_parent) {
+        if (!element->m_cachedToTexture) {
+            continue;
+        }
+        // A dirty cache implies all caches containing it are dirty as well
+        if (element->m_cacheDirty) {
+            return;
+        }
+        element->m_cacheDirty = true;
+    }
+}
+
+void UIElement::layout(const SDL_FRect& available) noexcept {
+    if (!m_layoutDirty && sameRect(available, m_slot)) {
+        if (m_descendantLayoutDirty) {
+            layoutChildren();
+        }
+        return;
+    }
+    m_slot = available;
+    m_layoutDirty = false;
+
+    glm::fvec2 slotSize = glm::fvec2(available.w, available.h);
+    glm::fvec2 size = m_box.size + m_box.relativeSize * slotSize;
+    glm::fvec2 position = glm::fvec2(available.x, available.y) + m_box.anchor * (slotSize - size) + m_box.offset;
+    SDL_FRect rect{position.x, position.y, size.x, size.y};
+
+    if (!sameRect(rect, m_rect)) {
+        m_rect = rect;
+        invalidateVisuals();
+        onLayout();
+    }
+    // Children decide for themselves whether their slot changed
+    layoutChildren();
+}
+
+void UIElement::layoutChildren() noexcept {
+    SDL_FRect content{
+        m_rect.x + m_box.padding,
+        m_rect.y + m_box.padding,
+        std::max(0.0f, m_rect.w - 2.0f * m_box.padding),
+        std::max(0.0f, m_rect.h - 2.0f * m_box.padding)
+    };
+
+    float cursor = 0.0f;
+    for (const std::unique_ptr<UIElement>& child : m_children) {
+        if (!child->m_visible) {
+            continue;
+        }
+        SDL_FRect slot = content;
+        switch (m_layout) {
+            case UILayout::Vertical:
+                slot.y += cursor;
+                slot.h = std::max(0.0f, content.h - cursor);
+                break;
+            case UILayout::Horizontal:
+                slot.x += cursor;
+                slot.w = std::max(0.0f, content.w - cursor);
+                break;
+            case UILayout::Absolute:
+                break;
+        }
+
+        child->layout(slot);
+
+        switch (m_layout) {
+            case UILayout::Vertical:
+                cursor += child->m_rect.h + m_box.spacing;
+                break;
+            case UILayout::Horizontal:
+                cursor += child->m_rect.w + m_box.spacing;
+                break;
+            case UILayout::Absolute:
+                break;
+        }
+    }
+    m_descendantLayoutDirty = false;
+}
+
+void UIElement::draw(std::shared_ptr<ApplicationContext> ctx) noexcept {
+    SDL_Renderer& renderer = ctx->frames().renderer();
+
+    if (m_parent == nullptr) {
+        int width = 0;
+        int height = 0;
+        if (!SDL_GetRenderOutputSize(&renderer, &width, &height)) {
+            Log::error("Could not get the render output size: {}", SDL_GetError());
+        }
+        layout(SDL_FRect{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)});
+    }
+
+    drawTree(renderer, glm::fvec2(0.0f, 0.0f));
+}
+
+void UIElement::drawTree(SDL_Renderer& renderer, glm::fvec2 origin) noexcept {
+    if (!m_visible) {
+        return;
+    }
+
+    if (m_cachedToTexture) {
+        if (m_cacheDirty || m_cache == nullptr) {
+            rasteriseCache(renderer);
+        }
+        if (m_cache != nullptr) {
+            SDL_FRect destination{m_rect.x - origin.x, m_rect.y - origin.y, m_rect.w, m_rect.h};
+            SDL_RenderTexture(&renderer, m_cache, nullptr, &destination);
+            return;
+        }
+        // If no texture could be created, draw directly instead
+    }
+
+    drawContents(renderer, origin);
+}
+
+void UIElement::drawContents(SDL_Renderer& renderer, glm::fvec2 origin) noexcept {
+    SDL_FRect local{m_rect.x - origin.x, m_rect.y - origin.y, m_rect.w, m_rect.h};
+    drawSelf(renderer, local);
+
+    for (const std::unique_ptr<UIElement>& child : m_children) {
+        child->drawTree(renderer, origin);
+    }
+}
+
+void UIElement::rasteriseCache(SDL_Renderer& renderer) noexcept {
+    int width = static_cast<int>(std::ceil(m_rect.w));
+    int height = static_cast<int>(std::ceil(m_rect.h));
+    if (width <= 0 || height <= 0) {
+        releaseCache();
+        return;
+    }
+
+    if (m_cache == nullptr || m_cache->w != width || m_cache->h != height) {
+        releaseCache();
+        m_cache = SDL_CreateTexture(&renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (m_cache == nullptr) {
+            Log::warn("Could not create UI cache texture, drawing uncached: {}", SDL_GetError());
+            m_cachedToTexture = false;
+            return;
+        }
+        SDL_SetTextureBlendMode(m_cache, SDL_BLENDMODE_BLEND);
+    }
+
+    // Nested caches rasterise themselves into their own texture while drawn below, so restore whatever target was set
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(&renderer);
+    SDL_SetRenderTarget(&renderer, m_cache);
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderClear(&renderer);
+
+    drawContents(renderer, glm::fvec2(m_rect.x, m_rect.y));
+
+    SDL_SetRenderTarget(&renderer, previousTarget);
+    m_cacheDirty = false;
+}
+
+void UIElement::releaseCache() noexcept {
+    if (m_cache != nullptr) {
+        SDL_DestroyTexture(m_cache);
+        m_cache = nullptr;
+    }
+}
+
+void UIPanel::setColour(SDL_Color colour) noexcept {
+    if (colour.r == m_colour.r && colour.g == m_colour.g && colour.b == m_colour.b && colour.a == m_colour.a) {
+        return;
+    }
+    m_colour = colour;
+    invalidateVisuals();
+}
+
+void UIPanel::drawSelf(SDL_Renderer& renderer, const SDL_FRect& rect) noexcept {
+    SDL_SetRenderDrawColor(&renderer, m_colour.r, m_colour.g, m_colour.b, m_colour.a);
+    SDL_RenderFillRect(&renderer, &rect);
+}
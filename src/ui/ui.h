@@ -1,2 +1,135 @@
 #pragma once
 
+#include <SDL3/SDL.h>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <entities/entity.h>
+#include <meta/processing.h>
+
+/** How an element places its children within its content area */
+enum class UILayout {
+    /** Each child is placed independently, by its own anchor and offset */
+    Absolute,
+    /** Children are stacked top to bottom */
+    Vertical,
+    /** Children are stacked left to right */
+    Horizontal
+};
+
+/** Placement of an element within the slot its parent gives it. All values in pixels unless stated otherwise */
+struct UIBox {
+    glm::fvec2 offset = glm::fvec2(0.0f, 0.0f);
+    glm::fvec2 size = glm::fvec2(0.0f, 0.0f);
+    /** Fraction of the slot size added on top of size. (1, 1) fills the slot entirely */
+    glm::fvec2 relativeSize = glm::fvec2(0.0f, 0.0f);
+    /** Where in the slot the element sits. (0, 0) is top left, (1, 1) bottom right */
+    glm::fvec2 anchor = glm::fvec2(0.0f, 0.0f);
+    /** Space between this elements edge and its children */
+    float padding = 0.0f;
+    /** Space between stacked children */
+    float spacing = 0.0f;
+};
+
+/**
+ * Retained mode UI element. Elements form a tree, and computed rectangles are cached until something invalidates them.
+ * Only subtrees with invalidated layout are laid out again, and elements with texture caching enabled are only
+ * rasterised again when something within them changed visually.
+ */
+class UIElement : public IEntity, public IDrawable {
+public:
+    UIElement() = default;
+    UIElement(UIBox box) : m_box(box) {};
+    virtual ~UIElement();
+
+    UIElement(const UIElement&) = delete;
+    UIElement& operator=(const UIElement&) = delete;
+
+    /** Construct a child in place and take ownership of it */
+    template<std::derived_from<UIElement> T, typename... Args>
+    T* addChild(Args&&... args) {
+        auto child = std::make_unique<T>(std::forward<Args>(args)...);
+        T* raw = child.get();
+        adoptChild(std::move(child));
+        return raw;
+    }
+    /** Releases ownership of the child to the caller. Returns nullptr if it isn't a child of this element */
+    std::unique_ptr<UIElement> removeChild(UIElement* child);
+
+    UIElement* parent() const noexcept { return m_parent; }
+    const std::vector<std::unique_ptr<UIElement>>& children() const noexcept { return m_children; }
+
+    const UIBox& box() const noexcept { return m_box; }
+    void setBox(const UIBox& box) noexcept;
+    void setLayout(UILayout layout) noexcept;
+    void setVisible(bool visible) noexcept;
+    bool isVisible() const noexcept { return m_visible; }
+    /**
+     * Rasterise this element and all its children into a texture, which is only redrawn when something within it changes.
+     * Worth it for static panels with many children, not so much for anything changing every frame.
+     */
+    void setCachedToTexture(bool cached) noexcept;
+
+    /** Cached result of the last layout, in screen space */
+    const SDL_FRect& rect() const noexcept { return m_rect; }
+
+    /** This elements placement or its children changed. The subtree is laid out again on the next layout pass */
+    void invalidateLayout() noexcept;
+    /** This element looks different, but takes up the same space. Invalidates all cached textures containing it */
+    void invalidateVisuals() noexcept;
+
+    /** Lay out all invalidated subtrees. available is the slot given by the parent, or the screen for the root */
+    void layout(const SDL_FRect& available) noexcept;
+
+    /** Lays out the tree against the render output if this is the root, then draws it */
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override;
+
+protected:
+    /** Draw only this element, rect is where it is in the current render target. Children are drawn afterwards */
+    virtual void drawSelf(SDL_Renderer&, const SDL_FRect&) noexcept {};
+    /** Called whenever the rectangle of this element was recomputed */
+    virtual void onLayout() noexcept {};
+
+private:
+    UIElement* m_parent = nullptr;
+    std::vector<std::unique_ptr<UIElement>> m_children;
+
+    UIBox m_box;
+    UILayout m_layout = UILayout::Absolute;
+    bool m_visible = true;
+
+    SDL_FRect m_rect = {0.0f, 0.0f, 0.0f, 0.0f};
+    /** The slot this element was last laid out in. Changes to it force a relayout, even if this element is clean */
+    SDL_FRect m_slot = {0.0f, 0.0f, 0.0f, 0.0f};
+    bool m_layoutDirty = true;
+    /** Some descendant has its layout invalidated, this element itself might not */
+    bool m_descendantLayoutDirty = false;
+
+    bool m_cachedToTexture = false;
+    bool m_cacheDirty = false;
+    SDL_Texture* m_cache = nullptr;
+
+    void adoptChild(std::unique_ptr<UIElement> child);
+    void layoutChildren() noexcept;
+    /** origin is where the current render target sits in screen space */
+    void drawTree(SDL_Renderer& renderer, glm::fvec2 origin) noexcept;
+    void drawContents(SDL_Renderer& renderer, glm::fvec2 origin) noexcept;
+    void rasteriseCache(SDL_Renderer& renderer) noexcept;
+    void releaseCache() noexcept;
+};
+
+/** Plain coloured rectangle, the basic building block of most HUD elements */
+class UIPanel : public UIElement {
+public:
+    UIPanel(UIBox box, SDL_Color colour) : UIElement(box), m_colour(colour) {};
+
+    SDL_Color colour() const noexcept { return m_colour; }
+    void setColour(SDL_Color colour) noexcept;
+
+protected:
+    void drawSelf(SDL_Renderer& renderer, const SDL_FRect& rect) noexcept override;
+
+private:
+    SDL_Color m_colour;
+};
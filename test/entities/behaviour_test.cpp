@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+
+#include <entities/behaviour.h>
+#include <entities/entity.h>
+#include <input/input.h>
+
+static SDL_Event keyEvent(SDL_EventType type, SDL_Scancode code) {
+    SDL_Event event{};
+    event.type = type;
+    event.key.type = type;
+    event.key.scancode = code;
+    return event;
+}
+
+static Behaviour script(std::vector<std::string>& log) {
+    log.push_back("start");
+    co_await nextTick();
+    log.push_back("tick");
+    co_await delay(2.0f);
+    log.push_back("delay");
+    co_await keyPressed(SDL_SCANCODE_SPACE);
+    log.push_back("key");
+    CollisionBegan hit = co_await collision();
+    log.push_back(std::format("hit {}", hit.entityB));
+}
+
+TEST(BehaviourTest, ResumesOnlyOnceWaitIsOver) {
+    EventBus events;
+    BehaviourScheduler scheduler(&events);
+    InputManager input;
+    std::vector<std::string> log;
+
+    scheduler.start(script(log), 7);
+    EXPECT_EQ(log.size(), 1);
+
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(log.back(), "tick");
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(scheduler.resumedLastUpdate(), 0);
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(log.back(), "delay");
+
+    // Waiting on a key resumes nothing until it goes down
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(scheduler.resumedLastUpdate(), 0);
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_SPACE);
+    input.onEvent(&down);
+    input.onTickRisingEdge();
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(log.back(), "key");
+
+    // Collisions of other entities don't count
+    events.publish(CollisionBegan{3, 4});
+    events.dispatch();
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(log.back(), "key");
+    events.publish(CollisionBegan{7, 12});
+    events.dispatch();
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(log.back(), "hit 12");
+    EXPECT_EQ(scheduler.running(), 0);
+}
+
+static Behaviour forever(int& ticks) {
+    while (true) {
+        co_await nextTick();
+        ticks++;
+    }
+}
+
+TEST(BehaviourTest, CancelledWithTheirComponent) {
+    auto scheduler = std::make_shared<BehaviourScheduler>();
+    InputManager input;
+    int ticks = 0;
+    size_t framesBefore = CoroutineFramePool::inUse();
+    {
+        IEntity entity;
+        BehaviourComponent* behaviours = entity.addComponentAndGetRawPtr<BehaviourComponent>(scheduler, entity.getEntityId());
+        behaviours->start(forever(ticks));
+        behaviours->start(forever(ticks));
+        EXPECT_EQ(CoroutineFramePool::inUse(), framesBefore + 2);
+        scheduler->update(1.0f, input.snapshot());
+        EXPECT_EQ(ticks, 2);
+        EXPECT_EQ(behaviours->running(), 2);
+    }
+    EXPECT_EQ(scheduler->running(), 0);
+    EXPECT_EQ(CoroutineFramePool::inUse(), framesBefore);
+    scheduler->update(1.0f, input.snapshot());
+    EXPECT_EQ(ticks, 2);
+
+    // Frames go back to the pool, and are handed out again
+    void* frame = CoroutineFramePool::allocate(100);
+    CoroutineFramePool::deallocate(frame, 100);
+    EXPECT_EQ(CoroutineFramePool::allocate(100), frame);
+    CoroutineFramePool::deallocate(frame, 100);
+}
+
+static Behaviour failing() {
+    co_await nextTick();
+    throw std::runtime_error("scripted failure");
+}
+
+static Behaviour waitForHit() {
+    co_await collision();
+}
+
+TEST(BehaviourTest, ExceptionsReachTheCaller) {
+    BehaviourScheduler scheduler;
+    InputManager input;
+    scheduler.start(failing());
+    EXPECT_THROW(scheduler.update(1.0f, input.snapshot()), std::runtime_error);
+    EXPECT_EQ(scheduler.running(), 0);
+    // Collisions need an entity and a bus to come from
+    EXPECT_THROW(scheduler.start(waitForHit()), std::runtime_error);
+}
+
+static Behaviour waitFor(float duration, SDL_Scancode code) {
+    co_await delay(duration);
+    co_await keyPressed(code);
+    co_await collision();
+}
+
+TEST(BehaviourTest, CancelledWaitersAreTakenOffTheirLists) {
+    EventBus events;
+    BehaviourScheduler scheduler(&events);
+    InputManager input;
+    std::vector<BehaviourId> ids;
+    for (long long entity = 0; entity < 100; entity++) {
+        ids.push_back(scheduler.start(waitFor(1.0f + entity, SDL_SCANCODE_SPACE), entity));
+    }
+    EXPECT_EQ(scheduler.waitListSize(), 100);
+    // Cancelled timers stay in the heap until enough of it is stale
+    for (size_t i = 0; i < 60; i++) {
+        scheduler.cancel(ids[i]);
+    }
+    EXPECT_LE(scheduler.waitListSize(), 50);
+    EXPECT_EQ(scheduler.running(), 40);
+
+    // The rest wait for the key, then for a collision of their entity
+    scheduler.update(1000.0f, input.snapshot());
+    EXPECT_EQ(scheduler.waitListSize(), 40);
+    for (size_t i = 60; i < 70; i++) {
+        scheduler.cancel(ids[i]);
+    }
+    EXPECT_EQ(scheduler.waitListSize(), 30);
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_SPACE);
+    input.onEvent(&down);
+    input.onTickRisingEdge();
+    scheduler.update(1.0f, input.snapshot());
+    EXPECT_EQ(scheduler.waitListSize(), 30);
+    for (size_t i = 70; i < 100; i++) {
+        scheduler.cancel(ids[i]);
+    }
+    EXPECT_EQ(scheduler.waitListSize(), 0);
+    EXPECT_EQ(scheduler.running(), 0);
+}
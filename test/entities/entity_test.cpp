@@ -4,29 +4,28 @@
 #include <entities/entity.h>
 #include <entities/components.h>
 #include <collisions/collider.h>
+#include <scene/scene.h>
 
+class TagComponent : public IStandaloneEntityComponent {};
 
 TEST(ECSTest, ComponentIDs) {
-    
-    long long baseline = TransformComponent{}.getComponentId();
+    TransformComponent transform{};
+    TagComponent tag{};
+    EXPECT_NE(transform.getComponentId(), tag.getComponentId());
 
-    TransformComponent transform1{};
-    ASSERT_EQ(transform1.getComponentId(), baseline + 1);
-    
-    HealthComponent health1{200};
-    ASSERT_EQ(health1.getComponentId(), baseline + 2);
-    
-    TransformComponent transform2{};
-    ASSERT_EQ(transform2.getComponentId(), baseline + 3);
-    
-    HealthComponent health2{200};
-    ASSERT_EQ(health2.getComponentId(), baseline + 4);
-    
-    TransformComponent transform3{};
-    ASSERT_EQ(transform3.getComponentId(), baseline + 5);
-    
-    HealthComponent health3{};
-    ASSERT_EQ(health3.getComponentId(), baseline + 6);
+    // Copies are components of their own
+    TagComponent copy = tag;
+    EXPECT_NE(copy.getComponentId(), tag.getComponentId());
+
+    // A destroyed component's index comes back with a new generation, so the id itself is never repeated
+    long long released;
+    {
+        TagComponent temporary{};
+        released = temporary.getComponentId();
+    }
+    TagComponent reused{};
+    EXPECT_EQ(IdSpace::index(reused.getComponentId()), IdSpace::index(released));
+    EXPECT_EQ(IdSpace::generation(reused.getComponentId()), IdSpace::generation(released) + 1);
 }
 
 
@@ -136,3 +135,168 @@ TEST(ECSTest, RangingOverComponents) {
     ASSERT_EQ(ttCB->tickCount, expectedTickCount);
     ASSERT_EQ(ttCC->tickCount, expectedTickCount);
 }
+
+TEST(ECSTest, EventsAreDispatchedInBatches) {
+    EventBus events;
+    std::vector<long long> destroyed;
+    size_t batches = 0;
+    events.subscribe<EntityDestroyed>([&](std::span<const EntityDestroyed> batch) {
+        batches++;
+        for (const EntityDestroyed& event : batch) {
+            destroyed.push_back(event.entityId);
+        }
+    });
+
+    long long firstId;
+    long long secondId;
+    {
+        IEntity first;
+        IEntity second;
+        first.setEventBus(&events);
+        second.setEventBus(&events);
+        firstId = first.getEntityId();
+        secondId = second.getEntityId();
+        first.addComponent<TransformComponent>();
+    }
+    EXPECT_EQ(events.pending<ComponentAdded>(), 1);
+    EXPECT_TRUE(destroyed.empty());
+
+    events.dispatch();
+    EXPECT_EQ(batches, 1);
+    ASSERT_EQ(destroyed.size(), 2);
+    EXPECT_EQ(destroyed[0], secondId);
+    EXPECT_EQ(destroyed[1], firstId);
+    EXPECT_EQ(events.pending<ComponentAdded>(), 0);
+}
+
+class AccountedComponent : public IStandaloneEntityComponent {
+public:
+    char payload[100];
+};
+
+TEST(ECSTest, MemoryAccountingPerComponentType) {
+    TypeMemoryStats& stats = MemoryAccounting::of<AccountedComponent>();
+    {
+        IEntity first;
+        IEntity second;
+        first.addComponent<AccountedComponent>();
+        second.addComponent<AccountedComponent>();
+        EXPECT_EQ(stats.live, 2);
+        EXPECT_EQ(first.componentBytes(), sizeof(AccountedComponent));
+
+        // Replacing one destroys the previous
+        first.addComponent<AccountedComponent>();
+        EXPECT_EQ(stats.live, 2);
+        EXPECT_EQ(stats.allocations, 3);
+        EXPECT_TRUE(second.removeComponent<AccountedComponent>());
+        EXPECT_EQ(stats.live, 1);
+    }
+    EXPECT_EQ(stats.live, 0);
+    // Briefly, while replacing, both the previous and the new one existed
+    EXPECT_EQ(stats.peakLive, 3);
+
+    MemoryAccounting::onFrame();
+    std::vector<TypeMemoryReport> report = MemoryAccounting::report();
+    auto row = std::find_if(report.begin(), report.end(), [](const TypeMemoryReport& row) { return row.name == "AccountedComponent"; });
+    ASSERT_NE(row, report.end());
+    EXPECT_EQ(row->peakBytes, 3 * sizeof(AccountedComponent));
+    EXPECT_EQ(row->allocationsLastFrame, 3);
+}
+
+class BulkyEntity : public IGameplayEntity {
+public:
+    char payload[200];
+};
+
+TEST(ECSTest, EntitiesAreAccountedAsTheirOwnType) {
+    TypeMemoryStats& bulky = MemoryAccounting::of<BulkyEntity>();
+    SceneContext scene;
+    {
+        BulkyEntity first;
+        EXPECT_EQ(bulky.live, 0);
+        scene.registerEntity(&first);
+        EXPECT_EQ(bulky.live, 1);
+        EXPECT_EQ(&first.memoryStats(), &bulky);
+        {
+            BulkyEntity second;
+            // Through a base pointer the entity type isn't known, so it stays what it was
+            scene.registerEntity(static_cast<IGameplayEntity*>(&second));
+            EXPECT_EQ(bulky.live, 1);
+
+            SceneMemory memory = scene.memory();
+            EXPECT_EQ(memory.entityBytes, sizeof(BulkyEntity) + sizeof(IEntity));
+        }
+        scene.events().dispatch();
+        SceneMemory memory = scene.memory();
+        EXPECT_EQ(memory.entityBytes, sizeof(BulkyEntity));
+        EXPECT_EQ(memory.peakEntities, 2);
+        EXPECT_EQ(memory.peakEntityBytes, sizeof(BulkyEntity) + sizeof(IEntity));
+    }
+    EXPECT_EQ(bulky.live, 0);
+}
+
+TEST(ECSTest, SceneMemoryCountsAllocationsOfItsTypes) {
+    SceneContext scene;
+    IGameplayEntity entity;
+    scene.registerEntity(&entity);
+    MemoryAccounting::onFrame();
+    entity.addComponent<AccountedComponent>();
+    entity.addComponent<AccountedComponent>();
+    MemoryAccounting::onFrame();
+    // The entity itself was made a frame earlier
+    EXPECT_EQ(scene.memory().allocationsLastFrame, 2);
+}
+
+struct PlainTestComponent {
+    float speed = 1.0f;
+    uint8_t team = 0;
+};
+
+template<>
+struct Reflection<PlainTestComponent> {
+    static constexpr const char* name = "PlainTestComponent";
+    static constexpr auto fields = std::tuple{field("speed", &PlainTestComponent::speed), field("team", &PlainTestComponent::team)};
+};
+
+TEST(ECSTest, PlainComponentsAreReflectedAndPooled) {
+    using Layout = TypeLayout<PlainTestComponent>;
+    static_assert(PlainComponent<PlainTestComponent>);
+    static_assert(!PlainComponent<TransformComponent>);
+    static_assert(Layout::fieldCount == 2 && Layout::fieldBytes == 5);
+    static_assert(!Layout::packed, "Padded after team");
+    static_assert(TypeLayout<HealthComponent>::packed);
+    std::vector<FieldLayout> fields = Layout::fields();
+    ASSERT_EQ(fields.size(), 2);
+    EXPECT_STREQ(fields[1].name, "team");
+    EXPECT_EQ(fields[1].offset, offsetof(PlainTestComponent, team));
+
+    PlainComponentPool<PlainTestComponent>& pool = PlainComponentPool<PlainTestComponent>::instance();
+    {
+        IEntity first;
+        IEntity second;
+        PlainTestComponent* a = first.addComponentAndGetRawPtr<PlainTestComponent>(PlainTestComponent{2.0f, 1});
+        PlainTestComponent* b = second.addComponentAndGetRawPtr<PlainTestComponent>();
+        EXPECT_EQ(b, a + 1);
+        EXPECT_EQ(pool.size(), 2);
+        EXPECT_EQ(first.componentCount(), 1);
+        EXPECT_EQ(first.componentBytes(), sizeof(PlainTestComponent));
+
+        // Replaced in place, so cached pointers stay valid
+        uint32_t version = first.structureVersion();
+        EXPECT_EQ(first.addComponentGetPrevious<PlainTestComponent>(PlainTestComponent{3.0f, 2}), nullptr);
+        EXPECT_EQ(first.getComponent<PlainTestComponent>(), a);
+        EXPECT_FLOAT_EQ(a->speed, 3.0f);
+        EXPECT_NE(first.structureVersion(), version);
+
+        std::vector<long long> owners;
+        pool.forEach([&](long long entityId, PlainTestComponent&) { owners.push_back(entityId); });
+        EXPECT_EQ(owners, (std::vector<long long>{first.getEntityId(), second.getEntityId()}));
+
+        EXPECT_TRUE(second.removeComponent<PlainTestComponent>());
+        EXPECT_FALSE(second.removeComponent<PlainTestComponent>());
+        EXPECT_EQ(second.getComponent<PlainTestComponent>(), nullptr);
+        EXPECT_EQ(pool.size(), 1);
+    }
+    EXPECT_EQ(pool.size(), 0);
+    EXPECT_EQ(MemoryAccounting::of<PlainTestComponent>().live, 0);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <numbers>
+
+#include <entities/hierarchy.h>
+#include <meta/pipeline.h>
+
+TEST(TransformHierarchyTest, ChildrenFollowTheirParents) {
+    TransformComponent player(glm::fvec3(10.0f, 0.0f, 0.0f));
+    TransformComponent weapon(glm::fvec3(2.0f, 0.0f, 0.0f));
+    TransformComponent muzzle(glm::fvec3(1.0f, 0.0f, 0.0f));
+
+    TransformHierarchy hierarchy;
+    // Added out of order, the hierarchy sorts them by depth
+    TransformNode muzzleNode = hierarchy.add(&muzzle);
+    TransformNode playerNode = hierarchy.add(&player);
+    TransformNode weaponNode = hierarchy.add(&weapon, playerNode);
+    hierarchy.setParent(muzzleNode, weaponNode);
+    hierarchy.update();
+
+    EXPECT_FLOAT_EQ(hierarchy.worldPosition(muzzleNode).x, 13.0f);
+
+    // Rotating the player swings everything attached to it around
+    player.rotation = std::numbers::pi_v<float> / 2.0f;
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.lastUpdated(), 3);
+    EXPECT_NEAR(hierarchy.worldPosition(muzzleNode).x, 10.0f, 1e-5f);
+    EXPECT_NEAR(hierarchy.worldPosition(muzzleNode).y, 3.0f, 1e-5f);
+
+    // Only the changed subtree is recomputed
+    muzzle.position.x = 2.0f;
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.lastUpdated(), 1);
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.lastUpdated(), 0);
+
+    EXPECT_THROW(hierarchy.setParent(playerNode, muzzleNode), std::runtime_error);
+
+    // Removing the weapon attaches the muzzle to the player directly
+    hierarchy.remove(weaponNode);
+    EXPECT_EQ(hierarchy.parent(muzzleNode), playerNode);
+    EXPECT_THROW(hierarchy.world(weaponNode), std::runtime_error);
+    hierarchy.update();
+    EXPECT_NEAR(hierarchy.worldPosition(muzzleNode).y, 2.0f, 1e-5f);
+}
+
+TEST(TransformHierarchyTest, WorldTransformsReachCapture) {
+    TransformComponent player(glm::fvec3(10.0f, 5.0f, 1.0f), glm::fvec2(2.0f, 2.0f), std::numbers::pi_v<float> / 2.0f);
+    TransformComponent weapon(glm::fvec3(3.0f, 0.0f, 4.0f));
+    // Without a node, the local transform is the world transform
+    EXPECT_EQ(weapon.worldPosition(), weapon.position);
+
+    TransformHierarchy hierarchy;
+    TransformNode playerNode = hierarchy.add(&player);
+    TransformNode weaponNode = hierarchy.add(&weapon, playerNode);
+    hierarchy.update();
+    EXPECT_NEAR(weapon.worldPosition().x, 10.0f, 1e-5f);
+    EXPECT_NEAR(weapon.worldPosition().y, 11.0f, 1e-5f);
+    EXPECT_FLOAT_EQ(weapon.worldPosition().z, 4.0f);
+    EXPECT_NEAR(weapon.worldScale().x, 2.0f, 1e-5f);
+    EXPECT_NEAR(weapon.worldRotation(), std::numbers::pi_v<float> / 2.0f, 1e-5f);
+
+    RenderSnapshot snapshot;
+    snapshot.pushRect(weapon, glm::fvec2(1.0f, 1.0f), SDL_Color{255, 255, 255, 255});
+    ASSERT_EQ(snapshot.rects.size(), 1);
+    EXPECT_NEAR(snapshot.rects[0].transform.position.y, 11.0f, 1e-5f);
+    EXPECT_NEAR(snapshot.rects[0].transform.scale.y, 2.0f, 1e-5f);
+
+    hierarchy.remove(weaponNode);
+    EXPECT_EQ(weapon.worldPosition(), weapon.position);
+}
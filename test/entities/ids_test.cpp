@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <entities/ids.h>
+#include <entities/entity.h>
+#include <scene/scene.h>
+
+TEST(IdSpaceTest, ThreadsAllocateUniqueDenseIds) {
+    IdSpace space;
+    constexpr size_t threads = 4;
+    constexpr size_t perThread = 1000;
+    std::vector<std::vector<long long>> allocated(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = 0; i < perThread; i++) {
+                allocated[t].push_back(space.allocate());
+                // Churn, recycled ids must not collide with live ones either
+                if (i % 3 == 0) {
+                    space.release(allocated[t].back());
+                    allocated[t].back() = space.allocate();
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<long long> all;
+    for (const std::vector<long long>& ids : allocated) {
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+    std::vector<uint32_t> indices;
+    for (long long id : all) {
+        indices.push_back(IdSpace::index(id));
+    }
+    std::sort(indices.begin(), indices.end());
+    EXPECT_EQ(std::adjacent_find(indices.begin(), indices.end()), indices.end());
+
+    // At most one partly used block per thread on top of what is live
+    EXPECT_LE(space.capacity(), (perThread / IdSpace::s_blockSize + 2) * IdSpace::s_blockSize * threads);
+}
+
+TEST(IdSpaceTest, ScopesGiveEntitiesTheirOwnNamespace) {
+    IdSpace scene;
+    IdSpace::Scope scope(scene);
+    IEntity first;
+    IEntity second;
+    EXPECT_EQ(&IdSpace::current(), &scene);
+    EXPECT_EQ(first.getEntityId(), 0);
+    EXPECT_EQ(second.getEntityId(), 1);
+    EXPECT_EQ(scene.capacity(), IdSpace::s_blockSize);
+
+    long long stale;
+    {
+        IEntity temporary;
+        stale = temporary.getEntityId();
+    }
+    IEntity reused;
+    EXPECT_EQ(IdSpace::index(reused.getEntityId()), IdSpace::index(stale));
+    EXPECT_NE(reused.getEntityId(), stale);
+}
+
+TEST(IdSpaceTest, ScenesOnlyTakeEntitiesOfOneSpace) {
+    IdSpace first;
+    IdSpace second;
+    SceneContext scene;
+    {
+        IdSpace::Scope scope(first);
+        IGameplayEntity kept;
+        scene.registerEntity(&kept);
+        {
+            IdSpace::Scope inner(second);
+            IGameplayEntity other;
+            // Same raw id, destroying it must not take the other entity with it
+            EXPECT_EQ(other.getEntityId(), kept.getEntityId());
+            EXPECT_THROW(scene.registerEntity(&other), std::runtime_error);
+        }
+        scene.events().dispatch();
+        EXPECT_EQ(scene.getEntities().size(), 1);
+    }
+    scene.events().dispatch();
+    EXPECT_TRUE(scene.getEntities().empty());
+}
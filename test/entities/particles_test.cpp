@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <entities/entity.h>
+#include <entities/particles.h>
+
+TEST(ParticleEmitterTest, EmitsAgesAndRetiresParticles) {
+    IEntity entity;
+    entity.addComponent<TransformComponent>(glm::fvec3(10.0f, 20.0f, 0.0f));
+    ParticleEmitterConfig config;
+    config.capacity = 100;
+    config.rate = 2.5f;
+    config.lifetime = 3.0f;
+    ParticleEmitter* emitter = entity.addComponentAndGetRawPtr<ParticleEmitter>(config);
+
+    // Fractions carry over
+    emitter->update(1.0f);
+    EXPECT_EQ(emitter->alive(), 2);
+    emitter->update(1.0f);
+    EXPECT_EQ(emitter->alive(), 5);
+
+    // Never past capacity
+    EXPECT_EQ(emitter->burst(1000), 95);
+    emitter->setEmitting(false);
+
+    // The first two reach the end of their lifetime, and are swapped out
+    emitter->update(1.0f);
+    EXPECT_EQ(emitter->alive(), 100);
+    emitter->update(1.0f);
+    EXPECT_EQ(emitter->alive(), 98);
+
+    std::vector<float> xy;
+    std::vector<SDL_FColor> colours;
+    emitter->appendTriangles(xy, colours);
+    EXPECT_EQ(colours.size(), 98 * 3);
+    EXPECT_EQ(xy.size(), 98 * 6);
+
+    // Only what is safe to change while running can be
+    emitter->setLifetime(10.0f);
+    EXPECT_FLOAT_EQ(emitter->config().lifetime, 10.0f);
+    EXPECT_THROW(emitter->setLifetime(0.0f), std::runtime_error);
+    EXPECT_THROW(emitter->setRate(-1.0f), std::runtime_error);
+    EXPECT_FLOAT_EQ(emitter->config().lifetime, 10.0f);
+}
+
+TEST(ParticleEmitterTest, WorkersMatchSingleThreadedUpdate) {
+    ParticleEmitterConfig config;
+    config.capacity = 200003;
+    config.rate = 0.0f;
+    config.lifetime = 1000.0f;
+    config.gravity = glm::fvec2(0.0f, 0.5f);
+
+    IEntity single;
+    single.addComponent<TransformComponent>();
+    ParticleEmitter* reference = single.addComponentAndGetRawPtr<ParticleEmitter>(config);
+    config.workers = 4;
+    IEntity threaded;
+    threaded.addComponent<TransformComponent>();
+    ParticleEmitter* parallel = threaded.addComponentAndGetRawPtr<ParticleEmitter>(config);
+
+    reference->burst(config.capacity);
+    parallel->burst(config.capacity);
+    for (int i = 0; i < 3; i++) {
+        reference->update(1.0f);
+        parallel->update(1.0f);
+    }
+
+    std::vector<float> expected, actual;
+    std::vector<SDL_FColor> colours;
+    reference->appendTriangles(expected, colours);
+    parallel->appendTriangles(actual, colours);
+    EXPECT_EQ(expected, actual);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <input/input.h>
+#include <input/matcher.h>
+#include <input/recording.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+static std::vector<char> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static SDL_Event keyEvent(SDL_EventType type, SDL_Scancode code) {
+    SDL_Event event{};
+    event.type = type;
+    event.key.type = type;
+    event.key.scancode = code;
+    return event;
+}
+
+TEST(InputTest, EdgesLastExactlyOneTick) {
+    InputManager input;
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W);
+    input.onEvent(&down);
+
+    // Queued events are only applied on tick
+    EXPECT_FALSE(input.isDown(SDL_SCANCODE_W));
+    EXPECT_FALSE(input.snapshot().isDown(SDL_SCANCODE_W));
+
+    input.onTickRisingEdge();
+    EXPECT_TRUE(input.isDown(SDL_SCANCODE_W));
+    EXPECT_TRUE(input.snapshot().isDown(SDL_SCANCODE_W));
+    EXPECT_TRUE(input.snapshot().wasPressed(SDL_SCANCODE_W));
+    EXPECT_FALSE(input.snapshot().wasPressed(SDL_SCANCODE_S));
+
+    input.onTickRisingEdge();
+    EXPECT_TRUE(input.snapshot().isDown(SDL_SCANCODE_W));
+    EXPECT_FALSE(input.snapshot().wasPressed(SDL_SCANCODE_W));
+}
+
+TEST(InputTest, TapBetweenTicksIsPressedAndReleased) {
+    InputManager input;
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_SPACE);
+    SDL_Event up = keyEvent(SDL_EVENT_KEY_UP, SDL_SCANCODE_SPACE);
+    input.onEvent(&down);
+    input.onEvent(&up);
+    input.onTickRisingEdge();
+
+    const InputSnapshot& snapshot = input.snapshot();
+    EXPECT_FALSE(snapshot.isDown(SDL_SCANCODE_SPACE));
+    EXPECT_TRUE(snapshot.wasPressed(SDL_SCANCODE_SPACE));
+    EXPECT_TRUE(snapshot.wasReleased(SDL_SCANCODE_SPACE));
+    EXPECT_EQ(input.state(SDL_SCANCODE_SPACE), InputState::Up);
+}
+
+TEST(InputTest, WheelAccumulatesPerTick) {
+    InputManager input;
+    input.queueEvent(InputEvent{InputEventType::MouseWheel, 0, SDL_SCANCODE_UNKNOWN, 0, glm::vec2(0.0f, 1.0f), 0});
+    input.queueEvent(InputEvent{InputEventType::MouseWheel, 0, SDL_SCANCODE_UNKNOWN, 0, glm::vec2(0.5f, 2.0f), 0});
+    input.onTickRisingEdge();
+    EXPECT_FLOAT_EQ(input.snapshot().mouseWheel().x, 0.5f);
+    EXPECT_FLOAT_EQ(input.snapshot().mouseWheel().y, 3.0f);
+
+    input.onTickRisingEdge();
+    EXPECT_FLOAT_EQ(input.snapshot().mouseWheel().y, 0.0f);
+}
+
+TEST(InputTest, ScancodeSetIteratesInOrder) {
+    ScancodeSet set;
+    set.set(SDL_SCANCODE_W);
+    set.set(SDL_SCANCODE_A);
+    set.set(static_cast<SDL_Scancode>(SDL_SCANCODE_COUNT - 1));
+    // Out of range is ignored rather than written out of bounds
+    set.set(SDL_SCANCODE_COUNT);
+
+    std::vector<SDL_Scancode> visited;
+    set.forEach([&](SDL_Scancode code) { visited.push_back(code); });
+    ASSERT_EQ(visited.size(), 3);
+    EXPECT_EQ(visited[0], SDL_SCANCODE_A);
+    EXPECT_EQ(visited[1], SDL_SCANCODE_W);
+    EXPECT_EQ(visited[2], SDL_SCANCODE_COUNT - 1);
+}
+
+static InputEvent press(SDL_Scancode code, ms timestamp) {
+    return InputEvent{InputEventType::KeyDown, 0, code, 0, glm::vec2(0.0f, 0.0f), timestamp};
+}
+
+static InputEvent release(SDL_Scancode code, ms timestamp) {
+    return InputEvent{InputEventType::KeyUp, 0, code, 0, glm::vec2(0.0f, 0.0f), timestamp};
+}
+
+TEST(InputMatcherTest, SequenceSurvivesOverlappingPrefix) {
+    InputMatcher matcher;
+    int matches = 0;
+    matcher.addSequence(
+        {InputTrigger::key(SDL_SCANCODE_A), InputTrigger::key(SDL_SCANCODE_A), InputTrigger::key(SDL_SCANCODE_B)},
+        100, [&](InputPatternId, ms) { matches++; }
+    );
+
+    // A A A B still contains A A B
+    matcher.onEvent(press(SDL_SCANCODE_A, 0));
+    matcher.onEvent(press(SDL_SCANCODE_A, 50));
+    matcher.onEvent(press(SDL_SCANCODE_A, 100));
+    EXPECT_EQ(matches, 0);
+    matcher.onEvent(press(SDL_SCANCODE_B, 150));
+    EXPECT_EQ(matches, 1);
+
+    // Too slow
+    matcher.onEvent(press(SDL_SCANCODE_A, 1000));
+    matcher.onEvent(press(SDL_SCANCODE_A, 1050));
+    matcher.onEvent(press(SDL_SCANCODE_B, 1200));
+    EXPECT_EQ(matches, 1);
+
+    // Interrupted
+    matcher.onEvent(press(SDL_SCANCODE_A, 2000));
+    matcher.onEvent(press(SDL_SCANCODE_A, 2050));
+    matcher.onEvent(press(SDL_SCANCODE_W, 2060));
+    matcher.onEvent(press(SDL_SCANCODE_B, 2070));
+    EXPECT_EQ(matches, 1);
+}
+
+TEST(InputMatcherTest, ChordFiresOncePerPress) {
+    InputMatcher matcher;
+    int matches = 0;
+    matcher.addChord({InputTrigger::key(SDL_SCANCODE_A), InputTrigger::key(SDL_SCANCODE_S)}, 50,
+        [&](InputPatternId, ms) { matches++; });
+
+    matcher.onEvent(press(SDL_SCANCODE_A, 0));
+    matcher.onEvent(press(SDL_SCANCODE_S, 20));
+    EXPECT_EQ(matches, 1);
+    matcher.onEvent(press(SDL_SCANCODE_W, 30));
+    EXPECT_EQ(matches, 1);
+
+    matcher.onEvent(release(SDL_SCANCODE_S, 40));
+    matcher.onEvent(press(SDL_SCANCODE_S, 200));
+    // A went down too long before S this time
+    EXPECT_EQ(matches, 1);
+}
+
+TEST(InputMatcherTest, MatchedOnTickThroughInputManager) {
+    InputManager input;
+    int doubleTaps = 0;
+    InputPatternId id = input.matcher().addDoubleTap(InputTrigger::key(SDL_SCANCODE_D), 1000,
+        [&](InputPatternId, ms) { doubleTaps++; });
+
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_D);
+    SDL_Event up = keyEvent(SDL_EVENT_KEY_UP, SDL_SCANCODE_D);
+    input.onEvent(&down);
+    input.onEvent(&up);
+    input.onEvent(&down);
+    EXPECT_EQ(doubleTaps, 0);
+
+    input.onTickRisingEdge();
+    EXPECT_EQ(doubleTaps, 1);
+    EXPECT_TRUE(input.matcher().remove(id));
+    EXPECT_FALSE(input.matcher().remove(id));
+}
+
+TEST(InputRecordingTest, ReplayReproducesTickState) {
+    std::string path = (std::filesystem::temp_directory_path() / "sdlgame_input_test.sgir").string();
+
+    InputRecorder recorder;
+    ASSERT_TRUE(recorder.open(path.c_str()));
+    InputManager live;
+    live.setRecorder(&recorder);
+
+    SDL_Event down = keyEvent(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W);
+    SDL_Event up = keyEvent(SDL_EVENT_KEY_UP, SDL_SCANCODE_W);
+    down.key.key = SDLK_W;
+    up.key.key = SDLK_W;
+    live.onTickRisingEdge();
+    live.onEvent(&down);
+    live.onTickRisingEdge();
+    live.onTickRisingEdge();
+    live.onEvent(&up);
+    live.onTickRisingEdge();
+    recorder.close();
+    ASSERT_EQ(recorder.recordedEvents(), 2);
+
+    InputReplay replay;
+    replay.load(path.c_str());
+    EXPECT_EQ(replay.lastTick(), 4);
+
+    // Recording the replay again gives the same file, keycodes included
+    std::string again = (std::filesystem::temp_directory_path() / "sdlgame_input_test_again.sgir").string();
+    InputRecorder rerecorder;
+    ASSERT_TRUE(rerecorder.open(again.c_str()));
+    InputManager replayed;
+    replayed.setRecorder(&rerecorder);
+    replay.attach(replayed);
+    std::vector<bool> downPerTick;
+    while (!replay.finished()) {
+        replay.feed(replayed.tick() + 1, replayed);
+        replayed.onTickRisingEdge();
+        downPerTick.push_back(replayed.snapshot().isDown(SDL_SCANCODE_W));
+    }
+
+    EXPECT_EQ(downPerTick, (std::vector<bool>{false, true, true, false}));
+    EXPECT_EQ(replayed.now(), replay.clockAt(4));
+    rerecorder.close();
+    EXPECT_EQ(readFile(again), readFile(path));
+    std::vector<char> recorded = readFile(path);
+    ASSERT_EQ(recorded.size(), sizeof(InputRecordingHeader) + 2 * sizeof(InputRecord));
+    InputRecord first;
+    std::memcpy(&first, recorded.data() + sizeof(InputRecordingHeader), sizeof(first));
+    EXPECT_EQ(first.key, SDLK_W);
+    std::filesystem::remove(path);
+    std::filesystem::remove(again);
+}
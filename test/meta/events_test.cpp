@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <meta/events.h>
+
+struct FirstEvent {
+    int value;
+};
+
+struct NeverSeenEvent {
+    int value;
+};
+
+TEST(EventBusTest, HandlersMaySubscribePublishAndUnsubscribe) {
+    EventBus events;
+    std::vector<int> received;
+    EventSubscriptionId self = -1;
+    self = events.subscribe<FirstEvent>([&](std::span<const FirstEvent> batch) {
+        // First use of a type from within dispatch grows the bus while it is being walked
+        events.subscribe<NeverSeenEvent>([&](std::span<const NeverSeenEvent> batch) {
+            for (const NeverSeenEvent& event : batch) {
+                received.push_back(event.value);
+            }
+        });
+        events.publish(NeverSeenEvent{batch[0].value * 10});
+        // Destroying this handler's captures while it runs would be fatal
+        EXPECT_TRUE(events.unsubscribe(self));
+        received.push_back(batch[0].value);
+    });
+
+    events.publish(FirstEvent{1});
+    events.dispatch();
+    events.dispatch();
+    EXPECT_EQ(received, (std::vector<int>{1, 10}));
+
+    // Gone for good
+    events.publish(FirstEvent{2});
+    events.dispatch();
+    EXPECT_EQ(received, (std::vector<int>{1, 10}));
+    EXPECT_FALSE(events.unsubscribe(self));
+}
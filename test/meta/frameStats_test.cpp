@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <meta/frameStats.h>
+
+TEST(RollingHistogramTest, PercentilesAndMaxFollowTheWindow) {
+    RollingHistogram histogram(4, 1.0, 10);
+    EXPECT_EQ(histogram.percentile(0.5), 0.0);
+
+    for (double sample : {0.5, 1.5, 2.5, 3.5}) {
+        histogram.push(sample);
+    }
+    // Upper edge of the bucket the percentile lands in
+    EXPECT_DOUBLE_EQ(histogram.percentile(0.5), 2.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(1.0), 4.0);
+    EXPECT_DOUBLE_EQ(histogram.max(), 3.5);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 2.0);
+
+    // Evicts 0.5 and 1.5, and the overflow bucket reports the largest sample
+    histogram.push(50.0);
+    histogram.push(4.5);
+    EXPECT_EQ(histogram.count(), 4);
+    EXPECT_DOUBLE_EQ(histogram.latest(), 4.5);
+    EXPECT_DOUBLE_EQ(histogram.percentile(0.25), 3.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(1.0), 50.0);
+    EXPECT_DOUBLE_EQ(histogram.max(), 50.0);
+    EXPECT_DOUBLE_EQ(histogram.mean(), (2.5 + 3.5 + 50.0 + 4.5) / 4);
+
+    // Once the spike leaves the window, so does the max
+    for (int i = 0; i < 4; i++) {
+        histogram.push(1.0);
+    }
+    EXPECT_DOUBLE_EQ(histogram.max(), 1.0);
+}
+
+TEST(FrameStatisticsTest, ReportsHitchesAgainstTheMedianAndExports) {
+    FrameStatistics statistics(100);
+    statistics.setHitchThreshold(2.0, 20.0);
+    std::vector<uint32_t> hitches;
+    statistics.onHitch([&](const FrameSample& sample, double) { hitches.push_back(sample.frame); });
+
+    // No history to compare against yet
+    statistics.onFrame(0, 100.0);
+    uint32_t frame = 1;
+    for (; frame < 40; frame++) {
+        statistics.recordTick(4.0);
+        statistics.onFrame(frame, 16.0);
+    }
+    // Above the median but below the absolute hitch threshold
+    statistics.onFrame(frame++, 19.0);
+    statistics.onFrame(frame++, 60.0);
+    EXPECT_EQ(hitches, (std::vector<uint32_t>{41}));
+
+    std::string path = (std::filesystem::temp_directory_path() / "sdlgame_frames_test.csv").string();
+    ASSERT_TRUE(statistics.exportCsv(path.c_str()));
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    EXPECT_EQ(line, "frame,frame_ms,tick_ms,draw_ms");
+    std::getline(file, line);
+    EXPECT_EQ(line.substr(0, 2), "0,");
+    size_t rows = 1;
+    while (std::getline(file, line)) {
+        rows++;
+    }
+    EXPECT_EQ(rows, 42);
+    file.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include <meta/log.h>
+
+class LogTest : public testing::Test {
+protected:
+    std::mutex mutex;
+    std::vector<std::string> messages;
+
+    void SetUp() override {
+        Log::start([this](LogLevel level, std::string_view message) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.emplace_back(message);
+        });
+    }
+    void TearDown() override {
+        Log::stop();
+        Log::setRateLimit(10);
+    }
+};
+
+TEST_F(LogTest, FormatsOnTheWriterThread) {
+    {
+        // Gone long before the writer gets to it
+        std::string name = "player";
+        Log::info("{} at {}, {:.1f}", name, 3, 2.5f);
+    }
+    std::thread other([]() {
+        Log::debug("from {}", "elsewhere");
+    });
+    other.join();
+    Log::flush();
+
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0], "player at 3, 2.5");
+    EXPECT_EQ(messages[1], "from elsewhere");
+
+    // Too long to defer, cut to fit instead
+    Log::info("{}", std::string(1000, 'x'));
+    Log::flush();
+    EXPECT_EQ(messages.back().size(), LogRecord::s_payloadSize);
+}
+
+TEST_F(LogTest, RepeatedWarningsAreRateLimited) {
+    Log::setRateLimit(3);
+    for (int i = 0; i < 100; i++) {
+        Log::error("Draw failed {}", i);
+    }
+    // Info and below are never limited
+    for (int i = 0; i < 5; i++) {
+        Log::info("Report line {}", i);
+    }
+    Log::flush();
+    EXPECT_EQ(messages.size(), 8);
+    EXPECT_EQ(messages[2], "Draw failed 2");
+    EXPECT_EQ(Log::dropped(), 0);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+
+#include <meta/pipeline.h>
+#include <meta/ApplicationContext.h>
+#include <scene/scene.h>
+
+TEST(TripleBufferTest, ConsumerSeesLatestPublished) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.acquire());
+
+    buffer.write() = 1;
+    buffer.publish();
+    buffer.write() = 2;
+    buffer.publish();
+    // Only the most recent one matters, the first is simply overwritten
+    ASSERT_TRUE(buffer.acquire());
+    EXPECT_EQ(buffer.read(), 2);
+    EXPECT_FALSE(buffer.acquire());
+    EXPECT_EQ(buffer.read(), 2);
+}
+
+TEST(TripleBufferTest, ValuesNeverGoBackwardsAcrossThreads) {
+    TripleBuffer<int> buffer;
+    constexpr int last = 20000;
+    std::thread producer([&]() {
+        for (int i = 1; i <= last; i++) {
+            buffer.write() = i;
+            buffer.publish();
+        }
+    });
+
+    int seen = 0;
+    bool ordered = true;
+    while (seen < last) {
+        if (buffer.acquire()) {
+            ordered = ordered && buffer.read() > seen;
+            seen = buffer.read();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(seen, last);
+}
+
+class PipelinedScene : public IScene, public ISnapshotDrawable {
+public:
+    std::atomic<int> ticks = 0;
+    std::thread::id lastTickThread;
+    int throwOnTick = -1;
+
+    PipelinedScene() : IScene(nullptr) {};
+
+    void tick(std::shared_ptr<ApplicationContext> ctx) override {
+        lastTickThread = std::this_thread::get_id();
+        if (++ticks == throwOnTick) {
+            throw std::runtime_error("tick failed");
+        }
+    }
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override {}
+    void capture(RenderSnapshot& snapshot) const noexcept override {
+        snapshot.clearColour.r = static_cast<Uint8>(ticks.load());
+    }
+};
+
+static std::shared_ptr<ApplicationContext> headlessContext() {
+    glm::fvec2 bounds(800.0f, 600.0f);
+    return ApplicationContext::create(&bounds, 0, nullptr, nullptr);
+}
+
+TEST(FramePipelineTest, TicksAheadOnWorkerAndFallsBackWhenDisabled) {
+    std::shared_ptr<ApplicationContext> ctx = headlessContext();
+    PipelinedScene* scene = new PipelinedScene();
+    ctx->changeScene(scene);
+    FramePipeline pipeline(ctx);
+
+    // Nothing captured yet, the first frame ticks inline and hands the worker the next tick
+    const RenderSnapshot* first = pipeline.beginFrame();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->frame, 1);
+    EXPECT_EQ(first->clearColour.r, 1);
+
+    // Drawn frame N is the state of tick N, while tick N+1 runs on the worker
+    const RenderSnapshot* second = pipeline.beginFrame();
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->frame, 2);
+    EXPECT_EQ(second->clearColour.r, 2);
+    EXPECT_NE(scene->lastTickThread, std::this_thread::get_id());
+
+    // Waits for the tick in flight, then ticks on this thread and draws in immediate mode
+    pipeline.setPipelined(false);
+    int ticks = scene->ticks;
+    // Every tick counts, including the inline one of the first frame
+    EXPECT_EQ(pipeline.ticksStarted(), ticks);
+    EXPECT_EQ(pipeline.beginFrame(), nullptr);
+    EXPECT_EQ(scene->ticks, ticks + 1);
+    EXPECT_EQ(pipeline.ticksStarted(), ticks + 1);
+    EXPECT_EQ(scene->lastTickThread, std::this_thread::get_id());
+
+    // The last capture is stale by now, so back to ticking inline once
+    pipeline.setPipelined(true);
+    const RenderSnapshot* resumed = pipeline.beginFrame();
+    ASSERT_NE(resumed, nullptr);
+    EXPECT_EQ(resumed->clearColour.r, ticks + 2);
+    EXPECT_TRUE(pipeline.isPipelined());
+}
+
+TEST(FramePipelineTest, WorkerExceptionsAreRethrownOnTheMainThread) {
+    std::shared_ptr<ApplicationContext> ctx = headlessContext();
+    PipelinedScene* scene = new PipelinedScene();
+    scene->throwOnTick = 2;
+    ctx->changeScene(scene);
+    FramePipeline pipeline(ctx);
+
+    ASSERT_NE(pipeline.beginFrame(), nullptr);
+    // Tick 2 threw on the worker
+    EXPECT_THROW(pipeline.beginFrame(), std::runtime_error);
+    // Reported once, the next frame carries on
+    EXPECT_NO_THROW(pipeline.beginFrame());
+    EXPECT_GE(scene->ticks, 3);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <navigation/pathfinder.h>
+#include <entities/entity.h>
+
+/** 10x10 with a wall down x = 5, open only at y = 9 */
+static NavGrid walledGrid() {
+    NavGrid grid(10, 10, 1.0f);
+    for (int y = 0; y < 9; y++) {
+        grid.setBlocked(5, y, true);
+    }
+    return grid;
+}
+
+TEST(NavigationTest, PathsGoAroundWalls) {
+    NavGrid grid = walledGrid();
+    PathSearch search;
+    std::vector<glm::ivec2> path = search.find(grid, glm::ivec2(0, 0), glm::ivec2(9, 0));
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front(), glm::ivec2(0, 0));
+    EXPECT_EQ(path.back(), glm::ivec2(9, 0));
+    for (const glm::ivec2& cell : path) {
+        EXPECT_TRUE(grid.isWalkable(cell.x, cell.y));
+    }
+    EXPECT_TRUE(std::find(path.begin(), path.end(), glm::ivec2(5, 9)) != path.end());
+
+    // Searches reuse their buffers, the second must not see the first
+    grid.setBlocked(5, 9, true);
+    EXPECT_TRUE(search.find(grid, glm::ivec2(0, 0), glm::ivec2(9, 0)).empty());
+
+    FlowField field(grid, glm::ivec2(9, 0));
+    EXPECT_FALSE(field.reachable(glm::ivec2(0, 0)));
+    EXPECT_TRUE(field.reachable(glm::ivec2(6, 5)));
+    EXPECT_EQ(field.direction(glm::ivec2(9, 1)), glm::fvec2(0.0f, -1.0f));
+    EXPECT_EQ(field.direction(glm::ivec2(9, 0)), glm::fvec2(0.0f, 0.0f));
+}
+
+TEST(NavigationTest, FlowFieldsAreSharedAndInvalidatedByNearbyChanges) {
+    Pathfinder pathfinder(walledGrid(), 2);
+    EXPECT_EQ(pathfinder.flowField(glm::ivec2(9, 0)), nullptr);
+    pathfinder.finish();
+    std::shared_ptr<const FlowField> field = pathfinder.flowField(glm::ivec2(9, 0));
+    ASSERT_NE(field, nullptr);
+    EXPECT_TRUE(field->reachable(glm::ivec2(0, 0)));
+
+    // Agents heading for the same goal follow the same field
+    IEntity first;
+    first.addComponent<TransformComponent>(glm::fvec3(0.5f, 0.5f, 0.0f));
+    FlowFieldAgent* agent = first.addComponentAndGetRawPtr<FlowFieldAgent>(pathfinder, 1.0f);
+    agent->setGoal(glm::fvec2(9.5f, 0.5f));
+    EXPECT_TRUE(agent->update(0.5f));
+    EXPECT_EQ(pathfinder.flowFieldsBuilt(), 1);
+
+    // Closing the gap cuts the left half off. The old field is served until the new one arrives
+    pathfinder.grid().setBlocked(5, 9, true);
+    pathfinder.update();
+    EXPECT_EQ(pathfinder.flowField(glm::ivec2(9, 0)), field);
+    pathfinder.finish();
+    std::shared_ptr<const FlowField> rebuilt = pathfinder.flowField(glm::ivec2(9, 0));
+    EXPECT_NE(rebuilt, field);
+    EXPECT_FALSE(rebuilt->reachable(glm::ivec2(0, 0)));
+    EXPECT_EQ(pathfinder.flowFieldsBuilt(), 2);
+
+    // Cells nowhere near anything reachable can change freely
+    pathfinder.grid().setCost(0, 0, 3);
+    pathfinder.update();
+    EXPECT_EQ(pathfinder.flowField(glm::ivec2(9, 0)), rebuilt);
+    EXPECT_EQ(pathfinder.flowFieldsBuilt(), 2);
+
+    PathRequestId request = pathfinder.requestPath(glm::ivec2(6, 0), glm::ivec2(9, 9));
+    EXPECT_FALSE(pathfinder.takePath(request).has_value());
+    pathfinder.finish();
+    std::optional<PathResult> result = pathfinder.takePath(request);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->cells.size(), 10);
+    EXPECT_EQ(result->gridVersion, pathfinder.grid().version());
+}
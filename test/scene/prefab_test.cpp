@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <scene/prefab.h>
+#include <collisions/collider.h>
+
+TEST(PrefabTest, InstantiatesComponentsInBulk) {
+    Prefab soldier;
+    soldier.with<TransformComponent>(glm::fvec3(1.0f, 2.0f, 0.0f))
+        .with<HealthComponent>(100)
+        .with<SphereCollider>(0.5f);
+
+    PrefabInstances army = soldier.instantiate(500);
+    ASSERT_EQ(army.size(), 500);
+
+    TransformComponent* first = army[0]->getComponent<TransformComponent>();
+    TransformComponent* second = army[1]->getComponent<TransformComponent>();
+    ASSERT_NE(first, nullptr);
+    EXPECT_FLOAT_EQ(first->position.y, 2.0f);
+    EXPECT_NE(first->getComponentId(), second->getComponentId());
+    // Components of a type are contiguous
+    EXPECT_EQ(reinterpret_cast<std::byte*>(second) - reinterpret_cast<std::byte*>(first), sizeof(TransformComponent));
+    EXPECT_EQ(army[499]->getComponent<HealthComponent>()->health, 100);
+
+    // Dependent components resolve their own entity's siblings
+    second->position = glm::fvec3(0.0f, 0.0f, 0.0f);
+    glm::fvec3 origin(0.0f, 0.0f, 0.0f);
+    EXPECT_TRUE(army[1]->getComponent<SphereCollider>()->overlaps(&origin));
+    EXPECT_FALSE(army[0]->getComponent<SphereCollider>()->overlaps(&origin));
+}
+
+TEST(PrefabTest, InstancesBehaveLikeAnyOtherEntity) {
+    Prefab projectile;
+    projectile.with<TransformComponent>().with<HealthComponent>(1);
+    PrefabInstances burst = projectile.instantiate(3);
+
+    SceneContext scene;
+    for (IGameplayEntity* entity : burst.entities()) {
+        scene.registerEntity(entity);
+    }
+
+    // Replacing a pooled component destroys it in place
+    EXPECT_EQ(burst[0]->addComponentGetPrevious<HealthComponent>(5), nullptr);
+    EXPECT_EQ(burst[0]->getComponent<HealthComponent>()->health, 5);
+    EXPECT_TRUE(burst[0]->removeComponent<TransformComponent>());
+
+    burst.destroy(1);
+    EXPECT_EQ(burst[1], nullptr);
+    scene.events().dispatch();
+    EXPECT_EQ(scene.getEntities().size(), 2);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <chrono>
+#include <thread>
+
+#include <scene/sceneManager.h>
+
+class CountingScene : public IScene {
+public:
+    int ticks = 0;
+    int entered = 0;
+    int* tornDown;
+
+    CountingScene(int* tornDown = nullptr) : IScene(nullptr), tornDown(tornDown) {};
+
+    void tick(std::shared_ptr<ApplicationContext> ctx) override { ticks++; }
+    void draw(std::shared_ptr<ApplicationContext> ctx) noexcept override { }
+    void onEnter(std::shared_ptr<ApplicationContext> ctx) noexcept override { entered++; }
+    void onTearDown() noexcept override {
+        if (tornDown != nullptr) (*tornDown)++;
+    }
+};
+
+TEST(SceneManagerTest, AsyncLoadSwapsOnFrameBoundary) {
+    SceneManager scenes;
+    int tornDown = 0;
+    CountingScene* first = new CountingScene(&tornDown);
+    scenes.changeScene(first);
+    EXPECT_EQ(scenes.current(), nullptr);
+    scenes.onDrawCallRisingEdge(nullptr);
+    ASSERT_EQ(scenes.current(), first);
+    EXPECT_EQ(first->entered, 1);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    CountingScene* second = nullptr;
+    scenes.changeSceneAsync(nullptr, [&](std::shared_ptr<ApplicationContext> ctx) {
+        released.wait();
+        auto scene = std::make_unique<CountingScene>();
+        second = scene.get();
+        return std::unique_ptr<IScene>(std::move(scene));
+    });
+
+    // Still loading, the current scene keeps ticking
+    scenes.onDrawCallRisingEdge(nullptr);
+    scenes.onTick(nullptr);
+    EXPECT_EQ(scenes.current(), first);
+    EXPECT_EQ(first->ticks, 1);
+    EXPECT_TRUE(scenes.isLoading());
+
+    release.set_value();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (scenes.isLoading() && std::chrono::steady_clock::now() < deadline) {
+        scenes.onDrawCallRisingEdge(nullptr);
+        std::this_thread::yield();
+    }
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(scenes.current(), second);
+    EXPECT_EQ(second->entered, 1);
+    EXPECT_EQ(tornDown, 1);
+    EXPECT_EQ(scenes.depth(), 1);
+}
+
+TEST(SceneManagerTest, OverlayPausesScenesBelow) {
+    SceneManager scenes;
+    CountingScene* base = new CountingScene();
+    CountingScene* pause = new CountingScene();
+    CountingScene* hud = new CountingScene();
+    scenes.changeScene(base);
+    scenes.pushOverlay(hud, false);
+    scenes.onDrawCallRisingEdge(nullptr);
+    scenes.onTick(nullptr);
+    EXPECT_EQ(base->ticks, 1);
+    EXPECT_EQ(hud->ticks, 1);
+
+    scenes.pushOverlay(pause);
+    scenes.onDrawCallRisingEdge(nullptr);
+    scenes.onTick(nullptr);
+    EXPECT_EQ(base->ticks, 1);
+    EXPECT_EQ(hud->ticks, 1);
+    EXPECT_EQ(pause->ticks, 1);
+
+    scenes.popOverlay();
+    scenes.onDrawCallRisingEdge(nullptr);
+    scenes.onTick(nullptr);
+    EXPECT_EQ(scenes.current(), hud);
+    EXPECT_EQ(base->ticks, 2);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include <scene/serialization.h>
+#include <collisions/collider.h>
+
+TEST(SceneSerializationTest, RoundTripThroughMappedFile) {
+    IGameplayEntity first;
+    first.addComponent<TransformComponent>(glm::fvec3(1.0f, 2.0f, 3.0f), glm::fvec2(2.0f, 2.0f), 0.5f);
+    first.addComponent<HealthComponent>(42);
+    first.addComponent<ContinuousForceComponent>(glm::fvec3(0.0f, 1.0f, 0.0f), 9.8f);
+    IGameplayEntity second;
+    second.addComponent<TransformComponent>(glm::fvec3(4.0f, 5.0f, 6.0f));
+    second.addComponent<PolygonCollider>(std::vector<glm::fvec3>{glm::fvec3(1.0f), glm::fvec3(2.0f), glm::fvec3(3.0f)});
+
+    SceneSerializer serializer = SceneSerializer::withBuiltinComponents();
+    std::string path = (std::filesystem::temp_directory_path() / "sdlgame_scene_test.bin").string();
+    serializer.save(path.c_str(), {&first, &second});
+    SceneEntities loaded = serializer.load(path.c_str());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(loaded.size(), 2);
+    const TransformComponent* transform = loaded[0]->getComponent<TransformComponent>();
+    ASSERT_NE(transform, nullptr);
+    EXPECT_FLOAT_EQ(transform->position.z, 3.0f);
+    EXPECT_FLOAT_EQ(transform->scale.x, 2.0f);
+    EXPECT_FLOAT_EQ(transform->rotation, 0.5f);
+    ASSERT_NE(loaded[0]->getComponent<HealthComponent>(), nullptr);
+    EXPECT_EQ(loaded[0]->getComponent<HealthComponent>()->health, 42);
+    ASSERT_NE(loaded[0]->getComponent<ContinuousForceComponent>(), nullptr);
+    EXPECT_FLOAT_EQ(loaded[0]->getComponent<ContinuousForceComponent>()->force, 9.8f);
+
+    EXPECT_EQ(loaded[1]->getComponent<HealthComponent>(), nullptr);
+    EXPECT_FLOAT_EQ(loaded[1]->getComponent<TransformComponent>()->position.y, 5.0f);
+    ASSERT_NE(loaded[1]->getComponent<PolygonCollider>(), nullptr);
+    EXPECT_EQ(loaded[1]->getComponent<PolygonCollider>()->points().size(), 3);
+}
+
+TEST(SceneSerializationTest, RejectsChangedRecordSize) {
+    IGameplayEntity entity;
+    entity.addComponent<HealthComponent>(1);
+    SceneSerializer writer;
+    writer.registerTrivial<HealthComponent>("HealthComponent", &HealthComponent::health);
+    std::vector<std::byte> data = writer.serialize({&entity});
+
+    SceneSerializer reader;
+    reader.registerTrivial<HealthComponent>("HealthComponent", &HealthComponent::health, &HealthComponent::health);
+    EXPECT_THROW(reader.deserialize(data.data(), data.size()), std::runtime_error);
+    // Unknown components are skipped rather than failing the whole scene
+    EXPECT_EQ(SceneSerializer().deserialize(data.data(), data.size()).size(), 1);
+}
+
+TEST(SceneSerializationTest, RejectsPolygonCountLargerThanItsRecord) {
+    IGameplayEntity entity;
+    entity.addComponent<TransformComponent>(glm::fvec3(0.0f));
+    entity.addComponent<PolygonCollider>(std::vector<glm::fvec3>{glm::fvec3(7.0f), glm::fvec3(8.0f), glm::fvec3(9.0f)});
+    SceneSerializer serializer = SceneSerializer::withBuiltinComponents();
+    std::vector<std::byte> data = serializer.serialize({&entity});
+
+    // The point count sits right before the first point
+    const float first[3] = {7.0f, 7.0f, 7.0f};
+    auto at = std::search(data.begin(), data.end(), reinterpret_cast<const std::byte*>(first), reinterpret_cast<const std::byte*>(first) + sizeof(first));
+    ASSERT_NE(at, data.end());
+    uint32_t count = 0x40000000;
+    std::memcpy(&*(at - sizeof(uint32_t)), &count, sizeof(count));
+    EXPECT_THROW(serializer.deserialize(data.data(), data.size()), std::runtime_error);
+}
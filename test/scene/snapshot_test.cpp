@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <scene/snapshot.h>
+
+/** Stand in for a tick, so this runs without an ApplicationContext */
+static void simulate(std::vector<IGameplayEntity*>& entities, int frame) {
+    for (size_t i = 0; i < entities.size(); i += 3) {
+        TransformComponent* transform = entities[i]->getComponent<TransformComponent>();
+        transform->position += glm::fvec3(1.0f, 0.5f, 0.0f);
+        transform->rotation += 0.1f * frame;
+        entities[i]->getComponent<HealthComponent>()->health -= frame;
+    }
+}
+
+TEST(WorldSnapshotTest, RestoresStateAfterSimulating) {
+    std::vector<std::unique_ptr<IGameplayEntity>> owned;
+    std::vector<IGameplayEntity*> entities;
+    for (int i = 0; i < 10000; i++) {
+        owned.push_back(std::make_unique<IGameplayEntity>());
+        owned.back()->addComponent<TransformComponent>(glm::fvec3(i, -i, 0.0f));
+        owned.back()->addComponent<HealthComponent>(100);
+        entities.push_back(owned.back().get());
+    }
+
+    SceneSerializer serializer = SceneSerializer::withBuiltinComponents();
+    WorldSnapshot snapshot(serializer);
+    snapshot.reserve(entities.size());
+    snapshot.capture(entities);
+    EXPECT_EQ(snapshot.size(), entities.size() * (sizeof(glm::fvec3) + sizeof(glm::fvec2) + sizeof(float) + sizeof(int)));
+
+    for (int frame = 1; frame <= 10; frame++) {
+        simulate(entities, frame);
+    }
+    snapshot.restore(entities);
+
+    EXPECT_GT(snapshot.restoredChunks(), 0);
+    for (int i = 0; i < 10000; i++) {
+        const TransformComponent* transform = entities[i]->getComponent<TransformComponent>();
+        ASSERT_FLOAT_EQ(transform->position.x, float(i));
+        ASSERT_FLOAT_EQ(transform->position.y, float(-i));
+        ASSERT_FLOAT_EQ(transform->rotation, 0.0f);
+        ASSERT_EQ(entities[i]->getComponent<HealthComponent>()->health, 100);
+    }
+
+    // Nothing changed since, so nothing is written back
+    snapshot.restore(entities);
+    EXPECT_EQ(snapshot.restoredChunks(), 0);
+}
+
+TEST(WorldSnapshotTest, RefusesToRestoreAfterStructuralChange) {
+    IGameplayEntity entity;
+    entity.addComponent<TransformComponent>();
+    std::vector<IGameplayEntity*> entities{&entity};
+
+    SceneSerializer serializer = SceneSerializer::withBuiltinComponents();
+    WorldSnapshot snapshot(serializer);
+    snapshot.capture(entities);
+
+    entity.addComponent<TransformComponent>();
+    EXPECT_THROW(snapshot.restore(entities), std::runtime_error);
+}
+
+TEST(WorldSnapshotTest, SurvivesRegisteringAfterCapture) {
+    IGameplayEntity entity;
+    entity.addComponent<HealthComponent>(10);
+    std::vector<IGameplayEntity*> entities{&entity};
+
+    SceneSerializer serializer;
+    serializer.registerTrivial<HealthComponent>("HealthComponent", &HealthComponent::health);
+    WorldSnapshot snapshot(serializer);
+    snapshot.capture(entities);
+
+    // Grows the codecs past their capacity, moving them
+    serializer.registerTrivial<TransformComponent>("TransformComponent",
+        &TransformComponent::position, &TransformComponent::scale, &TransformComponent::rotation);
+    entity.getComponent<HealthComponent>()->health = 3;
+    snapshot.restore(entities);
+    EXPECT_EQ(entity.getComponent<HealthComponent>()->health, 10);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+
+#include <scene/tickScheduler.h>
+
+class Mover : public IGameplayEntity {
+public:
+    Mover(glm::fvec3 position) {
+        addComponent<TransformComponent>(position);
+    }
+};
+
+TEST(TickSchedulerTest, FarOffScreenEntitiesTickLessOftenWithScaledDeltaT) {
+    TickLodConfig config;
+    config.distances = {100.0f};
+    config.budgetMs = 0.0;
+    TickScheduler scheduler(config);
+    scheduler.setView(SDL_FRect{0.0f, 0.0f, 100.0f, 100.0f});
+    scheduler.setFocus(glm::fvec2(50.0f, 50.0f));
+
+    Mover visible(glm::fvec3(10.0f, 10.0f, 0.0f));
+    Mover near(glm::fvec3(120.0f, 50.0f, 0.0f));
+    Mover far(glm::fvec3(500.0f, 50.0f, 0.0f));
+    Mover player(glm::fvec3(5000.0f, 5000.0f, 0.0f));
+    scheduler.add(&visible);
+    scheduler.add(&near);
+    scheduler.add(&far);
+    scheduler.add(&player, TickPriority::Critical);
+
+    std::unordered_map<IGameplayEntity*, int> ticks;
+    std::unordered_map<IGameplayEntity*, float> covered;
+    for (int frame = 0; frame < 64; frame++) {
+        scheduler.tick(0.5f, [&](IGameplayEntity& entity, float scale) {
+            ticks[&entity]++;
+            covered[&entity] += 0.5f * scale;
+        });
+    }
+
+    EXPECT_EQ(scheduler.interval(&visible), 1);
+    EXPECT_EQ(scheduler.interval(&near), 2);
+    EXPECT_EQ(scheduler.interval(&far), 4);
+    EXPECT_EQ(scheduler.interval(&player), 1);
+    EXPECT_EQ(ticks[&visible], 64);
+    EXPECT_EQ(ticks[&player], 64);
+    EXPECT_NEAR(ticks[&near], 32, 1);
+    EXPECT_NEAR(ticks[&far], 16, 1);
+    // However rarely, time covered stays roughly the same
+    EXPECT_NEAR(covered[&far], 32.0f, 2.0f);
+
+    EXPECT_TRUE(scheduler.remove(&far));
+    EXPECT_FALSE(scheduler.remove(&far));
+    EXPECT_EQ(scheduler.interval(&far), 0);
+}
+
+TEST(TickSchedulerTest, DefersWorkOverBudgetButNeverCritical) {
+    TickLodConfig config;
+    config.budgetMs = 1.0;
+    TickScheduler scheduler(config);
+    scheduler.setView(SDL_FRect{0.0f, 0.0f, 1000.0f, 1000.0f});
+
+    std::vector<std::unique_ptr<Mover>> movers;
+    for (int i = 0; i < 40; i++) {
+        movers.push_back(std::make_unique<Mover>(glm::fvec3(1.0f, 1.0f, 0.0f)));
+        scheduler.add(movers.back().get(), i == 39 ? TickPriority::Critical : TickPriority::Normal);
+    }
+
+    auto slow = [](IGameplayEntity&, float) { std::this_thread::sleep_for(std::chrono::microseconds(200)); };
+    scheduler.tick(1.0f, slow);
+    EXPECT_GT(scheduler.deferredLastFrame(), 0);
+    EXPECT_EQ(scheduler.tickedLastFrame() + scheduler.deferredLastFrame(), 40);
+
+    // Deferred ones go first next frame, and get the time they missed
+    float largest = 0.0f;
+    scheduler.tick(1.0f, [&](IGameplayEntity& entity, float scale) { largest = std::max(largest, scale); });
+    EXPECT_EQ(scheduler.deferredLastFrame(), 0);
+    EXPECT_FLOAT_EQ(largest, 2.0f);
+}
+
+TEST(TickSchedulerTest, SpreadsEntitiesEvenlyOverTheirInterval) {
+    TickLodConfig config;
+    config.distances = {100.0f};
+    config.budgetMs = 0.0;
+    TickScheduler scheduler(config);
+    scheduler.setView(SDL_FRect{0.0f, 0.0f, 100.0f, 100.0f});
+    scheduler.setFocus(glm::fvec2(50.0f, 50.0f));
+
+    // Every 2nd frame for the near ones, every 4th for the far ones
+    std::vector<std::unique_ptr<Mover>> movers;
+    for (int i = 0; i < 160; i++) {
+        movers.push_back(std::make_unique<Mover>(glm::fvec3(i < 80 ? 120.0f : 500.0f, 50.0f, 0.0f)));
+        scheduler.add(movers.back().get());
+    }
+
+    for (int frame = 0; frame < 16; frame++) {
+        size_t near = 0;
+        size_t far = 0;
+        scheduler.tick(1.0f, [&](IGameplayEntity& entity, float) {
+            (static_cast<Mover&>(entity).getComponent<TransformComponent>()->position.x < 200.0f ? near : far)++;
+        });
+        EXPECT_EQ(near, 40) << "frame " << frame;
+        EXPECT_EQ(far, 20) << "frame " << frame;
+    }
+}
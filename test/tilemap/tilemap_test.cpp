@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <entities/entity.h>
+#include <tilemap/tilemap.h>
+#include <entities/hierarchy.h>
+#include <meta/pipeline.h>
+
+static std::vector<TileKind> palette() {
+    return {
+        TileKind{{0, 0, 0, 0}, false},
+        TileKind{{128, 128, 128, 255}, true},
+        TileKind{{0, 128, 0, 255}, false},
+    };
+}
+
+TEST(TilemapTest, SolidTilesCollideThroughOneCollider) {
+    IEntity level;
+    level.addComponent<TransformComponent>(glm::fvec3(100.0f, 0.0f, 0.0f));
+    Tilemap* map = level.addComponentAndGetRawPtr<Tilemap>(100, 50, 16, palette());
+    TilemapCollider* collider = level.addComponentAndGetRawPtr<TilemapCollider>();
+
+    map->setTile(2, 1, 1);
+    map->setTile(3, 1, 2);
+    EXPECT_TRUE(map->isSolid(2, 1));
+    EXPECT_FALSE(map->isSolid(3, 1));
+    EXPECT_FALSE(map->isSolid(-1, 1));
+    EXPECT_THROW(map->setTile(100, 0, 1), std::runtime_error);
+    EXPECT_THROW(map->setTile(0, 0, 3), std::runtime_error);
+
+    glm::fvec3 inside(100.0f + 2 * 16 + 8, 16 + 8, 0.0f);
+    glm::fvec3 beside(100.0f + 3 * 16 + 8, 16 + 8, 0.0f);
+    EXPECT_TRUE(collider->overlaps(&inside));
+    EXPECT_FALSE(collider->overlaps(&beside));
+
+    int solid = 0;
+    map->forEachSolidTile(SDL_FRect{100.0f, 0.0f, 64.0f, 64.0f}, [&](int x, int y) { solid++; });
+    EXPECT_EQ(solid, 1);
+
+    // Only tiles that actually change bump the version
+    uint32_t version = map->chunkVersion(2, 1);
+    map->setTile(2, 1, 1);
+    EXPECT_EQ(map->chunkVersion(2, 1), version);
+    map->setTile(2, 1, 0);
+    EXPECT_NE(map->chunkVersion(2, 1), version);
+}
+
+TEST(TilemapTest, CapturesOnlyVisibleNonEmptyChunks) {
+    IEntity level;
+    level.addComponent<TransformComponent>();
+    Tilemap* map = level.addComponentAndGetRawPtr<Tilemap>(1000, 1000, 16, palette());
+    for (int y = 0; y < 1000; y += 7) {
+        for (int x = 0; x < 1000; x += 7) {
+            map->setTile(x, y, 1);
+        }
+    }
+
+    // 512 pixels per chunk, so a 1920x1080 view sees 4x3 of the 32x32 chunks
+    map->setView(SDL_FRect{0.0f, 0.0f, 1920.0f, 1080.0f});
+    RenderSnapshot snapshot;
+    map->capture(snapshot);
+    ASSERT_EQ(snapshot.chunks.size(), 12);
+    // Nothing is rasterised yet, so all tiles are sent along
+    EXPECT_EQ(snapshot.chunkTiles.size(), 12 * Tilemap::s_chunkTiles * Tilemap::s_chunkTiles);
+    EXPECT_EQ(snapshot.chunks[1].destination.x, 512.0f);
+
+    // Scrolled to the far corner, where the map ends partway through the view
+    map->setView(SDL_FRect{15500.0f, 15500.0f, 1920.0f, 1080.0f});
+    snapshot.clear();
+    map->capture(snapshot);
+    EXPECT_EQ(snapshot.chunks.size(), 4);
+    EXPECT_EQ(snapshot.chunks[0].destination.x, 30 * 512.0f - 15500.0f);
+}
+
+TEST(TilemapTest, ParentedMapCollidesWhereItIsDrawn) {
+    TransformComponent room(glm::fvec3(200.0f, 100.0f, 0.0f));
+    IEntity level;
+    TransformComponent* local = level.addComponentAndGetRawPtr<TransformComponent>(glm::fvec3(10.0f, 0.0f, 0.0f));
+    Tilemap* map = level.addComponentAndGetRawPtr<Tilemap>(4, 4, 16, palette());
+    map->setTile(0, 0, 1);
+
+    TransformHierarchy hierarchy;
+    TransformNode roomNode = hierarchy.add(&room);
+    hierarchy.add(local, roomNode);
+    hierarchy.update();
+
+    EXPECT_TRUE(map->isSolidAt(glm::fvec2(215.0f, 105.0f)));
+    EXPECT_FALSE(map->isSolidAt(glm::fvec2(15.0f, 5.0f)));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <ui/ui.h>
+#include <meta/ApplicationContext.h>
+
+static const SDL_FRect screen{0.0f, 0.0f, 800.0f, 600.0f};
+
+class CountingElement : public UIElement {
+public:
+    int layoutCount = 0;
+    CountingElement(UIBox box) : UIElement(box) {};
+protected:
+    void onLayout() noexcept override {
+        layoutCount++;
+    }
+};
+
+class CountingPanel : public UIPanel {
+public:
+    int drawCount = 0;
+    CountingPanel(UIBox box) : UIPanel(box, SDL_Color{255, 0, 0, 255}) {};
+protected:
+    void drawSelf(SDL_Renderer& renderer, const SDL_FRect& rect) noexcept override {
+        drawCount++;
+        UIPanel::drawSelf(renderer, rect);
+    }
+};
+
+TEST(UITest, AnchoredLayout) {
+    UIElement root(UIBox{.relativeSize = glm::fvec2(1.0f, 1.0f)});
+    UIElement* centered = root.addChild<UIElement>(UIBox{
+        .size = glm::fvec2(100.0f, 50.0f),
+        .anchor = glm::fvec2(0.5f, 0.5f)
+    });
+
+    root.layout(screen);
+
+    EXPECT_FLOAT_EQ(root.rect().w, 800.0f);
+    EXPECT_FLOAT_EQ(centered->rect().x, 350.0f);
+    EXPECT_FLOAT_EQ(centered->rect().y, 275.0f);
+}
+
+TEST(UITest, StackedLayoutFollowsInvalidatedSibling) {
+    UIElement root(UIBox{.relativeSize = glm::fvec2(1.0f, 1.0f), .padding = 10.0f, .spacing = 5.0f});
+    root.setLayout(UILayout::Vertical);
+    CountingElement* first = root.addChild<CountingElement>(UIBox{.size = glm::fvec2(100.0f, 20.0f)});
+    CountingElement* second = root.addChild<CountingElement>(UIBox{.size = glm::fvec2(100.0f, 20.0f)});
+
+    root.layout(screen);
+    EXPECT_FLOAT_EQ(first->rect().y, 10.0f);
+    EXPECT_FLOAT_EQ(second->rect().y, 35.0f);
+
+    // Nothing invalidated, nothing recomputed
+    root.layout(screen);
+    EXPECT_EQ(first->layoutCount, 1);
+    EXPECT_EQ(second->layoutCount, 1);
+
+    first->setBox(UIBox{.size = glm::fvec2(100.0f, 40.0f)});
+    root.layout(screen);
+    EXPECT_FLOAT_EQ(second->rect().y, 55.0f);
+    EXPECT_EQ(second->layoutCount, 2);
+
+    // Hidden elements take up no space
+    first->setVisible(false);
+    root.layout(screen);
+    EXPECT_FLOAT_EQ(second->rect().y, 10.0f);
+}
+
+TEST(UITest, RemovedChildReleasesOwnership) {
+    UIElement root;
+    UIElement* child = root.addChild<UIElement>();
+    ASSERT_EQ(child->parent(), &root);
+
+    std::unique_ptr<UIElement> released = root.removeChild(child);
+    ASSERT_EQ(released.get(), child);
+    EXPECT_EQ(released->parent(), nullptr);
+    EXPECT_TRUE(root.children().empty());
+    EXPECT_EQ(root.removeChild(child), nullptr);
+}
+
+TEST(UITest, CachedTextureIsOnlyRedrawnWhenInvalidated) {
+    // A software renderer needs no window, or video subsystem for that matter
+    SDL_Surface* surface = SDL_CreateSurface(800, 600, SDL_PIXELFORMAT_RGBA8888);
+    ASSERT_NE(surface, nullptr);
+    {
+        glm::fvec2 bounds(800.0f, 600.0f);
+        std::shared_ptr<ApplicationContext> ctx = ApplicationContext::create(&bounds, 0, nullptr, SDL_CreateSoftwareRenderer(surface));
+        UIElement root(UIBox{.relativeSize = glm::fvec2(1.0f, 1.0f)});
+        UIElement* hud = root.addChild<UIElement>(UIBox{.size = glm::fvec2(200.0f, 100.0f)});
+        hud->setCachedToTexture(true);
+        CountingPanel* first = hud->addChild<CountingPanel>(UIBox{.size = glm::fvec2(50.0f, 50.0f)});
+        CountingPanel* second = hud->addChild<CountingPanel>(UIBox{.offset = glm::fvec2(60.0f, 0.0f), .size = glm::fvec2(50.0f, 50.0f)});
+
+        root.draw(ctx);
+        EXPECT_EQ(first->drawCount, 1);
+        root.draw(ctx);
+        EXPECT_EQ(first->drawCount, 1);
+        EXPECT_EQ(second->drawCount, 1);
+
+        // Anything within the cached element changing redraws all of it, once
+        first->setColour(SDL_Color{0, 255, 0, 255});
+        root.draw(ctx);
+        root.draw(ctx);
+        EXPECT_EQ(first->drawCount, 2);
+        EXPECT_EQ(second->drawCount, 2);
+
+        // Uncached elements draw every time
+        hud->setCachedToTexture(false);
+        root.draw(ctx);
+        root.draw(ctx);
+        EXPECT_EQ(first->drawCount, 4);
+    }
+    SDL_DestroySurface(surface);
+}